@@ -1,4 +1,3 @@
-#include "democity.h"
 
 const uint8_t democity[]={
 /*0x43,0x54,0x59,0x33,*/0x35,0x00,0x01,0x02,0x00,0x00,0x00,0x00,
@@ -0,0 +1,253 @@
+// Batch simulator - runs many cities for a number of years across all cores and prints how each one turned out
+// Cities come from disk saves (the 1024 byte file the cart writes) and/or are generated from seeds
+//
+// batchsim [--years N] [--threads N] [--seeds COUNT] [--first-seed N] [--fast] [--snapshot-check] [save files...]
+//   --snapshot-check checks each city comes back from a snapshot as it was instead, see CheckSnapshot()
+
+#include "Headless.h"
+#include "JobPool.h"
+#include "Arena.h"
+#include "Snapshot.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef struct
+{
+	std::string name;
+	std::vector<uint8_t> save;			// empty for a generated city
+	uint32_t seed;
+	CitySummary summary;
+	bool loaded;
+	const char* snapshotError;			// what --snapshot-check found wrong, nullptr if nothing
+} BatchCity;
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: batchsim [--years N] [--threads N] [--seeds COUNT] [--first-seed N] [--fast] [--snapshot-check] [save files...]\n");
+}
+
+static bool LoadBatchCity(CityContext& city, const BatchCity& batch)
+{
+	if (batch.save.empty())
+	{
+		GenerateCity(city, batch.seed);
+		return true;
+	}
+	return LoadSavedCity(city, batch.save.data());
+}
+
+// Places the biggest building there's room for, false if nothing fits
+static bool PlaceAnyBuilding(CityContext& city)
+{
+	for (int type = Stadium; type >= Residential; type--)
+	{
+		for (int y = 0; y < MAP_HEIGHT; y++)
+		{
+			for (int x = 0; x < MAP_WIDTH; x++)
+			{
+				if (CanPlaceBuilding(city, type, x, y) && PlaceBuilding(city, type, x, y))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+// Takes a snapshot of city, places a building and simulates the years, then restores the snapshot. The game state and
+// power grid have to come back byte for byte, and the city then has to simulate the years exactly like untouched, a
+// copy of it that never had a snapshot. Returns what went wrong, nullptr if nothing
+static const char* CheckSnapshot(CityContext& city, CityContext& untouched, const uint32_t years)
+{
+	// only the map bits of the power grid, the rest is the flood fill's stack
+	const size_t powerGridSize = sizeof(CitySnapshot::powerGrid);
+	std::vector<uint8_t> state(sizeof(GameState));
+	std::vector<uint8_t> powerGrid(powerGridSize);
+	memcpy(state.data(), &city.state, sizeof(GameState));
+	memcpy(powerGrid.data(), city.powerGrid, powerGridSize);
+	const uint16_t randVal = city.randVal;
+
+	CitySnapshot snapshot;
+	if (!TakeSnapshot(city, snapshot))
+	{
+		return "the snapshot couldn't be taken";
+	}
+	const bool placed = PlaceAnyBuilding(city);
+	CitySummary summary;
+	SimulateYears(city, years, summary);
+	const bool restored = RestoreSnapshot(snapshot);
+	ReleaseSnapshot(snapshot);
+
+	if (!placed)
+	{
+		return "there was nowhere to place a building";
+	}
+	if (!restored)
+	{
+		return "the snapshot couldn't be restored";
+	}
+	if (memcmp(state.data(), &city.state, sizeof(GameState)) != 0)
+	{
+		return "the game state differs after restoring";
+	}
+	if (memcmp(powerGrid.data(), city.powerGrid, powerGridSize) != 0 || city.randVal != randVal)
+	{
+		return "the power grid or random state differs after restoring";
+	}
+
+	CitySummary untouchedSummary;
+	SimulateYears(city, years, summary);
+	SimulateYears(untouched, years, untouchedSummary);
+	if (memcmp(&city.state, &untouched.state, sizeof(GameState)) != 0 || memcmp(city.powerGrid, untouched.powerGrid, powerGridSize) != 0)
+	{
+		return "the restored city simulates differently from an untouched copy";
+	}
+	return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t years = 20;
+	uint32_t threads = GetDefaultThreadCount();
+	uint32_t seedCount = 0;
+	uint32_t firstSeed = 1;
+	bool fast = false;
+	bool snapshotCheck = false;
+	std::vector<BatchCity> cities;
+
+	for (int n = 1; n < argc; n++)
+	{
+		const char* arg = argv[n];
+		const bool hasValue = n + 1 < argc;
+		if (strcmp(arg, "--years") == 0 && hasValue)
+		{
+			years = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--threads") == 0 && hasValue)
+		{
+			threads = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--seeds") == 0 && hasValue)
+		{
+			seedCount = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--first-seed") == 0 && hasValue)
+		{
+			firstSeed = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--fast") == 0)
+		{
+			fast = true;
+		}
+		else if (strcmp(arg, "--snapshot-check") == 0)
+		{
+			snapshotCheck = true;
+		}
+		else if (arg[0] == '-')
+		{
+			PrintUsage();
+			return 1;
+		}
+		else
+		{
+			BatchCity city = {};
+			city.name = arg;
+			city.save.resize(1024);
+			if (!ReadSaveFile(arg, city.save.data()))
+			{
+				fprintf(stderr, "could not read %s\n", arg);
+				return 1;
+			}
+			cities.push_back(city);
+		}
+	}
+
+	for (uint32_t n = 0; n < seedCount; n++)
+	{
+		BatchCity city = {};
+		city.seed = firstSeed + n;
+		city.name = "seed" + std::to_string(city.seed);
+		cities.push_back(city);
+	}
+
+	if (cities.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	InitHeadless();
+
+	const auto start = std::chrono::steady_clock::now();
+	RunJobs(cities.size(), threads, [&](const uint32_t job, const uint32_t worker)
+	{
+		BatchCity& batch = cities[job];
+		// about 1.2KB plus the building owner map, there's no need to keep it once the summary is taken
+		CityContext city;
+
+		ResetScratchArena();
+		batch.loaded = LoadBatchCity(city, batch);
+		if (batch.loaded && snapshotCheck)
+		{
+			CityContext untouched;
+			LoadBatchCity(untouched, batch);
+			batch.snapshotError = CheckSnapshot(city, untouched, years);
+			FreeCityContext(untouched);
+		}
+		else if (batch.loaded)
+		{
+			if (fast)
+			{
+				city.state.flags |= FLAG_FAST;
+			}
+			SimulateYears(city, years, batch.summary);
+		}
+		FreeCityContext(city);
+	});
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint32_t failures = 0;
+	if (snapshotCheck)
+	{
+		printf("city,snapshot_check\n");
+	}
+	else
+	{
+		PrintSummaryHeader();
+	}
+	for (const BatchCity& city : cities)
+	{
+		if (!city.loaded)
+		{
+			fprintf(stderr, "%s is not a saved city\n", city.name.c_str());
+			failures++;
+		}
+		else if (snapshotCheck)
+		{
+			printf("%s,%s\n", city.name.c_str(), city.snapshotError != nullptr ? city.snapshotError : "ok");
+			failures += city.snapshotError != nullptr ? 1 : 0;
+		}
+		else
+		{
+			PrintSummary(city.name.c_str(), city.summary);
+		}
+	}
+
+	if (threads > cities.size())
+	{
+		threads = cities.size();
+	}
+	fprintf(stderr, "%u cities x %u years in %.3fs on %u threads: %.1f cities/s\n", (uint32_t)cities.size(), years, seconds, threads, cities.size() / seconds);
+	if (snapshotCheck && failures > 0)
+	{
+		fprintf(stderr, "batchsim: %u of %u cities failed the snapshot check\n", failures, (uint32_t)cities.size());
+		return 1;
+	}
+	return 0;
+}
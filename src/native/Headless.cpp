@@ -0,0 +1,342 @@
+#include "Headless.h"
+#include "Simulation.h"
+#include "CitySave.h"
+#include "Arena.h"
+#include "randommt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void InitHeadless()
+{
+	// the game's and draw listeners only follow MainCity, the tools never use it
+	RegisterBuildingListeners();
+	RegisterConnectivityListeners();
+}
+
+// Years of upkeep the generator keeps back, so the city can pay its way until the zones grow and the taxes cover it
+#define GENERATE_RESERVE_YEARS 2
+
+static bool IsDepartment(const uint8_t type)
+{
+	return type == PoliceDept || type == FireDept;
+}
+
+// What the city would pay at the end of a year with extra road tiles and departments
+static int32_t GetYearlyUpkeep(const CityContext& city, const int extraRoads, const int extraDepartments)
+{
+	int roads = extraRoads;
+	for (int y = 0; y < MAP_HEIGHT; y++)
+	{
+		for (int x = 0; x < MAP_WIDTH; x++)
+		{
+			roads += (GetConnections(city, x, y) & RoadMask) ? 1 : 0;
+		}
+	}
+	int departments = extraDepartments;
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		departments += IsDepartment(city.state.buildings[n].type) ? 1 : 0;
+	}
+	return roads * SIM_PARAM(city, roadMaintenanceCost) / 100 + departments * SIM_PARAM(city, fireAndPoliceMaintenanceCost);
+}
+
+// Whether cost can be spent and still leave the reserve for the upkeep that comes with it
+static bool CanSpend(const CityContext& city, const int32_t cost, const int extraRoads, const int extraDepartments)
+{
+	return city.state.money - cost >= GENERATE_RESERVE_YEARS * GetYearlyUpkeep(city, extraRoads, extraDepartments);
+}
+
+static bool BuyBuilding(CityContext& city, const uint8_t type, const int x, const int y)
+{
+	const uint16_t cost = GetBuildingInfo(type)->cost;
+	if (x < 0 || y < 0 || !CanSpend(city, cost, 0, IsDepartment(type) ? 1 : 0) || !CanPlaceBuilding(city, type, x, y))
+	{
+		return false;
+	}
+	if (!PlaceBuilding(city, type, x, y))
+	{
+		return false;
+	}
+	city.state.money -= cost;
+	return true;
+}
+
+// Whether the tile can take a road or power line, true if it's already there
+static bool CanBuyConnection(CityContext& city, const int x, const int y, const uint8_t mask)
+{
+	if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT)
+	{
+		return false;
+	}
+	if (GetConnections(city, x, y) & mask)
+	{
+		return true;
+	}
+	return GetBuilding(city, x, y) == nullptr && IsTerrainClear(city.state.terrainType, x, y);
+}
+
+// Adds a road or power line to the tile, true if it's already there
+static bool BuyConnection(CityContext& city, const int x, const int y, const uint8_t mask)
+{
+	if (!CanBuyConnection(city, x, y, mask))
+	{
+		return false;
+	}
+	const uint8_t connections = GetConnections(city, x, y);
+	if (connections & mask)
+	{
+		return true;
+	}
+
+	const bool road = mask == RoadMask;
+	const int cost = road ? ROAD_COST : POWERLINE_COST;
+	if (!CanSpend(city, cost, road ? 1 : 0, 0))
+	{
+		return false;
+	}
+	SetConnections(city, x, y, connections | mask);
+	city.state.money -= cost;
+	return true;
+}
+
+// Mostly zones, with a police and a fire department among every three dozen buildings - each costs about as much upkeep
+// as a dozen grown zones bring in taxes. Industry goes next to the plant and housing away from both their pollution
+static uint8_t PickBuildingType(RandomMT& rand, const uint32_t placed, const int plantDistance)
+{
+	if (placed % 36 == 6)
+		return PoliceDept;
+	if (placed % 36 == 18)
+		return FireDept;
+
+	const uint32_t pick = rand.Next() % 100;
+	if (plantDistance < 10)
+		return pick < 80 ? Industrial : Commercial;
+	if (plantDistance < 20)
+		return pick < 70 ? Commercial : Industrial;
+	return pick < 92 ? Residential : Park;
+}
+
+// A band is a road row with a row of 3x3 buildings under it, the buildings touch so power runs along the band from the spine
+static void BuildBand(CityContext& city, RandomMT& rand, const int spineX, const int roadY, const int plantX, const int plantY, uint32_t& placed)
+{
+	// buildings to the right of the spine, then to the left, stopping at the first one that doesn't fit
+	for (int side = 0; side < 2; side++)
+	{
+		for (int x = side == 0 ? spineX + 1 : spineX - 3; x >= 0 && x + 3 <= MAP_WIDTH; x += side == 0 ? 3 : -3)
+		{
+			const int plantDistance = abs(x - plantX) + abs(roadY + 1 - plantY);
+			const uint8_t type = PickBuildingType(rand, placed, plantDistance);
+			if (!CanPlaceBuilding(city, type, x, roadY + 1))
+			{
+				break;
+			}
+			if (!CanSpend(city, GetBuildingInfo(type)->cost + 3 * ROAD_COST, 3, IsDepartment(type) ? 1 : 0))
+			{
+				return;
+			}
+			for (int i = 0; i < 3; i++)
+			{
+				BuyConnection(city, x + i, roadY, RoadMask);
+			}
+			if (BuyBuilding(city, type, x, roadY + 1))
+			{
+				placed++;
+			}
+		}
+	}
+}
+
+// Power line down column spineX from the plant's rows out to the far side of the band at roadY, with the band's road
+// crossing it. Nothing is bought unless all of it can be
+static bool BuildSpine(CityContext& city, const int spineX, const int plantY, const int roadY)
+{
+	const int fromY = roadY > plantY ? plantY : roadY;
+	const int toY = roadY > plantY ? roadY + 3 : plantY + 3;
+	int lines = 0;
+	for (int y = fromY; y <= toY; y++)
+	{
+		if (!CanBuyConnection(city, spineX, y, PowerlineMask))
+		{
+			return false;
+		}
+		lines += (GetConnections(city, spineX, y) & PowerlineMask) ? 0 : 1;
+	}
+	const bool hasRoad = (GetConnections(city, spineX, roadY) & RoadMask) != 0;
+	if (!CanBuyConnection(city, spineX, roadY, RoadMask) || !CanSpend(city, lines * POWERLINE_COST + (hasRoad ? 0 : ROAD_COST), hasRoad ? 0 : 1, 0))
+	{
+		return false;
+	}
+	for (int y = fromY; y <= toY; y++)
+	{
+		BuyConnection(city, spineX, y, PowerlineMask);
+	}
+	BuyConnection(city, spineX, roadY, RoadMask);
+	return true;
+}
+
+void GenerateCity(CityContext& city, const uint32_t seed, const SimParams& params)
+{
+	GameState& state = city.state;
+	RandomMT rand(seed);
+
+	InitCityContext(city);
+	city.simParams = &params;
+	state.timeToNextDisaster = params.maxTimeBetweenDisasters;
+	state.seed = seed;
+	state.terrainType = rand.Next() % NUM_TERRAIN_TYPES;
+	GenerateRandomTerrain(state.terrainType, state.seed);		// does nothing unless it's the random map
+	city.randVal = (uint16_t)(rand.Next() | 1);					// never 0, which the generator can't leave
+
+	// power plant somewhere away from the edges, the spine runs down its right side or else its left
+	int plantX = -1;
+	int plantY = -1;
+	for (int attempt = 0; attempt < 64 && plantX < 0; attempt++)
+	{
+		const int x = 2 + rand.Next() % (MAP_WIDTH - 12);
+		const int y = 2 + rand.Next() % (MAP_HEIGHT - 8);
+		if (BuyBuilding(city, Powerplant, x, y))
+		{
+			plantX = x;
+			plantY = y;
+		}
+	}
+	if (plantX < 0)
+	{
+		return;
+	}
+	const int spineXs[2] = { plantX + 4, plantX - 1 };
+
+	// bands nearest the plant first, alternating below and above. A band the spine can't reach moves a row further out,
+	// a direction only closes once that runs off the map
+	uint32_t placed = 0;
+	int nextRoadY[2] = { plantY, plantY - 4 };
+	bool open[2] = { true, true };
+	while (open[0] || open[1])
+	{
+		for (int dir = 0; dir < 2; dir++)
+		{
+			int& roadY = nextRoadY[dir];
+			const int step = dir == 0 ? 1 : -1;
+			int spineX = -1;
+			while (open[dir] && spineX < 0)
+			{
+				if (roadY < 0 || roadY + 4 > MAP_HEIGHT)
+				{
+					open[dir] = false;
+					break;
+				}
+				for (int side = 0; side < 2 && spineX < 0; side++)
+				{
+					spineX = BuildSpine(city, spineXs[side], plantY, roadY) ? spineXs[side] : -1;
+				}
+				roadY += spineX < 0 ? step : 0;
+			}
+			if (spineX >= 0)
+			{
+				BuildBand(city, rand, spineX, roadY, plantX, plantY, placed);
+				roadY += 4 * step;
+			}
+		}
+	}
+
+	CalculatePowerConnectivity(city);
+}
+
+bool ReadSaveFile(const char* path, uint8_t* buffer)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	memset(buffer, 0, 1024);
+	fread(buffer, 1, 1024, file);
+	fclose(file);
+	return true;
+}
+
+bool LoadSavedCity(CityContext& city, const uint8_t* buffer, const SimParams& params)
+{
+	InitCityContext(city);
+	city.simParams = &params;
+	if (!LoadCityFromBuffer(city, buffer, true))
+	{
+		return false;
+	}
+	GenerateRandomTerrain(city.state.terrainType, city.state.seed);
+	UpdateLoadedCity(city);
+	return true;
+}
+
+void SimulateYears(CityContext& city, const uint16_t years, CitySummary& summary)
+{
+	GameState& state = city.state;
+	const uint16_t endYear = state.year + years;
+
+	memset(&summary, 0, sizeof(CitySummary));
+	state.flags &= ~FLAG_PAUSE;
+	while (state.year < endYear)
+	{
+		const SimulationEvents events = Simulate(city);
+		if (events.flags & SimulationEvent_Disaster)
+		{
+			summary.disasters++;
+		}
+		if (events.flags & (SimulationEvent_ScenarioWon | SimulationEvent_ScenarioLost))
+		{
+			summary.scenarioResult = events.flags & (SimulationEvent_ScenarioWon | SimulationEvent_ScenarioLost);
+		}
+		// nothing else frees the scratch arena without a frame loop
+		ResetScratchArena();
+	}
+
+	SummariseCity(city, summary);
+}
+
+void SummariseCity(const CityContext& city, CitySummary& summary)
+{
+	const GameState& state = city.state;
+
+	summary.residentialPopulation = state.residentialPopulation;
+	summary.commercialPopulation = state.commercialPopulation;
+	summary.industrialPopulation = state.industrialPopulation;
+	summary.money = state.money;
+	summary.year = state.year;
+	memset(summary.buildingCount, 0, sizeof(summary.buildingCount));
+	summary.rubbleCount = 0;
+	summary.burningCount = 0;
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		const Building& building = state.buildings[n];
+		if (IsRubble(building.type))
+		{
+			summary.rubbleCount++;
+		}
+		else if (building.type != BuildingType_None)
+		{
+			summary.buildingCount[building.type]++;
+			if (building.onFire)
+			{
+				summary.burningCount++;
+			}
+		}
+	}
+}
+
+void PrintSummaryHeader()
+{
+	printf("city,year,residential,commercial,industrial,funds,residential_zones,commercial_zones,industrial_zones,powerplants,parks,police,fire,stadiums,rubble,burning,disasters,scenario\n");
+}
+
+void PrintSummary(const char* name, const CitySummary& summary)
+{
+	const char* scenario = summary.scenarioResult == SimulationEvent_ScenarioWon ? "won" : summary.scenarioResult == SimulationEvent_ScenarioLost ? "lost" : "";
+	printf("%s,%d,%u,%u,%u,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%s\n", name, summary.year + 1900,
+		summary.residentialPopulation, summary.commercialPopulation, summary.industrialPopulation, summary.money,
+		summary.buildingCount[Residential], summary.buildingCount[Commercial], summary.buildingCount[Industrial],
+		summary.buildingCount[Powerplant], summary.buildingCount[Park], summary.buildingCount[PoliceDept],
+		summary.buildingCount[FireDept], summary.buildingCount[Stadium],
+		summary.rubbleCount, summary.burningCount, summary.disasters, scenario);
+}
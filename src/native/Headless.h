@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include "Game.h"
+
+// Helpers shared by the native tools, which simulate cities without the interface
+// Everything here works on the city passed in plus the calling thread's terrain, so it can run on any number of threads
+
+typedef struct
+{
+	uint32_t residentialPopulation;
+	uint32_t commercialPopulation;
+	uint32_t industrialPopulation;
+	int32_t money;
+	uint16_t year;						// years since 1900
+	uint16_t buildingCount[Num_BuildingTypes];
+	uint16_t rubbleCount;				// buildings that burnt down
+	uint16_t burningCount;				// buildings still on fire at the end
+	uint16_t disasters;					// fires started by the disaster timer
+	uint8_t scenarioResult;				// SimulationEvent_ScenarioWon / SimulationEvent_ScenarioLost, 0 if not decided
+} CitySummary;
+
+// Call once before any city is simulated - registers the listeners that keep each city's caches up to date
+void InitHeadless(void);
+
+// Lays out a starting city from the seed: a power plant, then blocks of zones along roads with a power line spine, until
+// the starting funds are down to a reserve for the upkeep
+// The city simulates with the given parameters, which have to outlive it
+void GenerateCity(CityContext& city, const uint32_t seed, const SimParams& params = DefaultSimParams);
+// Reads a disk save into a 1024 byte buffer
+bool ReadSaveFile(const char* path, uint8_t* buffer);
+// Loads a disk save (1024 bytes with header), regenerating its terrain if it's a random map
+bool LoadSavedCity(CityContext& city, const uint8_t* buffer, const SimParams& params = DefaultSimParams);
+
+// Simulates until the given number of years have passed, collecting the outcome
+void SimulateYears(CityContext& city, const uint16_t years, CitySummary& summary);
+void SummariseCity(const CityContext& city, CitySummary& summary);
+
+void PrintSummaryHeader(void);
+void PrintSummary(const char* name, const CitySummary& summary);
@@ -0,0 +1,121 @@
+#include "JobPool.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Jobs still to run by a worker - the owner takes from the front, thieves take from the back
+typedef struct
+{
+	std::mutex lock;
+	uint32_t begin;
+	uint32_t end;
+} WorkQueue;
+
+static bool TakeJob(WorkQueue& queue, uint32_t& job)
+{
+	std::lock_guard<std::mutex> guard(queue.lock);
+	if (queue.begin >= queue.end)
+	{
+		return false;
+	}
+	job = queue.begin++;
+	return true;
+}
+
+static bool StealJobs(std::vector<WorkQueue>& queues, const uint32_t worker)
+{
+	// pick the worker with the most jobs left, the count can be out of date by the time the lock is taken
+	uint32_t victim = worker;
+	uint32_t mostLeft = 0;
+	for (uint32_t n = 0; n < queues.size(); n++)
+	{
+		if (n == worker)
+		{
+			continue;
+		}
+		std::lock_guard<std::mutex> guard(queues[n].lock);
+		const uint32_t left = queues[n].end - queues[n].begin;
+		if (left > mostLeft)
+		{
+			mostLeft = left;
+			victim = n;
+		}
+	}
+	if (victim == worker)
+	{
+		return false;
+	}
+
+	uint32_t begin, end;
+	{
+		std::lock_guard<std::mutex> guard(queues[victim].lock);
+		const uint32_t left = queues[victim].end - queues[victim].begin;
+		if (left == 0)
+		{
+			// someone else got there first, the caller looks again
+			return true;
+		}
+		end = queues[victim].end;
+		begin = end - (left + 1) / 2;
+		queues[victim].end = begin;
+	}
+
+	std::lock_guard<std::mutex> guard(queues[worker].lock);
+	queues[worker].begin = begin;
+	queues[worker].end = end;
+	return true;
+}
+
+static void RunWorker(std::vector<WorkQueue>& queues, const uint32_t worker, const JobFunction& function)
+{
+	uint32_t job;
+	for (;;)
+	{
+		while (TakeJob(queues[worker], job))
+		{
+			function(job, worker);
+		}
+		if (!StealJobs(queues, worker))
+		{
+			return;
+		}
+	}
+}
+
+void RunJobs(const uint32_t count, uint32_t threads, const JobFunction& function)
+{
+	if (threads == 0)
+	{
+		threads = 1;
+	}
+	if (threads > count)
+	{
+		threads = count > 0 ? count : 1;
+	}
+
+	std::vector<WorkQueue> queues(threads);
+	for (uint32_t n = 0; n < threads; n++)
+	{
+		queues[n].begin = (uint64_t)count * n / threads;
+		queues[n].end = (uint64_t)count * (n + 1) / threads;
+	}
+
+	// the calling thread is worker 0
+	std::vector<std::thread> workers;
+	for (uint32_t n = 1; n < threads; n++)
+	{
+		workers.emplace_back(RunWorker, std::ref(queues), n, std::cref(function));
+	}
+	RunWorker(queues, 0, function);
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+uint32_t GetDefaultThreadCount()
+{
+	const uint32_t threads = std::thread::hardware_concurrency();
+	return threads > 0 ? threads : 1;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+// Called for every job, worker is the index of the thread running it (0 to threads-1)
+typedef std::function<void(const uint32_t job, const uint32_t worker)> JobFunction;
+
+// Runs jobs 0 to count-1 across the given number of threads and returns when they have all finished
+// Each worker starts with an even share of the jobs, and once its own run out it steals half of what's left from
+// the busiest worker, so cities that take longer than others don't leave cores idle at the end
+void RunJobs(const uint32_t count, uint32_t threads, const JobFunction& function);
+
+// Number of hardware threads, at least 1
+uint32_t GetDefaultThreadCount(void);
@@ -0,0 +1,181 @@
+// Checks the cart's wasmmath functions against the host libm and times them - the cart can't link libm, so these are
+// what it uses instead. Prints the worst error of each function and exits with 1 if any is outside its bound
+//
+// mathcheck [--samples N] [--seed N]
+//   errors are in ulps of the libm result, sin and cos also allow an absolute error for results near their zeros
+
+// before <cmath>, whose M_ constants would otherwise be redefined
+#include "wasmmath.h"
+#include "randommt.h"
+
+#include <chrono>
+#include <cmath>
+#include <float.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+	const char* name;
+	double (*cart)(double x, double y);
+	double (*host)(double x, double y);
+	double minX, maxX;			// x is uniform in this range
+	bool exponentialX;			// or 2 to the power of a value uniform in it, to cover every magnitude
+	double minY, maxY;			// y too, for functions of two values
+	bool integerY;				// y is rounded, so pow goes through _ipow
+	double maxUlps;
+	double maxAbsolute;			// an error up to this passes whatever the ulps, 0 for none
+} MathFunction;
+
+static double CartSin(double x, double) { return _sin(x); }
+static double CartCos(double x, double) { return _cos(x); }
+static double CartExp(double x, double) { return _exp(x); }
+static double CartLog(double x, double) { return _log(x); }
+static double CartPow(double x, double y) { return _pow(x, y); }
+static double HostSin(double x, double) { return sin(x); }
+static double HostCos(double x, double) { return cos(x); }
+static double HostExp(double x, double) { return exp(x); }
+static double HostLog(double x, double) { return log(x); }
+static double HostPow(double x, double y) { return pow(x, y); }
+
+// Bounds have some headroom over what was measured. The reduction of sin and cos by a two part pi/2 loses absolute
+// rather than relative precision as the angle grows and integer powers round once for every multiply of the squaring
+const MathFunction MathFunctions[] =
+{
+	{ "sin", CartSin, HostSin, -1300.0, 1300.0, false, 0, 0, false, 2.0, 1e-15 },
+	{ "cos", CartCos, HostCos, -1300.0, 1300.0, false, 0, 0, false, 2.0, 1e-15 },
+	{ "exp", CartExp, HostExp, -700.0, 700.0, false, 0, 0, false, 2.0, 0 },
+	{ "log", CartLog, HostLog, -1000.0, 1000.0, true, 0, 0, false, 2.0, 0 },
+	{ "log1", CartLog, HostLog, 0.5, 2.0, false, 0, 0, false, 2.0, 0 },
+	{ "pow", CartPow, HostPow, 0.0, 100.0, false, -20.0, 20.0, false, 2.0, 0 },
+	{ "ipow", CartPow, HostPow, -10.0, 10.0, false, -30.0, 30.0, true, 32.0, 0 },
+};
+
+#define NUM_MATH_FUNCTIONS (sizeof(MathFunctions) / sizeof(MathFunctions[0]))
+
+// Distance between b and the next double away from zero
+static double GetUlp(const double b)
+{
+	const double magnitude = fabs(b);
+	if (magnitude < DBL_MIN)
+	{
+		return nextafter(0.0, 1.0);
+	}
+	return nextafter(magnitude, INFINITY) - magnitude;
+}
+
+static double GetSample(RandomMT& rand, const double low, const double high)
+{
+	return low + (high - low) * rand.NextDouble();
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: mathcheck [--samples N] [--seed N]\n");
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t samples = 1000000;
+	uint64_t seed = 1;
+
+	for (int n = 1; n < argc; n++)
+	{
+		if (strcmp(argv[n], "--samples") == 0 && n + 1 < argc)
+		{
+			samples = (uint32_t)strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(argv[n], "--seed") == 0 && n + 1 < argc)
+		{
+			seed = strtoull(argv[++n], nullptr, 10);
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+	if (samples == 0)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	double* xs = (double*)malloc(samples * sizeof(double));
+	double* ys = (double*)malloc(samples * sizeof(double));
+	if (xs == nullptr || ys == nullptr)
+	{
+		fprintf(stderr, "mathcheck: out of memory\n");
+		return 1;
+	}
+
+	bool failed = false;
+	printf("function,samples,max_ulps,max_abs_error,failures,cart_ns,libm_ns\n");
+	for (size_t f = 0; f < NUM_MATH_FUNCTIONS; f++)
+	{
+		const MathFunction& function = MathFunctions[f];
+		RandomMT rand(seed + f);
+		for (uint32_t n = 0; n < samples; n++)
+		{
+			xs[n] = GetSample(rand, function.minX, function.maxX);
+			xs[n] = function.exponentialX ? exp2(xs[n]) : xs[n];
+			ys[n] = GetSample(rand, function.minY, function.maxY);
+			ys[n] = function.integerY ? floor(ys[n] + 0.5) : ys[n];
+		}
+
+		double maxUlps = 0;
+		double maxAbsolute = 0;
+		uint32_t failures = 0;
+		for (uint32_t n = 0; n < samples; n++)
+		{
+			const double cart = function.cart(xs[n], ys[n]);
+			const double host = function.host(xs[n], ys[n]);
+			if (!std::isfinite(host) || !std::isfinite(cart))
+			{
+				// both overflowing the same way is right, anything else is a failure
+				if (cart != host && !(std::isnan(cart) && std::isnan(host)))
+				{
+					failures++;
+				}
+				continue;
+			}
+			const double absolute = fabs(cart - host);
+			const double ulps = absolute / GetUlp(host);
+			maxUlps = ulps > maxUlps ? ulps : maxUlps;
+			maxAbsolute = absolute > maxAbsolute ? absolute : maxAbsolute;
+			if (ulps > function.maxUlps && absolute > function.maxAbsolute)
+			{
+				failures++;
+			}
+		}
+
+		// the sum stops the calls being optimised away
+		volatile double sum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t n = 0; n < samples; n++)
+		{
+			sum = sum + function.cart(xs[n], ys[n]);
+		}
+		auto middle = std::chrono::steady_clock::now();
+		for (uint32_t n = 0; n < samples; n++)
+		{
+			sum = sum + function.host(xs[n], ys[n]);
+		}
+		auto end = std::chrono::steady_clock::now();
+		const double cartNs = std::chrono::duration<double, std::nano>(middle - start).count() / samples;
+		const double hostNs = std::chrono::duration<double, std::nano>(end - middle).count() / samples;
+
+		printf("%s,%u,%.2f,%.3g,%u,%.1f,%.1f\n", function.name, samples, maxUlps, maxAbsolute, failures, cartNs, hostNs);
+		failed = failed || failures > 0;
+	}
+
+	free(xs);
+	free(ys);
+	if (failed)
+	{
+		fprintf(stderr, "mathcheck: some results are outside their bounds\n");
+	}
+	return failed ? 1 : 0;
+}
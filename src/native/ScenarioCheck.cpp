@@ -0,0 +1,592 @@
+// Scenario checker - plays every scenario many times, with different disaster luck and a couple of scripted players,
+// and reports how often its goals are reached. A scenario that nobody wins is too hard, one that wins idle is too easy.
+// Each goal is also reported on its own, how often it was met in the goal year and how close the runs got on average,
+// so a scenario nobody wins still shows which goal is out of reach
+//
+// scenariocheck [--runs N] [--threads N] [--scenario INDEX] [--strategy idle|greedy] [--first-seed N] [--fast]
+//   idle - leaves the scenario city as it starts, greedy - builds whatever the goals are short of next to roads and power
+
+#include "Headless.h"
+#include "JobPool.h"
+#include "Arena.h"
+#include "Simulation.h"
+#include "scenario.h"
+#include "randommt.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+enum ScenarioStrategy
+{
+	Strategy_Idle,
+	Strategy_Greedy,
+	Num_Strategies
+};
+
+const char* StrategyNames[Num_Strategies] = { "idle", "greedy" };
+
+// Zones only grow with this many road tiles along their edges, see SimulateBuilding()
+#define ZONE_ROAD_CONNECTIONS 3
+// Keeps enough in hand for a year of maintenance before the taxes come in
+#define GREEDY_RESERVE 500
+#define GREEDY_BUILDS_PER_MONTH 2
+// A police and a fire department for every so many zones - crime and fires hold growth back, but they cost $100 a year each
+#define GREEDY_ZONES_PER_POLICE 16
+#define GREEDY_ZONES_PER_FIRE 16
+
+// The goals of a scenario that are checked on their own
+enum ScenarioGoal
+{
+	Goal_Funds,
+	Goal_Residential,
+	Goal_Commercial,
+	Goal_Industrial,
+	Goal_Buildings,				// all of the goal buildings
+	Num_Goals
+};
+
+const char* GoalNames[Num_Goals] = { "funds", "residential", "commercial", "industrial", "buildings" };
+
+typedef struct
+{
+	uint8_t scenario;
+	uint8_t strategy;
+	uint32_t seed;
+	bool won;
+	int16_t goalsMetYear;			// first year all the goals held at a month end, -1 if they never did
+	uint16_t built;					// buildings the strategy placed
+	double goalProgress[Num_Goals];	// how much of each goal the city had when the game ended, 0-1 and 1 if it's met, -1 if the scenario hasn't got it
+	CitySummary summary;
+	double seconds;
+} ScenarioRun;
+
+typedef struct
+{
+	int x;
+	int y;
+	int score;
+	int roadSide;					// -1 if it touches a road already, else 0 for above and 1 for below, where a road has to go
+} BuildSite;
+
+inline bool IsTilePowered(const CityContext& city, const int x, const int y)
+{
+	const int index = y * MAP_WIDTH + x;
+	return (city.powerGrid[index >> 3] & (1 << (index & 7))) != 0;
+}
+
+// Clear land with no road and no building that isn't rubble
+static bool IsTileFree(const CityContext& city, const uint8_t* ownerMap, const int x, const int y)
+{
+	if (!IsTerrainClear(city.state.terrainType, x, y) || (GetConnections(city, x, y) & RoadMask))
+	{
+		return false;
+	}
+	const uint8_t owner = ownerMap[y * MAP_WIDTH + x];
+	return owner == 0 || IsRubble(city.state.buildings[owner - 1].type);
+}
+
+// A row of road the width of the building, above or below it, that joins up with a road at one of its ends
+static bool CanJoinRoad(const CityContext& city, const uint8_t* ownerMap, const int x, const int y, const int width)
+{
+	if (y < 0 || y >= MAP_HEIGHT)
+	{
+		return false;
+	}
+	bool joined = (GetConnections(city, x - 1, y) & RoadMask) || (GetConnections(city, x + width, y) & RoadMask);
+	for (int i = x; i < x + width; i++)
+	{
+		const uint8_t connections = GetConnections(city, i, y);
+		if (connections & RoadMask)
+		{
+			joined = true;
+			continue;
+		}
+		const uint8_t owner = ownerMap[y * MAP_WIDTH + i];
+		if (!IsTerrainClear(city.state.terrainType, i, y) || (owner != 0 && !IsRubble(city.state.buildings[owner - 1].type)))
+		{
+			return false;
+		}
+	}
+	return joined;
+}
+
+// Distance from the top left of a site to the closest industrial zone or power plant, up to 16
+static int GetPolluterDistance(const GameState& state, const int x, const int y)
+{
+	int closest = 16;
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		const Building& building = state.buildings[n];
+		if (building.type == Industrial || building.type == Powerplant)
+		{
+			const int distance = abs(building.x - x) + abs(building.y - y);
+			closest = distance < closest ? distance : closest;
+		}
+	}
+	return closest;
+}
+
+// Scores every place the building fits - it has to touch power (unless it's a plant) and enough road, or a row of road that
+// can be joined on. More road and sites close to the start of the search win, the start moves with the seed
+static bool FindBuildSite(CityContext& city, RandomMT& rand, const uint8_t type, BuildSite& best)
+{
+	const uint8_t* ownerMap = GetBuildingOwnerMap(city);
+	if (ownerMap == nullptr)
+	{
+		return false;
+	}
+	const BuildingInfo* info = GetBuildingInfo(type);
+	const int width = info->width;
+	const int height = info->height;
+	const int startX = rand.Next() % MAP_WIDTH;
+	const int startY = rand.Next() % MAP_HEIGHT;
+
+	best.score = 0;
+	for (int v = 0; v <= MAP_HEIGHT - height; v++)
+	{
+		for (int u = 0; u <= MAP_WIDTH - width; u++)
+		{
+			const int x = (u + startX) % (MAP_WIDTH - width + 1);
+			const int y = (v + startY) % (MAP_HEIGHT - height + 1);
+
+			bool free = true;
+			for (int j = y; j < y + height && free; j++)
+			{
+				for (int i = x; i < x + width && free; i++)
+				{
+					free = IsTileFree(city, ownerMap, i, j);
+				}
+			}
+			if (!free)
+			{
+				continue;
+			}
+
+			// the edges, without the corners which don't conduct or count as touching
+			int roads = 0;
+			bool powered = type == Powerplant;
+			for (int i = x; i < x + width; i++)
+			{
+				roads += (GetConnections(city, i, y - 1) & RoadMask) ? 1 : 0;
+				roads += (GetConnections(city, i, y + height) & RoadMask) ? 1 : 0;
+				powered |= y > 0 && IsTilePowered(city, i, y - 1);
+				powered |= y + height < MAP_HEIGHT && IsTilePowered(city, i, y + height);
+			}
+			for (int j = y; j < y + height; j++)
+			{
+				roads += (GetConnections(city, x - 1, j) & RoadMask) ? 1 : 0;
+				roads += (GetConnections(city, x + width, j) & RoadMask) ? 1 : 0;
+				powered |= x > 0 && IsTilePowered(city, x - 1, j);
+				powered |= x + width < MAP_WIDTH && IsTilePowered(city, x + width, j);
+			}
+			if (!powered)
+			{
+				continue;
+			}
+
+			BuildSite site = { x, y, 0, -1 };
+			if (roads >= ZONE_ROAD_CONNECTIONS)
+			{
+				site.score = 2 * width + roads;
+			}
+			else if (CanJoinRoad(city, ownerMap, x, y - 1, width))
+			{
+				site.score = 1;
+				site.roadSide = 0;
+			}
+			else if (CanJoinRoad(city, ownerMap, x, y + height, width))
+			{
+				site.score = 1;
+				site.roadSide = 1;
+			}
+			if (site.score > 0 && type == Residential)
+			{
+				// homes away from the pollution
+				site.score += GetPolluterDistance(city.state, x, y);
+			}
+			if (site.score > best.score)
+			{
+				best = site;
+			}
+		}
+	}
+	return best.score > 0;
+}
+
+static bool BuildForGoal(CityContext& city, RandomMT& rand, const uint8_t type)
+{
+	GameState& state = city.state;
+	const BuildingInfo* info = GetBuildingInfo(type);
+	BuildSite site;
+
+	if (state.money < info->cost + info->width * ROAD_COST + GREEDY_RESERVE || !FindBuildSite(city, rand, type, site))
+	{
+		return false;
+	}
+	if (!CanPlaceBuilding(city, type, site.x, site.y) || !PlaceBuilding(city, type, site.x, site.y))
+	{
+		return false;
+	}
+	state.money -= info->cost;
+
+	if (site.roadSide >= 0)
+	{
+		const int roadY = site.roadSide == 0 ? site.y - 1 : site.y + info->height;
+		for (int x = site.x; x < site.x + info->width; x++)
+		{
+			const uint8_t connections = GetConnections(city, x, roadY);
+			if (!(connections & RoadMask))
+			{
+				SetConnections(city, x, roadY, connections | RoadMask);
+				state.money -= ROAD_COST;
+			}
+		}
+	}
+	return true;
+}
+
+// Zones of the type that haven't started to grow - while there are some, another one won't help
+static bool HasEmptyZone(const GameState& state, const uint8_t type)
+{
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		if (state.buildings[n].type == type && state.buildings[n].populationDensity == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static int CountBuildings(const GameState& state, const uint8_t type)
+{
+	int count = 0;
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		count += state.buildings[n].type == type ? 1 : 0;
+	}
+	return count;
+}
+
+// Once a month: the goal buildings that are missing, police and fire cover, then a zone for the population furthest
+// behind its goal. When only the funds goal is left it saves up
+static uint16_t PlayGreedyMonth(CityContext& city, RandomMT& rand)
+{
+	GameState& state = city.state;
+	const Scenario& scenario = ScenarioData[state.data[0] >> 2];
+	uint16_t built = 0;
+
+	CalculatePowerConnectivity(city);
+
+	for (int i = 0; i < SCENARIO_GOAL_BUILDING_COUNT && built < GREEDY_BUILDS_PER_MONTH; i++)
+	{
+		const uint8_t type = scenario.goalbuilding[i];
+		if (type == BuildingType_None)
+		{
+			continue;
+		}
+		if (CountBuildings(state, type) < scenario.goalbuildingcount[i] && BuildForGoal(city, rand, type))
+		{
+			built++;
+		}
+	}
+
+	const int zones = CountBuildings(state, Residential) + CountBuildings(state, Commercial) + CountBuildings(state, Industrial);
+	if (built < GREEDY_BUILDS_PER_MONTH && CountBuildings(state, PoliceDept) < 1 + zones / GREEDY_ZONES_PER_POLICE && BuildForGoal(city, rand, PoliceDept))
+	{
+		built++;
+	}
+	if (built < GREEDY_BUILDS_PER_MONTH && CountBuildings(state, FireDept) < zones / GREEDY_ZONES_PER_FIRE && BuildForGoal(city, rand, FireDept))
+	{
+		built++;
+	}
+
+	const uint32_t goals[3] = { scenario.goalrespop, scenario.goalcompop, scenario.goalindpop };
+	const uint32_t populations[3] = { state.residentialPopulation, state.commercialPopulation, state.industrialPopulation };
+	while (built < GREEDY_BUILDS_PER_MONTH)
+	{
+		// shortfall as a fraction of the goal, in 1/256ths
+		uint8_t type = BuildingType_None;
+		uint32_t worst = 0;
+		for (int n = 0; n < 3; n++)
+		{
+			const uint8_t zone = Residential + n;
+			if (populations[n] < goals[n] && !HasEmptyZone(state, zone))
+			{
+				const uint32_t shortfall = (goals[n] - populations[n]) * 256 / goals[n];
+				if (shortfall > worst)
+				{
+					worst = shortfall;
+					type = zone;
+				}
+			}
+		}
+		if (type == BuildingType_None || !BuildForGoal(city, rand, type))
+		{
+			break;
+		}
+		built++;
+	}
+	return built;
+}
+
+static double GetGoalProgress(const double value, const double goal)
+{
+	return value >= goal ? 1.0 : value <= 0 ? 0.0 : value / goal;
+}
+
+static void MeasureGoals(const GameState& state, ScenarioRun& run)
+{
+	const Scenario& scenario = ScenarioData[run.scenario];
+	run.goalProgress[Goal_Funds] = GetGoalProgress(state.money, scenario.goalfunds);
+	run.goalProgress[Goal_Residential] = GetGoalProgress(state.residentialPopulation, scenario.goalrespop);
+	run.goalProgress[Goal_Commercial] = GetGoalProgress(state.commercialPopulation, scenario.goalcompop);
+	run.goalProgress[Goal_Industrial] = GetGoalProgress(state.industrialPopulation, scenario.goalindpop);
+
+	// each building counts up to the number needed of its type
+	int needed = 0, have = 0;
+	for (int i = 0; i < SCENARIO_GOAL_BUILDING_COUNT; i++)
+	{
+		if (scenario.goalbuilding[i] != BuildingType_None)
+		{
+			const int count = CountBuildings(state, scenario.goalbuilding[i]);
+			needed += scenario.goalbuildingcount[i];
+			have += count < scenario.goalbuildingcount[i] ? count : scenario.goalbuildingcount[i];
+		}
+	}
+	run.goalProgress[Goal_Buildings] = needed > 0 ? GetGoalProgress(have, needed) : -1;
+}
+
+static void PlayScenario(ScenarioRun& run, const bool fast)
+{
+	CityContext city;
+	RandomMT rand(run.seed);
+
+	InitCityContext(city);
+	if (!StartScenario(city, run.scenario))
+	{
+		FreeCityContext(city);
+		return;
+	}
+	GameState& state = city.state;
+	GenerateRandomTerrain(state.terrainType, state.seed);
+	city.randVal = (uint16_t)(rand.Next() | 1);			// the disasters and fires differ from run to run
+	if (fast)
+	{
+		state.flags |= FLAG_FAST;
+	}
+
+	const uint16_t goalYear = ScenarioData[run.scenario].goalyear - 1900;
+	run.goalsMetYear = -1;
+	while (state.year <= goalYear && !run.won && !(state.data[0] & 1))
+	{
+		// the goals are checked at the end of the month, which for December is before the year goes up
+		const uint8_t month = state.month;
+		const uint16_t year = state.year;
+		const SimulationEvents events = Simulate(city);
+		if (events.flags & SimulationEvent_Disaster)
+		{
+			run.summary.disasters++;
+		}
+		run.won = (events.flags & SimulationEvent_ScenarioWon) != 0;
+
+		if (state.month != month)
+		{
+			if (run.goalsMetYear < 0 && AreScenarioGoalsMet(state))
+			{
+				run.goalsMetYear = year + 1900;
+			}
+			if (run.strategy == Strategy_Greedy)
+			{
+				run.built += PlayGreedyMonth(city, rand);
+			}
+		}
+		ResetScratchArena();
+	}
+
+	MeasureGoals(state, run);
+	const uint16_t disasters = run.summary.disasters;
+	SummariseCity(city, run.summary);
+	run.summary.disasters = disasters;
+	run.summary.scenarioResult = run.won ? SimulationEvent_ScenarioWon : SimulationEvent_ScenarioLost;
+	FreeCityContext(city);
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: scenariocheck [--runs N] [--threads N] [--scenario INDEX] [--strategy idle|greedy] [--first-seed N] [--fast]\n");
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t runsPerCheck = 16;
+	uint32_t threads = GetDefaultThreadCount();
+	uint32_t firstSeed = 1;
+	int scenarioFilter = -1;
+	int strategyFilter = -1;
+	bool fast = false;
+
+	for (int n = 1; n < argc; n++)
+	{
+		const char* arg = argv[n];
+		const bool hasValue = n + 1 < argc;
+		if (strcmp(arg, "--runs") == 0 && hasValue)
+		{
+			runsPerCheck = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--threads") == 0 && hasValue)
+		{
+			threads = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--scenario") == 0 && hasValue)
+		{
+			scenarioFilter = atoi(argv[++n]);
+			if (scenarioFilter < 0 || scenarioFilter >= SCENARIO_COUNT || !(ScenarioData[scenarioFilter].flags & SCENARIO_FLAG_SCENARIO))
+			{
+				fprintf(stderr, "%d is not a scenario\n", scenarioFilter);
+				return 1;
+			}
+		}
+		else if (strcmp(arg, "--strategy") == 0 && hasValue)
+		{
+			const char* name = argv[++n];
+			for (int s = 0; s < Num_Strategies; s++)
+			{
+				if (strcmp(name, StrategyNames[s]) == 0)
+				{
+					strategyFilter = s;
+				}
+			}
+			if (strategyFilter < 0)
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(arg, "--first-seed") == 0 && hasValue)
+		{
+			firstSeed = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--fast") == 0)
+		{
+			fast = true;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// every scenario with every strategy, each played with the same seeds
+	std::vector<ScenarioRun> runs;
+	for (int scenario = 0; scenario < SCENARIO_COUNT; scenario++)
+	{
+		if (!(ScenarioData[scenario].flags & SCENARIO_FLAG_SCENARIO) || (scenarioFilter >= 0 && scenario != scenarioFilter))
+		{
+			continue;
+		}
+		for (int strategy = 0; strategy < Num_Strategies; strategy++)
+		{
+			if (strategyFilter >= 0 && strategy != strategyFilter)
+			{
+				continue;
+			}
+			for (uint32_t n = 0; n < runsPerCheck; n++)
+			{
+				ScenarioRun run = {};
+				run.scenario = scenario;
+				run.strategy = strategy;
+				run.seed = firstSeed + n;
+				runs.push_back(run);
+			}
+		}
+	}
+
+	if (runs.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	InitHeadless();
+
+	const auto start = std::chrono::steady_clock::now();
+	RunJobs(runs.size(), threads, [&](const uint32_t job, const uint32_t worker)
+	{
+		const auto runStart = std::chrono::steady_clock::now();
+		ResetScratchArena();
+		PlayScenario(runs[job], fast);
+		runs[job].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+	});
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("scenario,strategy,runs,win_rate,goals_met_rate,goals_met_year,");
+	for (int goal = 0; goal < Num_Goals; goal++)
+	{
+		printf("%s_met_rate,%s_progress,", GoalNames[goal], GoalNames[goal]);
+	}
+	printf("built,residential,commercial,industrial,funds,disasters,ms_per_run\n");
+	for (size_t first = 0; first < runs.size(); first += runsPerCheck)
+	{
+		uint32_t won = 0, goalsMet = 0;
+		uint32_t goalMet[Num_Goals] = {};
+		double goalProgress[Num_Goals] = {};
+		double goalsMetYear = 0, built = 0, residential = 0, commercial = 0, industrial = 0, money = 0, disasters = 0, runSeconds = 0;
+		for (size_t n = first; n < first + runsPerCheck; n++)
+		{
+			const ScenarioRun& run = runs[n];
+			won += run.won ? 1 : 0;
+			if (run.goalsMetYear >= 0)
+			{
+				goalsMet++;
+				goalsMetYear += run.goalsMetYear;
+			}
+			for (int goal = 0; goal < Num_Goals; goal++)
+			{
+				goalMet[goal] += run.goalProgress[goal] >= 1.0 ? 1 : 0;
+				goalProgress[goal] += run.goalProgress[goal];
+			}
+			built += run.built;
+			residential += run.summary.residentialPopulation;
+			commercial += run.summary.commercialPopulation;
+			industrial += run.summary.industrialPopulation;
+			money += run.summary.money;
+			disasters += run.summary.disasters;
+			runSeconds += run.seconds;
+		}
+
+		const ScenarioRun& run = runs[first];
+		const double count = runsPerCheck;
+		printf("%s,%s,%u,%.3f,%.3f,", ScenarioData[run.scenario].title, StrategyNames[run.strategy], runsPerCheck, won / count, goalsMet / count);
+		if (goalsMet > 0)
+		{
+			printf("%.1f,", goalsMetYear / goalsMet);
+		}
+		else
+		{
+			printf(",");
+		}
+		for (int goal = 0; goal < Num_Goals; goal++)
+		{
+			if (run.goalProgress[goal] < 0)
+			{
+				printf(",,");
+				continue;
+			}
+			printf("%.3f,%.3f,", goalMet[goal] / count, goalProgress[goal] / count);
+		}
+		printf("%.1f,%.1f,%.1f,%.1f,%.0f,%.2f,%.2f\n", built / count, residential / count, commercial / count, industrial / count,
+			money / count, disasters / count, runSeconds * 1000 / count);
+	}
+
+	if (threads > runs.size())
+	{
+		threads = runs.size();
+	}
+	fprintf(stderr, "%u runs in %.3fs on %u threads: %.1f runs/s\n", (uint32_t)runs.size(), seconds, threads, runs.size() / seconds);
+	return 0;
+}
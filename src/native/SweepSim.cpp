@@ -0,0 +1,321 @@
+// Parameter sweep - simulates the same cities under every combination of the given SimParams values and prints the
+// average outcome of each combination. Every combination runs the same seeds and saves, so the rows compare like for like
+//
+// sweepsim --param NAME=VALUES [--param NAME=VALUES ...] [--years N] [--threads N] [--seeds COUNT] [--first-seed N] [save files...]
+//   NAME is the define in Defines.h (SIM_FIRE_SPREAD_CHANCE), VALUES is a list (32,64,96) or a range (first:last:step)
+
+#include "Headless.h"
+#include "JobPool.h"
+#include "Arena.h"
+
+#include <chrono>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef struct
+{
+	const char* name;
+	size_t offset;
+} SimParamName;
+
+#define SIM_PARAM_NAME(define, member) { define, offsetof(SimParams, member) }
+
+const SimParamName SimParamNames[] =
+{
+	SIM_PARAM_NAME("SIM_INCREMENT_POP_THRESHOLD", incrementPopThreshold),
+	SIM_PARAM_NAME("SIM_DECREMENT_POP_THRESHOLD", decrementPopThreshold),
+	SIM_PARAM_NAME("AVERAGE_POPULATION_DENSITY", averagePopulationDensity),
+	SIM_PARAM_NAME("SIM_BASE_SCORE", baseScore),
+	SIM_PARAM_NAME("SIM_AVERAGING_STRENGTH", averagingStrength),
+	SIM_PARAM_NAME("SIM_EMPLOYMENT_BOOST", employmentBoost),
+	SIM_PARAM_NAME("SIM_UNEMPLOYMENT_PENALTY", unemploymentPenalty),
+	SIM_PARAM_NAME("SIM_INDUSTRIAL_OPPORTUNITY_BOOST", industrialOpportunityBoost),
+	SIM_PARAM_NAME("SIM_COMMERCIAL_OPPORTUNITY_BOOST", commercialOpportunityBoost),
+	SIM_PARAM_NAME("SIM_LOCAL_BUILDING_DISTANCE", localBuildingDistance),
+	SIM_PARAM_NAME("SIM_LOCAL_BUILDING_INFLUENCE", localBuildingInfluence),
+	SIM_PARAM_NAME("SIM_STADIUM_BOOST", stadiumBoost),
+	SIM_PARAM_NAME("SIM_PARK_BOOST", parkBoost),
+	SIM_PARAM_NAME("SIM_MAX_CRIME", maxCrime),
+	SIM_PARAM_NAME("SIM_RANDOM_STRENGTH_MASK", randomStrengthMask),
+	SIM_PARAM_NAME("SIM_POLLUTION_INFLUENCE", pollutionInfluence),
+	SIM_PARAM_NAME("SIM_MAX_POLLUTION", maxPollution),
+	SIM_PARAM_NAME("SIM_INDUSTRIAL_BASE_POLLUTION", industrialBasePollution),
+	SIM_PARAM_NAME("SIM_TRAFFIC_BASE_POLLUTION", trafficBasePollution),
+	SIM_PARAM_NAME("SIM_POWERPLANT_BASE_POLLUTION", powerplantBasePollution),
+	SIM_PARAM_NAME("SIM_HEAVY_TRAFFIC_THRESHOLD", heavyTrafficThreshold),
+	SIM_PARAM_NAME("SIM_IDEAL_TAX_RATE", idealTaxRate),
+	SIM_PARAM_NAME("SIM_TAX_RATE_PENALTY", taxRatePenalty),
+	SIM_PARAM_NAME("FIRE_AND_POLICE_MAINTENANCE_COST", fireAndPoliceMaintenanceCost),
+	SIM_PARAM_NAME("ROAD_MAINTENANCE_COST", roadMaintenanceCost),
+	SIM_PARAM_NAME("SIM_FIRE_SPREAD_CHANCE", fireSpreadChance),
+	SIM_PARAM_NAME("SIM_FIRE_BURN_CHANCE", fireBurnChance),
+	SIM_PARAM_NAME("SIM_FIRE_DEPT_BASE_INFLUENCE", fireDeptBaseInfluence),
+	SIM_PARAM_NAME("SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER", fireDeptInfluenceMultiplier),
+	SIM_PARAM_NAME("MIN_TIME_BETWEEN_DISASTERS", minTimeBetweenDisasters),
+	SIM_PARAM_NAME("MAX_TIME_BETWEEN_DISASTERS", maxTimeBetweenDisasters),
+};
+
+static_assert(sizeof(SimParamNames) / sizeof(SimParamNames[0]) == sizeof(SimParams) / sizeof(int32_t), "every SimParams member needs a name");
+
+typedef struct
+{
+	const SimParamName* param;
+	std::vector<int32_t> values;
+} SweepAxis;
+
+// Totals over every city of one combination
+typedef struct
+{
+	double residential;
+	double commercial;
+	double industrial;
+	double money;
+	double rubble;
+	double disasters;
+	uint32_t bankrupt;			// cities that ended in debt
+	uint32_t cities;
+} SweepResult;
+
+static const SimParamName* FindSimParam(const std::string& name)
+{
+	for (const SimParamName& param : SimParamNames)
+	{
+		if (name == param.name)
+		{
+			return &param;
+		}
+	}
+	return nullptr;
+}
+
+// NAME=1,2,3 or NAME=first:last:step
+static bool ParseAxis(const char* arg, SweepAxis& axis)
+{
+	const char* equals = strchr(arg, '=');
+	if (equals == nullptr)
+	{
+		return false;
+	}
+	axis.param = FindSimParam(std::string(arg, equals - arg));
+	if (axis.param == nullptr)
+	{
+		fprintf(stderr, "unknown parameter in %s\n", arg);
+		return false;
+	}
+
+	const char* values = equals + 1;
+	if (strchr(values, ':') != nullptr)
+	{
+		int32_t first, last, step = 1;
+		if (sscanf(values, "%d:%d:%d", &first, &last, &step) < 2 || step <= 0)
+		{
+			return false;
+		}
+		for (int32_t value = first; value <= last; value += step)
+		{
+			axis.values.push_back(value);
+		}
+	}
+	else
+	{
+		for (char* end = nullptr; *values; values = end)
+		{
+			axis.values.push_back(strtol(values, &end, 10));
+			if (end == values)
+			{
+				return false;
+			}
+			if (*end == ',')
+			{
+				end++;
+			}
+		}
+	}
+	return !axis.values.empty();
+}
+
+// The time to the next disaster is a random value from min up to max, which has to fit timeToNextDisaster
+static bool CheckDisasterTimes(const SimParams& params)
+{
+	const int32_t minTime = params.minTimeBetweenDisasters;
+	const int32_t maxTime = params.maxTimeBetweenDisasters;
+	if (minTime < 1 || minTime >= maxTime || maxTime > UINT16_MAX)
+	{
+		fprintf(stderr, "MIN_TIME_BETWEEN_DISASTERS (%d) has to be at least 1 and less than MAX_TIME_BETWEEN_DISASTERS (%d), "
+			"which can't be more than %d\n", minTime, maxTime, UINT16_MAX);
+		return false;
+	}
+	return true;
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "usage: sweepsim --param NAME=VALUES [--param NAME=VALUES ...] [--years N] [--threads N] [--seeds COUNT] [--first-seed N] [save files...]\n");
+	fprintf(stderr, "  VALUES is a list (32,64,96) or a range (first:last:step), NAME is one of:\n");
+	for (const SimParamName& param : SimParamNames)
+	{
+		fprintf(stderr, "    %s\n", param.name);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t years = 20;
+	uint32_t threads = GetDefaultThreadCount();
+	uint32_t seedCount = 0;
+	uint32_t firstSeed = 1;
+	std::vector<SweepAxis> axes;
+	std::vector<std::vector<uint8_t>> saves;
+
+	for (int n = 1; n < argc; n++)
+	{
+		const char* arg = argv[n];
+		const bool hasValue = n + 1 < argc;
+		if (strcmp(arg, "--param") == 0 && hasValue)
+		{
+			SweepAxis axis;
+			if (!ParseAxis(argv[++n], axis))
+			{
+				PrintUsage();
+				return 1;
+			}
+			axes.push_back(axis);
+		}
+		else if (strcmp(arg, "--years") == 0 && hasValue)
+		{
+			years = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--threads") == 0 && hasValue)
+		{
+			threads = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--seeds") == 0 && hasValue)
+		{
+			seedCount = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (strcmp(arg, "--first-seed") == 0 && hasValue)
+		{
+			firstSeed = strtoul(argv[++n], nullptr, 10);
+		}
+		else if (arg[0] == '-')
+		{
+			PrintUsage();
+			return 1;
+		}
+		else
+		{
+			std::vector<uint8_t> save(1024);
+			if (!ReadSaveFile(arg, save.data()))
+			{
+				fprintf(stderr, "could not read %s\n", arg);
+				return 1;
+			}
+			saves.push_back(save);
+		}
+	}
+
+	if (axes.empty() || (seedCount == 0 && saves.empty()))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// every combination of the axis values, the last axis changing fastest
+	std::vector<SimParams> combinations(1, DefaultSimParams);
+	for (const SweepAxis& axis : axes)
+	{
+		std::vector<SimParams> expanded;
+		for (const SimParams& params : combinations)
+		{
+			for (const int32_t value : axis.values)
+			{
+				SimParams next = params;
+				*(int32_t*)((uint8_t*)&next + axis.param->offset) = value;
+				expanded.push_back(next);
+			}
+		}
+		combinations.swap(expanded);
+	}
+	for (const SimParams& params : combinations)
+	{
+		if (!CheckDisasterTimes(params))
+		{
+			return 1;
+		}
+	}
+
+	const uint32_t citiesPerCombination = seedCount + saves.size();
+	std::vector<CitySummary> summaries((size_t)combinations.size() * citiesPerCombination);
+	std::vector<uint8_t> loaded(summaries.size(), 0);
+
+	InitHeadless();
+
+	const auto start = std::chrono::steady_clock::now();
+	RunJobs(summaries.size(), threads, [&](const uint32_t job, const uint32_t worker)
+	{
+		const SimParams& params = combinations[job / citiesPerCombination];
+		const uint32_t index = job % citiesPerCombination;
+		CityContext city;
+
+		ResetScratchArena();
+		if (index < seedCount)
+		{
+			GenerateCity(city, firstSeed + index, params);
+			loaded[job] = 1;
+		}
+		else
+		{
+			loaded[job] = LoadSavedCity(city, saves[index - seedCount].data(), params);
+		}
+		if (loaded[job])
+		{
+			SimulateYears(city, years, summaries[job]);
+		}
+		FreeCityContext(city);
+	});
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (const SweepAxis& axis : axes)
+	{
+		printf("%s,", axis.param->name);
+	}
+	printf("cities,residential,commercial,industrial,funds,rubble,disasters,bankrupt\n");
+
+	for (size_t c = 0; c < combinations.size(); c++)
+	{
+		SweepResult result = {};
+		for (uint32_t n = 0; n < citiesPerCombination; n++)
+		{
+			const size_t job = c * citiesPerCombination + n;
+			if (!loaded[job])
+			{
+				continue;
+			}
+			const CitySummary& summary = summaries[job];
+			result.residential += summary.residentialPopulation;
+			result.commercial += summary.commercialPopulation;
+			result.industrial += summary.industrialPopulation;
+			result.money += summary.money;
+			result.rubble += summary.rubbleCount;
+			result.disasters += summary.disasters;
+			result.bankrupt += summary.money < 0 ? 1 : 0;
+			result.cities++;
+		}
+
+		for (const SweepAxis& axis : axes)
+		{
+			printf("%d,", *(const int32_t*)((const uint8_t*)&combinations[c] + axis.param->offset));
+		}
+		const double cities = result.cities > 0 ? result.cities : 1;
+		printf("%u,%.1f,%.1f,%.1f,%.0f,%.2f,%.2f,%.3f\n", result.cities, result.residential / cities, result.commercial / cities,
+			result.industrial / cities, result.money / cities, result.rubble / cities, result.disasters / cities, result.bankrupt / cities);
+	}
+
+	fprintf(stderr, "%u combinations x %u cities x %u years in %.3fs on %u threads: %.1f cities/s\n", (uint32_t)combinations.size(),
+		citiesPerCombination, years, seconds, threads < summaries.size() ? threads : (uint32_t)summaries.size(), summaries.size() / seconds);
+	return 0;
+}
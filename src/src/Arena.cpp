@@ -0,0 +1,76 @@
+#include "Arena.h"
+#include "wasm4.h"
+#include "wasmmalloc.h"
+#include "global.h"
+
+// the first 6560 bytes are used by the WASM-4 runtime (registers and framebuffer), see --global-base in the Makefile
+#define RUNTIME_RESERVED_SIZE 6560
+#define STACK_SIZE 3072
+#define MEMORY_SIZE 65536
+
+THREAD_LOCAL uint8_t ScratchArena[SCRATCH_ARENA_SIZE];
+THREAD_LOCAL size_t ScratchUsed = 0;
+THREAD_LOCAL size_t ScratchHighWaterMark = 0;
+size_t TracedScratchHighWaterMark = 0;
+size_t TracedHeapHighWaterMark = 0;
+
+void* ScratchAlloc(const size_t size)
+{
+	// keep allocations 4 byte aligned
+	const size_t start = (ScratchUsed + 3) & ~(size_t)3;
+	if (start + size > SCRATCH_ARENA_SIZE)
+	{
+		return nullptr;
+	}
+
+	ScratchUsed = start + size;
+	if (ScratchUsed > ScratchHighWaterMark)
+	{
+		ScratchHighWaterMark = ScratchUsed;
+	}
+	return &ScratchArena[start];
+}
+
+size_t ScratchMark()
+{
+	return ScratchUsed;
+}
+
+void ScratchRelease(const size_t mark)
+{
+	if (mark < ScratchUsed)
+	{
+		ScratchUsed = mark;
+	}
+}
+
+void ResetScratchArena()
+{
+	ScratchUsed = 0;
+}
+
+#ifndef NATIVE_BUILD
+extern "C" uint8_t __data_end;
+extern "C" uint8_t __heap_base;
+
+void TraceMemoryMap()
+{
+	const int dataSize = (int)((size_t)&__data_end - RUNTIME_RESERVED_SIZE);
+	const int heapUsed = (int)GetHeapHighWaterMark();
+	const int heapEnd = (int)(size_t)&__heap_base + heapUsed;
+
+	tracef("memory: runtime %d, static data %d (scratch arena %d), stack %d", RUNTIME_RESERVED_SIZE, dataSize, SCRATCH_ARENA_SIZE, (int)((size_t)&__heap_base - (size_t)&__data_end));
+	tracef("memory: heap %d, scratch high water %d, free %d of %d", heapUsed, (int)ScratchHighWaterMark, MEMORY_SIZE - heapEnd, MEMORY_SIZE);
+
+	TracedScratchHighWaterMark = ScratchHighWaterMark;
+	TracedHeapHighWaterMark = heapUsed;
+}
+
+void TraceMemoryHighWaterMarks()
+{
+	if (ScratchHighWaterMark != TracedScratchHighWaterMark || GetHeapHighWaterMark() != TracedHeapHighWaterMark)
+	{
+		TraceMemoryMap();
+	}
+}
+#endif
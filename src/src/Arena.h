@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scratch memory for short lived buffers (save/load buffers, export lines), so nothing is allocated on the heap per call
+// Everything in it is released at the start of every frame, or earlier by going back to a mark
+#define SCRATCH_ARENA_SIZE 6144
+
+// Returns nullptr if there isn't enough room left
+void* ScratchAlloc(const size_t size);
+size_t ScratchMark();
+void ScratchRelease(const size_t mark);
+void ResetScratchArena();
+
+// Traces where the 64KB of memory goes - runtime reserved, static data, stack, heap, scratch arena and what's left
+void TraceMemoryMap();
+// Traces the memory map again if the heap or scratch arena have grown since it was last traced
+void TraceMemoryHighWaterMarks();
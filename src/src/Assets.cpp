@@ -0,0 +1,58 @@
+#include "Assets.h"
+#include "Arena.h"
+
+typedef struct
+{
+	uint16_t offset;		// into PackedAssetData
+	uint16_t size;			// unpacked size
+} PackedAsset;
+
+#include "PackedAssets.inc.h"
+
+static_assert(sizeof(PackedAssets) / sizeof(PackedAssets[0]) == Num_Assets, "PackedAssets.inc.h is out of date, run tools/packassets.py");
+
+uint16_t GetAssetSize(const uint8_t asset)
+{
+	return asset < Num_Assets ? PackedAssets[asset].size : 0;
+}
+
+const uint8_t* UnpackAsset(const uint8_t asset)
+{
+	if(asset >= Num_Assets)
+	{
+		return nullptr;
+	}
+
+	const uint16_t size = PackedAssets[asset].size;
+	uint8_t *data = (uint8_t *)ScratchAlloc(size);
+	if(data == nullptr)
+	{
+		return nullptr;
+	}
+
+	// PackBits - header n < 128 is followed by n+1 literal bytes, n > 128 by a byte repeated 257-n times
+	const uint8_t *in = &PackedAssetData[PackedAssets[asset].offset];
+	uint8_t *out = data;
+	uint8_t *end = data + size;
+	while(out < end)
+	{
+		const uint8_t n = *in++;
+		if(n < 128)
+		{
+			for(int32_t i = 0; i <= n; i++)
+			{
+				*out++ = *in++;
+			}
+		}
+		else if(n > 128)
+		{
+			const uint8_t val = *in++;
+			for(int32_t i = 0; i < 257 - n; i++)
+			{
+				*out++ = val;
+			}
+		}
+	}
+
+	return data;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+// Static assets kept PackBits packed in the cart (see tools/packassets.py), in the same order as the packer's list
+enum AssetId
+{
+	Asset_Terrain1,
+	Asset_Terrain2,
+	Asset_Terrain3,
+	Asset_Terrain4,
+	Asset_Terrain5,
+	Asset_Logo,
+	Asset_DemoCity,
+	Asset_CoastalScenario,
+	Asset_RuralScenario,
+	Asset_RevitalizeScenario,
+	Asset_IslandScenario,
+	Num_Assets,
+	Asset_None = 0xff
+};
+
+uint16_t GetAssetSize(const uint8_t asset);
+// Expands an asset into the scratch arena, returns nullptr if there isn't room
+// The data is valid until the scratch arena is released back past it, so callers take a ScratchMark() first
+const uint8_t* UnpackAsset(const uint8_t asset);
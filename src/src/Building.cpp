@@ -1,7 +1,10 @@
 #include "Game.h"
 #include "Building.h"
 #include "Connectivity.h"
-#include "Draw.h"
+#include "WorldEvents.h"
+#include "Snapshot.h"
+#include "wasmmalloc.h"
+#include "wasmmemcpy.h"
 
 const BuildingInfo BuildingMetaData[] =
 {
@@ -34,13 +37,14 @@ const BuildingInfo* GetBuildingInfo(uint8_t buildingType)
 	return &BuildingMetaData[buildingType];
 }
 
-bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
+bool PlaceBuilding(CityContext& city, uint8_t buildingType, uint8_t x, uint8_t y)
 {
+	GameState& state = city.state;
 	int index = 0;
 
 	while (index < MAX_BUILDINGS)
 	{
-		if (State.buildings[index].type == 0)
+		if (state.buildings[index].type == 0)
 		{
 			break;
 		}
@@ -54,7 +58,7 @@ bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 
 		while (index < MAX_BUILDINGS)
 		{
-			if (State.buildings[index].type == Rubble3x3 || State.buildings[index].type == Rubble4x4)
+			if (state.buildings[index].type == Rubble3x3 || state.buildings[index].type == Rubble4x4)
 			{
 				break;
 			}
@@ -67,7 +71,13 @@ bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 		}
 	}
 
-	Building* newBuilding = &State.buildings[index];
+	Building* newBuilding = &state.buildings[index];
+	SnapshotBeforeWrite(city, newBuilding, sizeof(Building));
+	if (newBuilding->type)
+	{
+		// replacing rubble
+		PostBuildingEvent(city, WorldEvent_BuildingRemoved, newBuilding);
+	}
 	newBuilding->type = buildingType;
 	newBuilding->x = x;
 	newBuilding->y = y;
@@ -85,14 +95,14 @@ bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 	{
 		for (int j = y; j < y + height; j++)
 		{
-			SetConnections(i, j, connectionMask);
+			SetConnections(city, i, j, connectionMask);
 		}
 	}
 
 	// Check for overlapping rubble and remove
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		Building* building = &State.buildings[n];
+		Building* building = &state.buildings[n];
 
 		if (IsRubble(building->type))
 		{
@@ -103,18 +113,21 @@ bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 			if (x + width > building->x && x < building->x + otherWidth
 				&& y + height > building->y && y < building->y + otherHeight)
 			{
+				PostBuildingEvent(city, WorldEvent_BuildingRemoved, building);
+				SnapshotBeforeWrite(city, building, sizeof(Building));
 				building->type = 0;
 			}
 		}
 	}
 
-	RefreshBuildingTiles(newBuilding);
+	PostBuildingEvent(city, WorldEvent_BuildingPlaced, newBuilding);
 
 	return true;
 }
 
-bool CanPlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
+bool CanPlaceBuilding(CityContext& city, uint8_t buildingType, uint8_t x, uint8_t y)
 {
+	const GameState& state = city.state;
 	const BuildingInfo* metadata = GetBuildingInfo(buildingType);
 	uint8_t width = metadata->width;
 	uint8_t height = metadata->height;
@@ -130,10 +143,10 @@ bool CanPlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 		for (int j = y; j < y + height; j++)
 		{
 			// Check terrain is not water
-			if (IsTerrainClear(i, j) == false)
+			if (IsTerrainClear(state.terrainType, i, j) == false)
 				return false;
 
-			if (GetConnections(i, j) & RoadMask)
+			if (GetConnections(city, i, j) & RoadMask)
 				return false;
 		}
 	}
@@ -141,7 +154,7 @@ bool CanPlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 	// Check building overlaps
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		Building* building = &State.buildings[n];
+		const Building* building = &state.buildings[n];
 
 		if (building->type && !IsRubble(building->type))
 		{
@@ -161,11 +174,128 @@ bool CanPlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y)
 	return true;
 }
 
-Building* GetBuilding(uint8_t x, uint8_t y)
+// Which building covers each tile, as an index + 1 into the city's buildings (0 for none)
+// Allocated the first time it's needed, then kept up to date by the building world events
+void CalculateBuildingOwnerMap(CityContext& city)
+{
+	const GameState& state = city.state;
+	uint8_t* owners = city.buildingOwnerMap;
+	memset(owners, 0, MAP_WIDTH * MAP_HEIGHT);
+
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		const Building* building = &state.buildings[n];
+
+		if (building->type)
+		{
+			const BuildingInfo* metadata = GetBuildingInfo(building->type);
+
+			for (int y = building->y; y < building->y + metadata->height && y < MAP_HEIGHT; y++)
+			{
+				for (int x = building->x; x < building->x + metadata->width && x < MAP_WIDTH; x++)
+				{
+					// the first building wins, the same as searching the building list
+					if (owners[y * MAP_WIDTH + x] == 0)
+					{
+						owners[y * MAP_WIDTH + x] = n + 1;
+					}
+				}
+			}
+		}
+	}
+
+	city.buildingOwnerMapDirty = false;
+}
+
+void SetBuildingOwner(uint8_t* owners, const Building* building, uint8_t from, uint8_t to)
+{
+	const BuildingInfo* metadata = GetBuildingInfo(building->type);
+
+	for (int y = building->y; y < building->y + metadata->height && y < MAP_HEIGHT; y++)
+	{
+		for (int x = building->x; x < building->x + metadata->width && x < MAP_WIDTH; x++)
+		{
+			if (owners[y * MAP_WIDTH + x] == from)
+			{
+				owners[y * MAP_WIDTH + x] = to;
+			}
+		}
+	}
+}
+
+void OnBuildingWorldEvent(const WorldEvent& event)
+{
+	CityContext& city = *event.city;
+
+	// not allocated yet, it will be built from scratch when first used
+	if (city.buildingOwnerMap == nullptr)
+	{
+		return;
+	}
+
+	const uint8_t owner = event.building ? (event.building - city.state.buildings) + 1 : 0;
+	switch (event.type)
+	{
+	case WorldEvent_BuildingPlaced:
+		SetBuildingOwner(city.buildingOwnerMap, event.building, 0, owner);
+		break;
+	case WorldEvent_BuildingRemoved:
+		SetBuildingOwner(city.buildingOwnerMap, event.building, owner, 0);
+		break;
+	case WorldEvent_MapReset:
+		city.buildingOwnerMapDirty = true;
+		break;
+	}
+}
+
+void RegisterBuildingListeners()
+{
+	AddWorldEventListener(WorldEvent_BuildingPlaced, OnBuildingWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingRemoved, OnBuildingWorldEvent);
+	AddWorldEventListener(WorldEvent_MapReset, OnBuildingWorldEvent);
+}
+
+const uint8_t* GetBuildingOwnerMap(CityContext& city)
+{
+	if (city.buildingOwnerMap == nullptr)
+	{
+		city.buildingOwnerMap = (uint8_t*)malloc(MAP_WIDTH * MAP_HEIGHT);
+		if (city.buildingOwnerMap == nullptr)
+		{
+			return nullptr;
+		}
+		CalculateBuildingOwnerMap(city);
+	}
+	else if (city.buildingOwnerMapDirty)
+	{
+		CalculateBuildingOwnerMap(city);
+	}
+
+	return city.buildingOwnerMap;
+}
+
+const uint8_t* GetBuildingOwnerMap()
 {
+	return GetBuildingOwnerMap(MainCity);
+}
+
+Building* GetBuilding(CityContext& city, uint8_t x, uint8_t y)
+{
+	GameState& state = city.state;
+	const uint8_t* owners = GetBuildingOwnerMap(city);
+	if (owners != nullptr)
+	{
+		if (x >= MAP_WIDTH || y >= MAP_HEIGHT)
+		{
+			return nullptr;
+		}
+		const uint8_t owner = owners[y * MAP_WIDTH + x];
+		return owner ? &state.buildings[owner - 1] : nullptr;
+	}
+
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		Building* building = &State.buildings[n];
+		Building* building = &state.buildings[n];
 
 		if (building->type)
 		{
@@ -183,7 +313,12 @@ Building* GetBuilding(uint8_t x, uint8_t y)
 	return nullptr;
 }
 
-void DestroyBuilding(Building* building)
+Building* GetBuilding(uint8_t x, uint8_t y)
+{
+	return GetBuilding(MainCity, x, y);
+}
+
+void DestroyBuilding(CityContext& city, Building* building)
 {
 	const BuildingInfo* info = GetBuildingInfo(building->type);
 	uint8_t width = info->width;
@@ -193,20 +328,14 @@ void DestroyBuilding(Building* building)
 	{
 		for (int x = building->x; x < building->x + width; x++)
 		{
-			SetConnections(x, y, 0);
+			SetConnections(city, x, y, 0);
 		}
 	}
 
+	SnapshotBeforeWrite(city, building, sizeof(Building));
 	building->onFire = 0;
 	building->type = width == 3 ? Rubble3x3 : Rubble4x4;
-
-	for (uint8_t y = building->y; y < building->y + height; y++)
-	{
-		for (uint8_t x = building->x; x < building->x + width; x++)
-		{
-			SetTile(x, y, RUBBLE_TILE);
-		}
-	}
+	PostBuildingEvent(city, WorldEvent_BuildingDestroyed, building);
 }
 
 uint8_t GetManhattanDistance(Building* a, Building* b)
@@ -45,9 +45,16 @@ typedef struct
 
 extern const BuildingInfo BuildingMetaData[];
 
-bool PlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y);
-bool CanPlaceBuilding(uint8_t buildingType, uint8_t x, uint8_t y);
+struct CityContext;
+
+bool PlaceBuilding(CityContext& city, uint8_t buildingType, uint8_t x, uint8_t y);
+bool CanPlaceBuilding(CityContext& city, uint8_t buildingType, uint8_t x, uint8_t y);
 const BuildingInfo* GetBuildingInfo(uint8_t buildingType);
-Building* GetBuilding(uint8_t x, uint8_t y);
-void DestroyBuilding(Building* building);
+Building* GetBuilding(CityContext& city, uint8_t x, uint8_t y);
+Building* GetBuilding(uint8_t x, uint8_t y);			// MainCity
+// MAP_WIDTH*MAP_HEIGHT building indices + 1 (0 for no building), nullptr if it couldn't be allocated
+const uint8_t* GetBuildingOwnerMap(CityContext& city);
+const uint8_t* GetBuildingOwnerMap();					// MainCity
+void RegisterBuildingListeners();
+void DestroyBuilding(CityContext& city, Building* building);
 uint8_t GetManhattanDistance(Building* a, Building* b);
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "Game.h"
+#include "WorldEvents.h"
+#include "wasmmemcpy.h"
+#include "wasmmalloc.h"
+
+CityContext MainCity = { {}, {}, true, nullptr, true, 0xABC, nullptr
+#ifdef NATIVE_BUILD
+	, &DefaultSimParams
+#endif
+};
+GameState& State = MainCity.state;
+uint32_t MapVersion = 0;
+uint32_t CityStatsVersion = 0;
+
+void InitGameState(GameState& state)
+{
+	memset(&state, 0, sizeof(GameState));
+
+	state.taxRate = STARTING_TAX_RATE;
+	state.timeToNextDisaster = MAX_TIME_BETWEEN_DISASTERS;
+	state.money = STARTING_FUNDS;
+}
+
+void InitCityContext(CityContext& city)
+{
+	memset(&city, 0, sizeof(CityContext));
+	InitGameState(city.state);
+	city.powerGridDirty = true;
+	city.buildingOwnerMapDirty = true;
+	city.randVal = 0xABC;
+#ifdef NATIVE_BUILD
+	city.simParams = &DefaultSimParams;
+#endif
+}
+
+void FreeCityContext(CityContext& city)
+{
+	if (city.buildingOwnerMap != nullptr)
+	{
+		free(city.buildingOwnerMap);
+		city.buildingOwnerMap = nullptr;
+	}
+	city.buildingOwnerMapDirty = true;
+}
+
+void OnGameWorldEvent(const WorldEvent& event)
+{
+	if (event.city != &MainCity)
+	{
+		return;
+	}
+	// these come from the simulation every tick, so they don't make the map or routes over it rebuild
+	if (event.type == WorldEvent_DensityChanged || event.type == WorldEvent_TrafficChanged || event.type == WorldEvent_PowerChanged)
+	{
+		CityStatsVersion++;
+	}
+	else
+	{
+		MapVersion++;
+	}
+}
+
+void RegisterGameListeners()
+{
+	AddWorldEventListenerToAll(OnGameWorldEvent);
+}
+
+uint16_t GetRandFromSeed(uint16_t randVal)
+{
+	uint16_t lsb = randVal & 1;
+	randVal >>= 1;
+	if (lsb == 1)
+		randVal ^= 0xB400u;
+
+	return randVal;
+}
+
+uint16_t GetRand(CityContext& city)
+{
+	city.randVal = GetRandFromSeed(city.randVal);
+
+	return city.randVal - 1;
+}
+
+uint16_t GetRand()
+{
+	return GetRand(MainCity);
+}
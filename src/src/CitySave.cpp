@@ -0,0 +1,254 @@
+#include "CitySave.h"
+#include "Assets.h"
+#include "Arena.h"
+#include "WorldEvents.h"
+#include "Snapshot.h"
+#include "wasmmemcpy.h"
+
+/*
+  TODO - save/load - don't need to save building heavyTraffic or hasPower (they can be calculated when loaded)
+  First sort buildings so that pos index ((y*mapwidth) + x) is in order
+  Also change storing x,y pos to offset array index pos.  Can use building type 0 when needed to adjust current x,y pos
+
+  0   - 4 bits for building type 0      (building type 0 will only use 16 bits)
+  x   - 6 bits for x pos
+  y   - 6 bits for y pos
+  #   - 4 bits for real building type   (then add as many real buildings as needed with their data) (real building can fit in 16 bits)
+  off - 6 bits for offset from previous building x,y (wrap around on map width)
+  d   - 4 bits for population density
+  f   - 2 bits for on fire
+*/
+
+template<typename T>
+void WriteVal(uint8_t *buff, int32_t &pos, T val)
+{
+  for(int32_t shift=(sizeof(T)-1)*8; shift>=0; shift-=8)
+  {
+    buff[pos]=((val >> shift) & 0xff);
+    pos++;
+  }
+}
+
+template<typename T>
+void ReadVal(const uint8_t *buff, int32_t &pos, T &val)
+{
+  val=0;
+  for(int32_t shift=(sizeof(T)-1)*8; shift>=0; shift-=8)
+  {
+    val|=(static_cast<T>(buff[pos]) << shift);
+    pos++;
+  }
+}
+
+void SortBuildingsByPosIndex(GameState &state)
+{
+  // simple bubble sort
+  for(int i=1; i<MAX_BUILDINGS; i++)
+  {
+    for(int j=0; j<MAX_BUILDINGS-i; j++)
+    {
+      bool swap=false;
+      if(state.buildings[j+1].type!=BuildingType_None && state.buildings[j].type==BuildingType_None)
+      {
+          swap=true;
+      }
+      else if(state.buildings[j].type!=BuildingType_None && state.buildings[j+1].type!=BuildingType_None)
+      {
+        const int32_t pos1=((state.buildings[j].y * MAP_WIDTH) + state.buildings[j].x);
+        const int32_t pos2=((state.buildings[j+1].y * MAP_WIDTH) + state.buildings[j+1].x);
+        if(pos2<pos1)
+        {
+          swap=true;
+        }
+      }
+      if(swap==true)
+      {
+        Building b=state.buildings[j];
+        state.buildings[j]=state.buildings[j+1];
+        state.buildings[j+1]=b;
+      }
+    }
+  }
+}
+
+typedef struct
+{
+  uint16_t type : 4;
+  uint16_t x : 6;
+  uint16_t y : 6;
+} SaveAbsolutePos;
+
+typedef struct
+{
+  uint8_t type : 4;
+  uint8_t populationDensity : 4;
+  uint8_t onFire : 2;
+  uint8_t posoffset : 6;
+} SaveBuilding;
+
+int32_t SaveCityToBuffer(CityContext &city, uint8_t *buff, const bool withheader)
+{
+  GameState &state=city.state;
+  int32_t pos=0;
+
+  if(withheader==true)
+  {
+    buff[pos++]='C';
+    buff[pos++]='T';
+    buff[pos++]='Y';
+    buff[pos++]='3';
+  }
+
+  const size_t len=(uint8_t *)&(state.buildings)-(uint8_t *)&(state.year);
+  memcpy((void *)&buff[pos],(void *)&(state.year),len);
+  pos+=len;
+
+  // save buildings
+  // first sort buildings by pos index ((y*mapwidth)+x)
+  // empty building slots are now at end of array, so first empty building we get to we can stop
+  SnapshotBeforeWrite(city,state.buildings,sizeof(state.buildings));
+  SortBuildingsByPosIndex(state);
+  // buildings have moved to different slots
+  PostMapReset(city);
+  int32_t lastposidx=0;
+  int32_t bi=0;
+  for(int i=0; i<MAX_BUILDINGS; i++)
+  {
+    if(state.buildings[bi].type!=BuildingType_None)
+    {
+      const int32_t posidx=((state.buildings[bi].y * MAP_WIDTH) + state.buildings[bi].x);
+      int32_t posdiff=posidx-lastposidx;
+      if(posdiff>63)
+      {
+        // must insert absolute position
+        SaveAbsolutePos ap;
+        ap.type=BuildingType_None;
+        ap.x=state.buildings[bi].x;
+        ap.y=state.buildings[bi].y;
+        memcpy((void *)&buff[pos],(void *)&ap,2);
+        pos+=2;
+        posdiff=0;
+      }
+      SaveBuilding sb;
+      sb.type=state.buildings[bi].type;
+      sb.populationDensity=state.buildings[bi].populationDensity;
+      sb.onFire=state.buildings[bi].onFire;
+      sb.posoffset=static_cast<uint8_t>(posdiff);
+      memcpy((void *)&buff[pos],(void *)&sb,2);
+      pos+=2;
+
+      lastposidx=posidx;
+      bi++;
+
+    }
+    else
+    {
+      uint16_t val=~0;        // 0xffff signifies end of building list
+      WriteVal(buff,pos,val);
+      i=MAX_BUILDINGS;        // only empty building slots remaining so skip writing them
+    }
+  }
+
+  return pos;
+}
+
+bool LoadCityFromBuffer(CityContext &city, const uint8_t *buff, const bool withheader)
+{
+  GameState &state=city.state;
+  int32_t pos=0;
+
+  if(withheader==true)
+  {
+    if(buff[pos++]!='C' || buff[pos++]!='T' || buff[pos++]!='Y' || buff[pos++]!='3')
+    {
+      return false;
+    }
+  }
+
+  SnapshotBeforeWrite(city,&state,sizeof(GameState));
+  const size_t len=(uint8_t *)&(state.buildings)-(uint8_t *)&(state.year);
+  memcpy((void *)&(state.year),(void *)&buff[pos],len);
+  pos+=len;
+
+  // load buildings
+  constexpr uint16_t endval=~0;   // end of buildings (either we get this marker, or we read the max number of buildings)
+  int32_t lastx=0;
+  int32_t lasty=0;
+  for(int i=0; i<MAX_BUILDINGS; i++)
+  {
+    uint16_t val=0;
+    ReadVal(buff,pos,val);
+
+    if(val!=endval)
+    {
+      SaveBuilding sb;
+      memcpy((void *)&sb,(void *)&buff[pos-2],2);
+
+      if(sb.type==BuildingType_None)
+      {
+        SaveAbsolutePos sp;
+        memcpy((void *)&sp,(void *)&buff[pos-2],2);
+        lastx=sp.x;
+        lasty=sp.y;
+
+        // read the next val for the actual building data
+        memcpy((void *)&sb,(void *)&buff[pos],2);
+        pos+=2;
+      }
+
+      state.buildings[i].type=sb.type;
+      state.buildings[i].populationDensity=sb.populationDensity;
+      state.buildings[i].onFire=sb.onFire;
+
+      lastx+=sb.posoffset;
+      while(lastx>MAP_WIDTH)
+      {
+        lastx-=MAP_WIDTH;
+        lasty++;
+      }
+
+      state.buildings[i].x=lastx;
+      state.buildings[i].y=lasty;
+
+    }
+    else    // populate the remaining building slots with none
+    {
+      for(i; i<MAX_BUILDINGS; i++)
+      {
+        state.buildings[i].type=BuildingType_None;
+      }
+    }
+  }
+
+  // every building may have moved
+  PostMapReset(city);
+
+  return true;
+}
+
+void UpdateLoadedCity(CityContext &city)
+{
+  CalculatePowerConnectivity(city);
+  for(int i=0; i<MAX_BUILDINGS; i++)
+  {
+    Building &building=city.state.buildings[i];
+    if(building.type!=BuildingType_None && !building.onFire && building.hasPower)
+    {
+      SnapshotBeforeWrite(city,&building,sizeof(Building));
+      building.heavyTraffic = building.populationDensity > SIM_PARAM(city, heavyTrafficThreshold);
+    }
+  }
+}
+
+bool LoadCityFromAsset(CityContext &city, const uint8_t asset)
+{
+  const size_t mark=ScratchMark();
+  const uint8_t *citydata=UnpackAsset(asset);
+  const bool loaded=citydata!=nullptr && LoadCityFromBuffer(city,citydata,false);
+  ScratchRelease(mark);
+  if(loaded==true)
+  {
+    UpdateLoadedCity(city);
+  }
+  return loaded;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+#include "Game.h"
+
+// Compact save format for a city, used for the disk save and the packed scenario assets
+// Saving sorts the buildings by position, buffer must be 1024 bytes
+int32_t SaveCityToBuffer(CityContext &city, uint8_t *buff, const bool withheader);
+bool LoadCityFromBuffer(CityContext &city, const uint8_t *buff, const bool withheader);
+// Works out what isn't saved (power, traffic) after a city has been loaded
+void UpdateLoadedCity(CityContext &city);
+// Loads one of the city assets (demo city or a scenario), including UpdateLoadedCity()
+bool LoadCityFromAsset(CityContext &city, const uint8_t asset);
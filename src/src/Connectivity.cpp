@@ -1,16 +1,18 @@
 #include "Game.h"
 #include "Connectivity.h"
 #include "Building.h"
+#include "WorldEvents.h"
+#include "Snapshot.h"
+#include "wasmmemcpy.h"
 
-void PowerFloodFill(uint8_t x, uint8_t y);
-uint8_t* GetPowerGrid();
+void PowerFloodFill(CityContext& city, uint8_t x, uint8_t y);
 
-uint8_t GetConnections(int x, int y)
+uint8_t GetConnections(const CityContext& city, int x, int y)
 {
 	if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT)
 	{
 		int index = y * MAP_WIDTH + x;
-		uint8_t mapVal = State.connectionMap[index >> 2];
+		uint8_t mapVal = city.state.connectionMap[index >> 2];
 		int shift = 2 * (index & 3);
 		return (mapVal >> shift) & 3;
 	}
@@ -18,16 +20,36 @@ uint8_t GetConnections(int x, int y)
 	return 0;
 }
 
-void SetConnections(int x, int y, uint8_t newVal)
+uint8_t GetConnections(int x, int y)
+{
+	return GetConnections(MainCity, x, y);
+}
+
+bool SetConnectionsQuietly(CityContext& city, int x, int y, uint8_t newVal)
 {
+	uint8_t* connectionMap = city.state.connectionMap;
 	if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT)
 	{
 		int index = y * MAP_WIDTH + x;
 		int shift = 2 * (index & 3);
 
 		index >>= 2;
-		uint8_t oldVal = State.connectionMap[index] & (~(3 << shift));
-		State.connectionMap[index] = oldVal | (newVal << shift);
+		uint8_t oldVal = connectionMap[index] & (~(3 << shift));
+		if (connectionMap[index] != (oldVal | (newVal << shift)))
+		{
+			SnapshotBeforeWrite(city, &connectionMap[index], 1);
+			connectionMap[index] = oldVal | (newVal << shift);
+			return true;
+		}
+	}
+	return false;
+}
+
+void SetConnections(CityContext& city, int x, int y, uint8_t newVal)
+{
+	if (SetConnectionsQuietly(city, x, y, newVal))
+	{
+		PostTileConnectionChanged(city, x, y);
 	}
 }
 
@@ -44,24 +66,31 @@ enum
 	Neighbour_West = 8
 };
 
+// Whether the tile has mask, or will have once the tiles in planned (nullptr for none) are laid
+inline bool HasConnection(const CityContext& city, int x, int y, uint8_t mask, const uint8_t* planned)
+{
+	const int index = y * MAP_WIDTH + x;
+	return (GetConnections(city, x, y) & mask) || (planned != nullptr && (planned[index >> 3] & (1 << (index & 7))));
+}
+
 // Returns a 4 bit mask based on neighbouring connectivity
-uint8_t GetNeighbouringConnectivity(int x, int y, uint8_t mask)
+uint8_t GetNeighbouringConnectivity(const CityContext& city, int x, int y, uint8_t mask, const uint8_t* planned)
 {
 	uint8_t neighbourMask = 0;
 
-	if (y > 0 && (GetConnections(x, y - 1) & mask))
+	if (y > 0 && HasConnection(city, x, y - 1, mask, planned))
 	{
 		neighbourMask |= Neighbour_North;
 	}
-	if (x < MAP_WIDTH - 1 && (GetConnections(x + 1, y) & mask))
+	if (x < MAP_WIDTH - 1 && HasConnection(city, x + 1, y, mask, planned))
 	{
 		neighbourMask |= Neighbour_East;
 	}
-	if (y < MAP_HEIGHT - 1 && (GetConnections(x, y + 1) & mask))
+	if (y < MAP_HEIGHT - 1 && HasConnection(city, x, y + 1, mask, planned))
 	{
 		neighbourMask |= Neighbour_South;
 	}
-	if (x > 0 && (GetConnections(x - 1, y) & mask))
+	if (x > 0 && HasConnection(city, x - 1, y, mask, planned))
 	{
 		neighbourMask |= Neighbour_West;
 	}
@@ -69,31 +98,32 @@ uint8_t GetNeighbouringConnectivity(int x, int y, uint8_t mask)
 	return neighbourMask;
 }
 
-bool IsSuitableForBridgedTile(int x, int y, uint8_t mask)
+bool IsSuitableForBridgedTile(const CityContext& city, int x, int y, uint8_t mask, const uint8_t* planned)
 {
-	uint8_t neighbours = GetNeighbouringConnectivity(x, y, mask);
+	const uint8_t terrainType = city.state.terrainType;
+	uint8_t neighbours = GetNeighbouringConnectivity(city, x, y, mask, planned);
 	
 	if(neighbours == Neighbour_North || neighbours == Neighbour_East || neighbours == Neighbour_South || neighbours == Neighbour_West
 	|| neighbours == (Neighbour_North | Neighbour_South) || neighbours == (Neighbour_East | Neighbour_West))
 	{
 		if(neighbours & Neighbour_North)
 		{
-			if(!IsTerrainClear(x, y - 1) && (GetNeighbouringConnectivity(x, y - 1, mask) & (Neighbour_East | Neighbour_West)))
+			if(!IsTerrainClear(terrainType, x, y - 1) && (GetNeighbouringConnectivity(city, x, y - 1, mask, planned) & (Neighbour_East | Neighbour_West)))
 				return false;
 		}
 		if(neighbours & Neighbour_East)
 		{
-			if(!IsTerrainClear(x + 1, y) && (GetNeighbouringConnectivity(x + 1, y, mask) & (Neighbour_North | Neighbour_South)))
+			if(!IsTerrainClear(terrainType, x + 1, y) && (GetNeighbouringConnectivity(city, x + 1, y, mask, planned) & (Neighbour_North | Neighbour_South)))
 				return false;
 		}
 		if(neighbours & Neighbour_South)
 		{
-			if(!IsTerrainClear(x, y + 1) && (GetNeighbouringConnectivity(x, y + 1, mask) & (Neighbour_East | Neighbour_West)))
+			if(!IsTerrainClear(terrainType, x, y + 1) && (GetNeighbouringConnectivity(city, x, y + 1, mask, planned) & (Neighbour_East | Neighbour_West)))
 				return false;
 		}
 		if(neighbours & Neighbour_West)
 		{
-			if(!IsTerrainClear(x - 1, y) && (GetNeighbouringConnectivity(x - 1, y, mask) & (Neighbour_North | Neighbour_South)))
+			if(!IsTerrainClear(terrainType, x - 1, y) && (GetNeighbouringConnectivity(city, x - 1, y, mask, planned) & (Neighbour_North | Neighbour_South)))
 				return false;
 		}
 		
@@ -103,53 +133,94 @@ bool IsSuitableForBridgedTile(int x, int y, uint8_t mask)
 	return false;
 }
 
+bool IsSuitableForBridgedTile(const CityContext& city, int x, int y, uint8_t mask)
+{
+	return IsSuitableForBridgedTile(city, x, y, mask, nullptr);
+}
+
+bool IsSuitableForBridgedTile(int x, int y, uint8_t mask)
+{
+	return IsSuitableForBridgedTile(MainCity, x, y, mask, nullptr);
+}
+
 // Based on neighbouring tile types, get which visual tile to use
 int GetConnectivityTileVariant(int x, int y, uint8_t mask)
 {
-	uint8_t neighbours = GetNeighbouringConnectivity(x, y, mask);
+	uint8_t neighbours = GetNeighbouringConnectivity(MainCity, x, y, mask, nullptr);
 
 	return TileVariants[neighbours];
 }
 
-inline bool IsTilePowered(uint8_t x, uint8_t y)
+inline bool IsTilePowered(const CityContext& city, uint8_t x, uint8_t y)
 {
 	int index = y * MAP_WIDTH + x;
 	int mask = 1 << (index & 7);
-	uint8_t val = GetPowerGrid()[index >> 3];
+	uint8_t val = city.powerGrid[index >> 3];
 
 	return (val & mask) != 0;
 }
 
-inline void SetTilePowered(uint8_t x, uint8_t y)
+inline void SetTilePowered(CityContext& city, uint8_t x, uint8_t y)
 {
 	int index = y * MAP_WIDTH + x;
 	int mask = 1 << (index & 7);
-	GetPowerGrid()[index >> 3] |= mask;
+	city.powerGrid[index >> 3] |= mask;
 }
 
-void CalculatePowerConnectivity()
+uint8_t* GetPowerGrid()
 {
-	// Clear power from grid
-	for (int n = 0; n < MAP_WIDTH * MAP_HEIGHT / 8; n++)
+	return MainCity.powerGrid;
+}
+
+// The power grid only needs flood filling again after something that conducts power has changed
+void OnConnectivityWorldEvent(const WorldEvent& event)
+{
+	event.city->powerGridDirty = true;
+}
+
+void RegisterConnectivityListeners()
+{
+	AddWorldEventListener(WorldEvent_TileConnectionChanged, OnConnectivityWorldEvent);
+	AddWorldEventListener(WorldEvent_TileAreaChanged, OnConnectivityWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingPlaced, OnConnectivityWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingDestroyed, OnConnectivityWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingRemoved, OnConnectivityWorldEvent);
+	AddWorldEventListener(WorldEvent_MapReset, OnConnectivityWorldEvent);
+}
+
+void CalculatePowerConnectivity(CityContext& city)
+{
+	GameState& state = city.state;
+	if (!city.powerGridDirty)
 	{
-		GetPowerGrid()[n] = 0;
+		return;
 	}
+	city.powerGridDirty = false;
+
+	// Clear power from grid
+	memset(city.powerGrid, 0, MAP_WIDTH * MAP_HEIGHT / 8);
 
 	// Flood fill from power plants
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		if (State.buildings[n].type == Powerplant)
+		if (state.buildings[n].type == Powerplant)
 		{
-			PowerFloodFill(State.buildings[n].x, State.buildings[n].y);
+			PowerFloodFill(city, state.buildings[n].x, state.buildings[n].y);
 		}
 	}
 
 	// Set powered flags on buildings
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		if (State.buildings[n].type)
+		if (state.buildings[n].type)
 		{
-			State.buildings[n].hasPower = IsTilePowered(State.buildings[n].x, State.buildings[n].y);
+			const bool hasPower = IsTilePowered(city, state.buildings[n].x, state.buildings[n].y);
+			if (state.buildings[n].hasPower != hasPower)
+			{
+				SnapshotBeforeWrite(city, &state.buildings[n], sizeof(Building));
+				state.buildings[n].hasPower = hasPower;
+				PostBuildingEvent(city, WorldEvent_PowerChanged, &state.buildings[n]);
+			}
 		}
 	}
 }
@@ -170,48 +241,48 @@ enum
 };
 
 // If there is a powerline / building on this tile that hasn't been powered yet
-bool IsFillEmpty(uint8_t x, uint8_t y)
+bool IsFillEmpty(const CityContext& city, uint8_t x, uint8_t y)
 {
-	return (GetConnections(x, y) & PowerlineMask) != 0 && !IsTilePowered(x, y);
+	return (GetConnections(city, x, y) & PowerlineMask) != 0 && !IsTilePowered(city, x, y);
 }
 
-uint8_t GetFilledNeighbourCount(uint8_t x, uint8_t y)
+uint8_t GetFilledNeighbourCount(const CityContext& city, uint8_t x, uint8_t y)
 {
 	uint8_t count = 0;
 
-	if (x == 0 || !IsFillEmpty(x - 1, y))
+	if (x == 0 || !IsFillEmpty(city, x - 1, y))
 		count++;
-	if (x == MAP_WIDTH - 1 || !IsFillEmpty(x + 1, y))
+	if (x == MAP_WIDTH - 1 || !IsFillEmpty(city, x + 1, y))
 		count++;
-	if (y == 0 || !IsFillEmpty(x, y - 1))
+	if (y == 0 || !IsFillEmpty(city, x, y - 1))
 		count++;
-	if (y == MAP_HEIGHT - 1 || !IsFillEmpty(x, y + 1))
+	if (y == MAP_HEIGHT - 1 || !IsFillEmpty(city, x, y + 1))
 		count++;
 
 	return count;
 }
 
-bool IsFilledInDir(uint8_t x, uint8_t y, uint8_t dir)
+bool IsFilledInDir(const CityContext& city, uint8_t x, uint8_t y, uint8_t dir)
 {
 	switch (dir)
 	{
 	default:
 	case FILL_NORTH:
-		return y > 0 ? !IsFillEmpty(x, y - 1) : true;
+		return y > 0 ? !IsFillEmpty(city, x, y - 1) : true;
 	case FILL_NORTHEAST:
-		return y > 0 && x < MAP_WIDTH - 1 ? !IsFillEmpty(x + 1, y - 1) : true;
+		return y > 0 && x < MAP_WIDTH - 1 ? !IsFillEmpty(city, x + 1, y - 1) : true;
 	case FILL_EAST:
-		return x < MAP_WIDTH - 1 ? !IsFillEmpty(x + 1, y) : true;
+		return x < MAP_WIDTH - 1 ? !IsFillEmpty(city, x + 1, y) : true;
 	case FILL_SOUTHEAST:
-		return x < MAP_WIDTH - 1 && y < MAP_HEIGHT - 1 ? !IsFillEmpty(x + 1, y + 1) : true;
+		return x < MAP_WIDTH - 1 && y < MAP_HEIGHT - 1 ? !IsFillEmpty(city, x + 1, y + 1) : true;
 	case FILL_SOUTH:
-		return y < MAP_HEIGHT - 1 ? !IsFillEmpty(x, y + 1) : true;
+		return y < MAP_HEIGHT - 1 ? !IsFillEmpty(city, x, y + 1) : true;
 	case FILL_SOUTHWEST:
-		return x > 0 && y < MAP_HEIGHT - 1 ? !IsFillEmpty(x - 1, y + 1) : true;
+		return x > 0 && y < MAP_HEIGHT - 1 ? !IsFillEmpty(city, x - 1, y + 1) : true;
 	case FILL_WEST:
-		return x > 0 ? !IsFillEmpty(x - 1, y) : true;
+		return x > 0 ? !IsFillEmpty(city, x - 1, y) : true;
 	case FILL_NORTHWEST:
-		return x > 0 && y > 0 ? !IsFillEmpty(x - 1, y - 1) : true;
+		return x > 0 && y > 0 ? !IsFillEmpty(city, x - 1, y - 1) : true;
 	}
 }
 
@@ -259,7 +330,7 @@ void FillMoveForward(uint8_t* x, uint8_t* y, uint8_t dir)
 	}
 }
 
-void PowerFloodFill(uint8_t x, uint8_t y)
+void PowerFloodFill(CityContext& city, uint8_t x, uint8_t y)
 {
 	uint8_t fillDir = FILL_NORTH;
 	uint8_t mark1X = 0xff, mark1Y = 0xff, mark1Dir = FILL_NORTH;
@@ -269,7 +340,7 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 	bool findloop = false;
 
 	// Move to edge
-	while (y > 0 && IsFillEmpty(x, y - 1))
+	while (y > 0 && IsFillEmpty(city, x, y - 1))
 	{
 		y--;
 	}
@@ -281,11 +352,11 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 		FillMoveForward(&x, &y, fillDir);
 
 		// If right pixel is empty
-		if (IsFilledInDir(x, y, FillTurnRight(fillDir)) == false)
+		if (IsFilledInDir(city, x, y, FillTurnRight(fillDir)) == false)
 		{
 			if (backtrack && !findloop &&
-				(IsFilledInDir(x, y, fillDir) == false
-					|| IsFilledInDir(x, y, FillTurnLeft(fillDir)) == false))
+				(IsFilledInDir(city, x, y, fillDir) == false
+					|| IsFilledInDir(city, x, y, FillTurnLeft(fillDir)) == false))
 			{
 				findloop = true;
 			}
@@ -299,21 +370,21 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 		}
 
 	Fill_Start:
-		uint8_t filledNeighbourCount = GetFilledNeighbourCount(x, y);
+		uint8_t filledNeighbourCount = GetFilledNeighbourCount(city, x, y);
 		if (filledNeighbourCount == 4)
 		{
-			SetTilePowered(x, y);
+			SetTilePowered(city, x, y);
 			break;
 		}
 
 		do
 		{
 			fillDir = FillTurnRight(fillDir);
-		} while (IsFilledInDir(x, y, fillDir) == false);
+		} while (IsFilledInDir(city, x, y, fillDir) == false);
 		do
 		{
 			fillDir = FillTurnLeft(fillDir);
-		} while (IsFilledInDir(x, y, fillDir) != false);
+		} while (IsFilledInDir(city, x, y, fillDir) != false);
 
 		switch (filledNeighbourCount)
 		{
@@ -326,21 +397,21 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 			{
 				mark1Set = true;
 			}
-			else if (IsFilledInDir(x, y, FillFrontLeft(fillDir)) == false
-				&& IsFilledInDir(x, y, FillBackLeft(fillDir)) == false)
+			else if (IsFilledInDir(city, x, y, FillFrontLeft(fillDir)) == false
+				&& IsFilledInDir(city, x, y, FillBackLeft(fillDir)) == false)
 			{
 				mark1Set = false;
-				SetTilePowered(x, y);
+				SetTilePowered(city, x, y);
 				goto Fill_Paint;
 			}
 			break;
 		case 2:
-			if (IsFilledInDir(x, y, FillTurnAround(fillDir)) != false)
+			if (IsFilledInDir(city, x, y, FillTurnAround(fillDir)) != false)
 			{
-				if (IsFilledInDir(x, y, FillFrontLeft(fillDir)) == false)
+				if (IsFilledInDir(city, x, y, FillFrontLeft(fillDir)) == false)
 				{
 					mark1Set = false;
-					SetTilePowered(x, y);
+					SetTilePowered(city, x, y);
 					goto Fill_Paint;
 				}
 			}
@@ -364,7 +435,7 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 						{
 							mark1Set = false;
 							fillDir = FillTurnAround(fillDir);
-							SetTilePowered(x, y);
+							SetTilePowered(city, x, y);
 							goto Fill_Paint;
 						}
 						else
@@ -393,7 +464,7 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 						mark2Set = false;
 						backtrack = false;
 						fillDir = FillTurnAround(fillDir);
-						SetTilePowered(x, y);
+						SetTilePowered(city, x, y);
 						goto Fill_Paint;
 					}
 					else if (mark2Set && x == mark2X && y == mark2Y)
@@ -410,7 +481,7 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 			break;
 		case 3:
 			mark1Set = false;
-			SetTilePowered(x, y);
+			SetTilePowered(city, x, y);
 			goto Fill_Paint;
 			break;
 		default:
@@ -431,9 +502,9 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 	stackPtr--; px = *stackPtr; \
 	stackSize--;
 
-void PowerFloodFillNew(uint8_t x, uint8_t y)
+void PowerFloodFillNew(CityContext& city, uint8_t x, uint8_t y)
 {
-	uint8_t *grid = (uint8_t *)GetPowerGrid();
+	uint8_t *grid = city.powerGrid;
 	uint8_t *stackPtr = grid + (MAP_WIDTH * MAP_HEIGHT / 8);
 	uint8_t stackSize = 0;
 
@@ -442,18 +513,18 @@ void PowerFloodFillNew(uint8_t x, uint8_t y)
 	while(stackSize)
 	{
 		STACK_POP(x, y);
-		SetTilePowered(x, y);
-		if(x>0 && (GetConnections(x-1,y) & PowerlineMask) && !IsTilePowered(x-1,y))
+		SetTilePowered(city, x, y);
+		if(x>0 && (GetConnections(city, x-1,y) & PowerlineMask) && !IsTilePowered(city, x-1,y))
 		{
-			SetTilePowered(x-1,y);
+			SetTilePowered(city, x-1,y);
 			STACK_PUSH(x-1,y);
 		}
 	}
 }
 
-void PowerFloodFill(uint8_t x, uint8_t y)
+void PowerFloodFill(CityContext& city, uint8_t x, uint8_t y)
 {
-	uint8_t* grid = (uint8_t*)GetPowerGrid();
+	uint8_t* grid = city.powerGrid;
 	uint8_t* stackPtr = grid + (MAP_WIDTH * MAP_HEIGHT / 8);
 	uint8_t stackSize = 0;
 
@@ -464,18 +535,18 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 		STACK_POP(x, y);
 		int8_t y1 = y;
 
-		while (y1 >= 0 && (GetConnections(x, y1) & PowerlineMask) && !IsTilePowered(x, y1))
+		while (y1 >= 0 && (GetConnections(city, x, y1) & PowerlineMask) && !IsTilePowered(city, x, y1))
 		{
 			y1--;
 		}
 		y1++;
 		bool spanLeft = false;
 		bool spanRight = false;
-		while (y1 < MAP_HEIGHT && (GetConnections(x, y1) & PowerlineMask) && !IsTilePowered(x, y1))
+		while (y1 < MAP_HEIGHT && (GetConnections(city, x, y1) & PowerlineMask) && !IsTilePowered(city, x, y1))
 		{
-			SetTilePowered(x, y1);
+			SetTilePowered(city, x, y1);
 
-			bool canFillLeft = (GetConnections(x - 1, y1) & PowerlineMask) && !IsTilePowered(x - 1, y1);
+			bool canFillLeft = (GetConnections(city, x - 1, y1) & PowerlineMask) && !IsTilePowered(city, x - 1, y1);
 
 			if (!spanLeft && x > 0 && canFillLeft)
 			{
@@ -487,7 +558,7 @@ void PowerFloodFill(uint8_t x, uint8_t y)
 				spanLeft = false;
 			}
 
-			bool canFillRight = (GetConnections(x + 1, y1) & PowerlineMask) && !IsTilePowered(x + 1, y1);
+			bool canFillRight = (GetConnections(city, x + 1, y1) & PowerlineMask) && !IsTilePowered(city, x + 1, y1);
 
 			if (!spanRight && canFillRight)
 			{
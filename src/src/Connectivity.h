@@ -8,9 +8,18 @@ enum ConnectivityMask
 	PowerlineMask = 2
 };
 
-uint8_t GetConnections(int x, int y);
-void SetConnections(int x, int y, uint8_t newVal);
-void CalculatePowerConnectivity(void);
-int GetConnectivityTileVariant(int x, int y, uint8_t mask);
-bool IsSuitableForBridgedTile(int x, int y, uint8_t mask);
-uint8_t* GetPowerGrid();
+struct CityContext;
+
+uint8_t GetConnections(const CityContext& city, int x, int y);
+uint8_t GetConnections(int x, int y);		// MainCity
+void SetConnections(CityContext& city, int x, int y, uint8_t newVal);
+// Without posting an event, the caller posts one PostTileAreaChanged() for all the tiles it changed
+bool SetConnectionsQuietly(CityContext& city, int x, int y, uint8_t newVal);
+void CalculatePowerConnectivity(CityContext& city);
+void RegisterConnectivityListeners(void);
+int GetConnectivityTileVariant(int x, int y, uint8_t mask);		// MainCity
+bool IsSuitableForBridgedTile(const CityContext& city, int x, int y, uint8_t mask);
+// planned has a bit for each tile (y * MAP_WIDTH + x) that counts as having mask, to check a path before it's laid
+bool IsSuitableForBridgedTile(const CityContext& city, int x, int y, uint8_t mask, const uint8_t* planned);
+bool IsSuitableForBridgedTile(int x, int y, uint8_t mask);		// MainCity
+uint8_t* GetPowerGrid();		// MainCity
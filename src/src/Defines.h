@@ -31,6 +31,10 @@
 
 #define MAX_BUILDINGS 150
 
+// Keep the resolved tile of every map cell (about 2.5KB), so scrolling and exporting the city don't
+// have to calculate tiles. Set to 0 to calculate tiles as they become visible instead
+#define RESOLVED_TILE_LAYER 1
+
 // How long a button has to be held before the first event repeats
 #define INPUT_REPEAT_TIME 10
 
@@ -76,6 +80,9 @@
 
 #define NUM_TERRAIN_TYPES 6
 
+// How many rows of the random terrain are generated each frame in the new city menu
+#define TERRAIN_GENERATION_ROWS_PER_FRAME 4
+
 #define STARTING_TAX_RATE 7
 #define STARTING_FUNDS 10000
 
@@ -7,22 +7,52 @@
 #include "Defines.h"
 
 #include "wasmstring.h"
+#include "wasmmemcpy.h"
 #include "palette.h"
 #include "global.h"
 #include "scenario.h"
+#include "Surface.h"
+#include "Fields.h"
+#include "wasmmalloc.h"
+#include "WorldEvents.h"
 
+// Not packed with the other assets, see tools/packassets.py
 const uint8_t TileImageData[] =
 {
 #include "TileData.h"
 };
 
-#include "LogoBitmap.h"
+#include "Assets.h"
+#include "Arena.h"
 
 // Currently visible tiles are cached so they don't need to be recalculated between frames
+// The cache is a ring buffer indexed by map coordinates wrapped to the cache size, so when scrolling
+// tiles that stay on screen don't move and only the newly visible ones need calculating
 uint8_t VisibleTileCache[VISIBLE_TILES_X * VISIBLE_TILES_Y];
 int8_t CachedScrollX, CachedScrollY;
+
+inline int WrapVisibleTileCoord(int val, const int size)
+{
+	val %= size;
+	return val < 0 ? val + size : val;
+}
+
+// x and y are map coordinates
+inline uint8_t& GetVisibleTile(int x, int y)
+{
+	return VisibleTileCache[WrapVisibleTileCoord(y, VISIBLE_TILES_Y) * VISIBLE_TILES_X + WrapVisibleTileCoord(x, VISIBLE_TILES_X)];
+}
+
+inline bool IsTileInVisibleTileCache(int x, int y)
+{
+	return x >= CachedScrollX && y >= CachedScrollY && x < CachedScrollX + VISIBLE_TILES_X && y < CachedScrollY + VISIBLE_TILES_Y;
+}
 uint8_t AnimationFrame = 0;
 
+#ifdef DEBUG
+DrawCallCounters DrawCallCounts;
+#endif
+
 // A map of which tiles should be on fire when a building is on fire
 #define FIREMAP_SIZE 16
 const uint8_t FireMap[FIREMAP_SIZE] =
@@ -84,6 +114,27 @@ inline uint8_t GetProcAtTile(uint8_t x, uint8_t y)
 
 bool HasHighTraffic(int x, int y)
 {
+	// A tile has high traffic if a building with heavy traffic is on it or next to it
+	const uint8_t* owners = GetBuildingOwnerMap();
+	if (owners != nullptr)
+	{
+		for (int j = y - 1; j <= y + 1; j++)
+		{
+			for (int i = x - 1; i <= x + 1; i++)
+			{
+				if (i >= 0 && j >= 0 && i < MAP_WIDTH && j < MAP_HEIGHT)
+				{
+					const uint8_t owner = owners[j * MAP_WIDTH + i];
+					if (owner && State.buildings[owner - 1].heavyTraffic)
+					{
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
 	// First check for buildings
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
@@ -165,23 +216,10 @@ uint8_t CalculateTile(int x, int y)
 		return 0;
 
 	// First check for buildings
-	for (int n = 0; n < MAX_BUILDINGS; n++)
+	Building* building = GetBuilding(x, y);
+	if (building)
 	{
-		Building* building = &State.buildings[n];
-
-		if (building->type)
-		{
-			if (x < building->x || y < building->y)
-				continue;
-			const BuildingInfo* info = GetBuildingInfo(building->type);
-			uint8_t width = info->width;
-			uint8_t height = info->height;
-			uint8_t tile = info->drawTile;
-			if (x < building->x + width && y < building->y + height)
-			{
-				return CalculateBuildingTile(building, x - building->x, y - building->y);
-			}
-		}
+		return CalculateBuildingTile(building, x - building->x, y - building->y);
 	}
 
 	// Next check for roads / powerlines
@@ -216,6 +254,163 @@ uint8_t CalculateTile(int x, int y)
 	return GetTerrainTile(x, y);
 }
 
+#if RESOLVED_TILE_LAYER
+// MAP_WIDTH*MAP_HEIGHT resolved tiles followed by a dirty bit for each tile, allocated the first time it's used
+// Changes to the map mark the tiles they affect as dirty and they are recalculated when next read
+#define RESOLVED_TILE_DIRTY_OFFSET (MAP_WIDTH * MAP_HEIGHT)
+uint8_t* ResolvedTileLayer = nullptr;
+
+void InvalidateResolvedTile(int x, int y)
+{
+	if (ResolvedTileLayer != nullptr && x >= 0 && y >= 0 && x < MAP_WIDTH && y < MAP_HEIGHT)
+	{
+		const int index = y * MAP_WIDTH + x;
+		ResolvedTileLayer[RESOLVED_TILE_DIRTY_OFFSET + (index >> 3)] |= 1 << (index & 7);
+	}
+}
+
+void InvalidateResolvedTiles()
+{
+	if (ResolvedTileLayer != nullptr)
+	{
+		memset(&ResolvedTileLayer[RESOLVED_TILE_DIRTY_OFFSET], 0xff, MAP_WIDTH * MAP_HEIGHT / 8);
+	}
+}
+
+uint8_t* GetResolvedTileLayer()
+{
+	if (ResolvedTileLayer == nullptr)
+	{
+		ResolvedTileLayer = (uint8_t*)malloc(RESOLVED_TILE_DIRTY_OFFSET + (MAP_WIDTH * MAP_HEIGHT / 8));
+		if (ResolvedTileLayer != nullptr)
+		{
+			InvalidateResolvedTiles();
+		}
+	}
+	return ResolvedTileLayer;
+}
+
+uint8_t GetResolvedTile(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= MAP_WIDTH || y >= MAP_HEIGHT)
+		return 0;
+
+	uint8_t* layer = GetResolvedTileLayer();
+	if (layer == nullptr)
+	{
+		return CalculateTile(x, y);
+	}
+
+	const int index = y * MAP_WIDTH + x;
+	uint8_t* dirty = &layer[RESOLVED_TILE_DIRTY_OFFSET + (index >> 3)];
+	const uint8_t mask = 1 << (index & 7);
+	if (*dirty & mask)
+	{
+		layer[index] = CalculateTile(x, y);
+		*dirty &= ~mask;
+	}
+	return layer[index];
+}
+#else
+uint8_t GetResolvedTile(int x, int y)
+{
+	return CalculateTile(x, y);
+}
+
+void InvalidateResolvedTile(int x, int y)
+{
+}
+
+void InvalidateResolvedTiles()
+{
+}
+#endif
+
+// The building's tiles and the tiles around it, which show its traffic
+void InvalidateBuildingTiles(Building* building)
+{
+	const BuildingInfo* info = GetBuildingInfo(building->type);
+
+	for (int y = building->y - 1; y <= building->y + info->height; y++)
+	{
+		for (int x = building->x - 1; x <= building->x + info->width; x++)
+		{
+			InvalidateResolvedTile(x, y);
+		}
+	}
+}
+
+// Tiles in the resolved tile layer are marked to be recalculated when something they depend on changes
+// Only MainCity is drawn, events from any other city context are ignored
+void OnDrawWorldEvent(const WorldEvent& event)
+{
+	if (event.city != &MainCity)
+	{
+		return;
+	}
+
+	switch (event.type)
+	{
+	case WorldEvent_TileConnectionChanged:
+		// the tile and how its neighbours join up to it
+		InvalidateResolvedTile(event.x, event.y);
+		InvalidateResolvedTile(event.x - 1, event.y);
+		InvalidateResolvedTile(event.x + 1, event.y);
+		InvalidateResolvedTile(event.x, event.y - 1);
+		InvalidateResolvedTile(event.x, event.y + 1);
+		break;
+	case WorldEvent_TileAreaChanged:
+		// and a border of one tile for the neighbours
+		for (int y = event.y - 1; y <= event.y + event.height; y++)
+		{
+			for (int x = event.x - 1; x <= event.x + event.width; x++)
+			{
+				InvalidateResolvedTile(x, y);
+			}
+		}
+		break;
+	case WorldEvent_MapReset:
+		InvalidateResolvedTiles();
+		break;
+	case WorldEvent_BuildingRemoved:
+		InvalidateBuildingTiles(event.building);
+		break;
+	default:
+		// the simulation no longer touches the visible tiles itself
+		InvalidateBuildingTiles(event.building);
+		RefreshBuildingTiles(event.building);
+		break;
+	}
+}
+
+void RegisterDrawListeners()
+{
+	AddWorldEventListener(WorldEvent_TileConnectionChanged, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_TileAreaChanged, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingPlaced, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingDestroyed, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_BuildingRemoved, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_DensityChanged, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_FireStateChanged, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_TrafficChanged, OnDrawWorldEvent);
+	AddWorldEventListener(WorldEvent_MapReset, OnDrawWorldEvent);
+}
+
+uint8_t GetAnimatedTerrainTile(int x, int y)
+{
+	uint8_t tile = GetTerrainTile(x,y);
+
+	// same animation as GetCachedTile()
+
+	// Animate water tiles
+	if (tile >= FIRST_WATER_TILE && tile <= LAST_WATER_TILE)
+	{
+		tile = FIRST_WATER_TILE + ((tile - FIRST_WATER_TILE + (AnimationFrame >> 3)) & 3);
+	}
+
+	return tile;
+}
+
 inline uint8_t GetCachedTile(int x, int y)
 {
 	//// Uncomment to visualise power connectivity
@@ -234,7 +429,7 @@ inline uint8_t GetCachedTile(int x, int y)
 	////
 
 
-	uint8_t tile = VisibleTileCache[y * VISIBLE_TILES_X + x];
+	uint8_t tile = GetVisibleTile(x + CachedScrollX, y + CachedScrollY);
 
 	// Animate water tiles
 	if (tile >= FIRST_WATER_TILE && tile <= LAST_WATER_TILE)
@@ -261,65 +456,108 @@ inline uint8_t GetCachedTile(int x, int y)
 
 void ResetVisibleTileCache()
 {
+	// the whole map may have changed
+	PostMapReset(MainCity);
+
 	CachedScrollX = UIState.scrollX >> TILE_SIZE_SHIFT;
 	CachedScrollY = UIState.scrollY >> TILE_SIZE_SHIFT;
 
-	for (int y = 0; y < VISIBLE_TILES_Y; y++)
+	for (int y = CachedScrollY; y < CachedScrollY + VISIBLE_TILES_Y; y++)
 	{
-		for (int x = 0; x < VISIBLE_TILES_X; x++)
+		for (int x = CachedScrollX; x < CachedScrollX + VISIBLE_TILES_X; x++)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = CalculateTile(x + CachedScrollX, y + CachedScrollY);
+			GetVisibleTile(x, y) = GetResolvedTile(x, y);
 		}
 	}
 }
 
+// Each row of tiles is drawn as runs of neighbouring tiles with the same colors
+// The run's tile data is copied one after another into TileRunBuffer and drawn with a single rotated blit
+// (the rotated source is TILE_SIZE wide and TILE_SIZE*n tall, so on screen the tiles go left to right)
+uint8_t TileRunBuffer[VISIBLE_TILES_X * TILE_SIZE];
+
+// terrain drawn under a power line tile
+inline bool IsPowerlineOverTerrain(const uint8_t tile)
+{
+	return tile == FIRST_POWERLINE_BRIDGE_TILE || tile == (FIRST_POWERLINE_BRIDGE_TILE+1) || (tile >= FIRST_POWERLINE_TILE && tile < (FIRST_POWERLINE_TILE+11));
+}
+
+void DrawTileRun(int32_t x, int32_t y, int32_t length, uint8_t color)
+{
+	SetDrawColors(color);
+	blit(TileRunBuffer, x, y, TILE_SIZE, TILE_SIZE * length, BLIT_1BPP|BLIT_ROTATE);
+	COUNT_DRAW_CALL(Blits);
+}
+
 void DrawTiles()
 {
 	const int offsetX = UIState.scrollX & (TILE_SIZE - 1);
 	const int offsetY = UIState.scrollY & (TILE_SIZE - 1);
+	const int mapX = (UIState.scrollX - offsetX) / TILE_SIZE;
+	const int mapY = (UIState.scrollY - offsetY) / TILE_SIZE;
 	for(int tiley=0; tiley<VISIBLE_TILES_Y; tiley++)
 	{
+		const int drawY = (tiley*TILE_SIZE)-offsetY;
+		int runX = 0;
+		int runLength = 0;
+		uint8_t runColor = 0;
+
 		for(int tilex=0; tilex<VISIBLE_TILES_X; tilex++)
-		{			
+		{
 			uint8_t currentTile = GetCachedTile(tilex, tiley);
-			const uint8_t origTile = currentTile;
 
 			// TODO - 4 bit color tiles would solve this
-			// hack for black power lines over water (blit the base terrain tile - then overlay the black power lines)
-			if(currentTile == (FIRST_POWERLINE_BRIDGE_TILE) || currentTile == (FIRST_POWERLINE_BRIDGE_TILE+1))
+			// hack for power lines - draw the base terrain tile here and the power line over it afterwards
+			if(IsPowerlineOverTerrain(currentTile))
 			{
-				currentTile = GetAnimatedTerrainTile((UIState.scrollX-offsetX+(tilex*TILE_SIZE))/TILE_SIZE,(UIState.scrollY-offsetY+(tiley*TILE_SIZE))/TILE_SIZE);
+				currentTile = GetAnimatedTerrainTile(mapX+tilex,mapY+tiley);
 			}
-			// hack for drawing powerline over land with transparent background
-			else if(currentTile >= (FIRST_POWERLINE_TILE) && currentTile < (FIRST_POWERLINE_TILE+11))
+
+			const uint8_t color = GetTileColor(currentTile);
+			if(runLength > 0 && color != runColor)
+			{
+				DrawTileRun(runX, drawY, runLength, runColor);
+				runLength = 0;
+			}
+			if(runLength == 0)
 			{
-				currentTile = GetAnimatedTerrainTile((UIState.scrollX-offsetX+(tilex*TILE_SIZE))/TILE_SIZE,(UIState.scrollY-offsetY+(tiley*TILE_SIZE))/TILE_SIZE);
+				runX = (tilex*TILE_SIZE)-offsetX;
+				runColor = color;
 			}
 
-			const uint8_t color = GetTileColor(currentTile);
-			*DRAW_COLORS = color;
-			blit(GetTileData(currentTile),(tilex*TILE_SIZE)-offsetX,(tiley*TILE_SIZE)-offsetY,TILE_SIZE,TILE_SIZE,BLIT_1BPP|BLIT_ROTATE);
+			const uint8_t *data = GetTileData(currentTile);
+			uint8_t *dest = &TileRunBuffer[runLength * TILE_SIZE];
+			for(int i=0; i<TILE_SIZE; i++)
+			{
+				dest[i] = data[i];
+			}
+			runLength++;
+		}
+		DrawTileRun(runX, drawY, runLength, runColor);
+
+		// power lines over the terrain drawn above
+		for(int tilex=0; tilex<VISIBLE_TILES_X; tilex++)
+		{
+			const uint8_t origTile = GetCachedTile(tilex, tiley);
+			const int drawX = (tilex*TILE_SIZE)-offsetX;
 
 			if(origTile == FIRST_POWERLINE_BRIDGE_TILE)				// horizontal power line
 			{
-				*DRAW_COLORS=PALETTE_BLACK;
-				line((tilex*TILE_SIZE)-offsetX,(tiley*TILE_SIZE)-offsetY+1,(tilex*TILE_SIZE)-offsetX+TILE_SIZE-1,(tiley*TILE_SIZE)-offsetY+1);
-				line((tilex*TILE_SIZE)-offsetX,(tiley*TILE_SIZE)-offsetY+3,(tilex*TILE_SIZE)-offsetX+TILE_SIZE-1,(tiley*TILE_SIZE)-offsetY+3);
+				DrawHLine(drawX, drawY+1, TILE_SIZE, PALETTE_BLACK);
+				DrawHLine(drawX, drawY+3, TILE_SIZE, PALETTE_BLACK);
 			}
 			else if(origTile == (FIRST_POWERLINE_BRIDGE_TILE+1))	// vertical power line
 			{
-				*DRAW_COLORS=PALETTE_BLACK;
-				line((tilex*TILE_SIZE)-offsetX+3,(tiley*TILE_SIZE)-offsetY,(tilex*TILE_SIZE)-offsetX+3,(tiley*TILE_SIZE)-offsetY+TILE_SIZE-1);
-				line((tilex*TILE_SIZE)-offsetX+5,(tiley*TILE_SIZE)-offsetY,(tilex*TILE_SIZE)-offsetX+5,(tiley*TILE_SIZE)-offsetY+TILE_SIZE-1);
+				DrawVLine(drawX+3, drawY, TILE_SIZE, PALETTE_BLACK);
+				DrawVLine(drawX+5, drawY, TILE_SIZE, PALETTE_BLACK);
 			}
 			// blit land powerline over original terrain
 			else if(origTile >= (FIRST_POWERLINE_TILE) && origTile < (FIRST_POWERLINE_TILE+11))
 			{
-				uint8_t c = GetTileColor(origTile);
-				*DRAW_COLORS = c;
-				blit(GetTileData(origTile),(tilex*TILE_SIZE)-offsetX,(tiley*TILE_SIZE)-offsetY,TILE_SIZE,TILE_SIZE,BLIT_1BPP|BLIT_ROTATE);
+				SetDrawColors(GetTileColor(origTile));
+				blit(GetTileData(origTile),drawX,drawY,TILE_SIZE,TILE_SIZE,BLIT_1BPP|BLIT_ROTATE);
+				COUNT_DRAW_CALL(Blits);
 			}
-
 		}
 	}
 
@@ -377,116 +615,69 @@ void DrawTilesOld()
 }
 */
 
-void ScrollUp(int amount)
-{
-	CachedScrollY -= amount;
-	int y = VISIBLE_TILES_Y - 1;
-
-	for (int n = 0; n < VISIBLE_TILES_Y - amount; n++)
-	{
-		for (int x = 0; x < VISIBLE_TILES_X; x++)
-		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = VisibleTileCache[(y - amount) * VISIBLE_TILES_X + x];
-		}
-		y--;
-	}
-
-	for (y = 0; y < amount; y++)
-	{
-		for (int x = 0; x < VISIBLE_TILES_X; x++)
-		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = CalculateTile(x + CachedScrollX, y + CachedScrollY);
-		}
-	}
-}
-
-void ScrollDown(int amount)
+// Moves the visible tile cache to a new scroll position (in tiles), only calculating the tiles that weren't already visible
+void ScrollVisibleTileCache(int scrollX, int scrollY)
 {
-	CachedScrollY += amount;
-	int y = 0;
-
-	for (int n = 0; n < VISIBLE_TILES_Y - amount; n++)
-	{
-		for (int x = 0; x < VISIBLE_TILES_X; x++)
-		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = VisibleTileCache[(y + amount) * VISIBLE_TILES_X + x];
-		}
-		y++;
-	}
+	const int oldScrollX = CachedScrollX;
+	const int oldScrollY = CachedScrollY;
+	CachedScrollX = scrollX;
+	CachedScrollY = scrollY;
 
-	y = VISIBLE_TILES_Y - 1;
-	for (int n = 0; n < amount; n++)
+	for (int y = scrollY; y < scrollY + VISIBLE_TILES_Y; y++)
 	{
-		for (int x = 0; x < VISIBLE_TILES_X; x++)
+		// whole row is new
+		if (y < oldScrollY || y >= oldScrollY + VISIBLE_TILES_Y)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = CalculateTile(x + CachedScrollX, y + CachedScrollY);
+			for (int x = scrollX; x < scrollX + VISIBLE_TILES_X; x++)
+			{
+				GetVisibleTile(x, y) = GetResolvedTile(x, y);
+			}
+			continue;
 		}
-		y--;
-	}
-}
-
-void ScrollLeft(int amount)
-{
-	CachedScrollX -= amount;
-	int x = VISIBLE_TILES_X - 1;
 
-	for (int n = 0; n < VISIBLE_TILES_X - amount; n++)
-	{
-		for (int y = 0; y < VISIBLE_TILES_Y; y++)
+		// only the columns on the left or right that weren't visible before
+		for (int x = scrollX; x < scrollX + VISIBLE_TILES_X && x < oldScrollX; x++)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = VisibleTileCache[y * VISIBLE_TILES_X + x - amount];
+			GetVisibleTile(x, y) = GetResolvedTile(x, y);
 		}
-		x--;
-	}
-
-	for (x = 0; x < amount; x++)
-	{
-		for (int y = 0; y < VISIBLE_TILES_Y; y++)
+		for (int x = (oldScrollX + VISIBLE_TILES_X > scrollX ? oldScrollX + VISIBLE_TILES_X : scrollX); x < scrollX + VISIBLE_TILES_X; x++)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = CalculateTile(x + CachedScrollX, y + CachedScrollY);
+			GetVisibleTile(x, y) = GetResolvedTile(x, y);
 		}
 	}
 }
 
-void ScrollRight(int amount)
+// The dashes march around the rect, so each edge is drawn as runs of up to 4 same colored pixels
+void DrawCursorRect(int32_t cursorDrawX, int32_t cursorDrawY, int32_t cursorWidth, int32_t cursorHeight)
 {
-	CachedScrollX += amount;
-	int x = 0;
+	const uint8_t phase = AnimationFrame >> 1;
 
-	for (int n = 0; n < VISIBLE_TILES_X - amount; n++)
+	for (int n = 0; n < cursorWidth; )
 	{
-		for (int y = 0; y < VISIBLE_TILES_Y; y++)
+		const uint8_t color = ((n + phase) & 4) != 0 ? PALETTE_WHITE : PALETTE_BLACK;
+		int run = 4 - ((n + phase) & 3);
+		if (n + run > cursorWidth)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = VisibleTileCache[y * VISIBLE_TILES_X + x + amount];
+			run = cursorWidth - n;
 		}
-		x++;
+		// bottom edge runs left to right, top edge right to left
+		DrawHLine(cursorDrawX + n, cursorDrawY + cursorHeight - 1, run, color);
+		DrawHLine(cursorDrawX + cursorWidth - n - run, cursorDrawY, run, color);
+		n += run;
 	}
 
-	x = VISIBLE_TILES_X - 1;
-	for (int n = 0; n < amount; n++)
+	for (int n = 0; n < cursorHeight; )
 	{
-		for (int y = 0; y < VISIBLE_TILES_Y; y++)
+		const uint8_t color = ((n + phase) & 4) != 0 ? PALETTE_WHITE : PALETTE_BLACK;
+		int run = 4 - ((n + phase) & 3);
+		if (n + run > cursorHeight)
 		{
-			VisibleTileCache[y * VISIBLE_TILES_X + x] = CalculateTile(x + CachedScrollX, y + CachedScrollY);
+			run = cursorHeight - n;
 		}
-		x--;
-	}
-}
-
-void DrawCursorRect(int32_t cursorDrawX, int32_t cursorDrawY, int32_t cursorWidth, int32_t cursorHeight)
-{
-	for (int n = 0; n < cursorWidth; n++)
-	{
-		uint8_t color = ((n + (AnimationFrame >> 1)) & 4) != 0 ? PALETTE_WHITE : PALETTE_BLACK;
-		PutPixel(cursorDrawX + n, cursorDrawY + cursorHeight - 1, color);
-		PutPixel(cursorDrawX + cursorWidth - n - 1, cursorDrawY, color);
-	}
-
-	for (int n = 0; n < cursorHeight; n++)
-	{
-		uint8_t color = ((n + (AnimationFrame >> 1)) & 4) != 0 ? PALETTE_WHITE : PALETTE_BLACK;
-		PutPixel(cursorDrawX, cursorDrawY + n, color);
-		PutPixel(cursorDrawX + cursorWidth - 1, cursorDrawY + cursorHeight - n - 1, color);
+		// left edge runs top to bottom, right edge bottom to top
+		DrawVLine(cursorDrawX, cursorDrawY + n, run, color);
+		DrawVLine(cursorDrawX + cursorWidth - 1, cursorDrawY + cursorHeight - n - run, run, color);
+		n += run;
 	}
 }
 
@@ -519,6 +710,35 @@ void DrawCursor()
 	}
 }
 
+static void DrawTileSpanCursor(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	const uint8_t left = x1 < x2 ? x1 : x2;
+	const uint8_t top = y1 < y2 ? y1 : y2;
+	const uint8_t width = (x1 < x2 ? x2 - x1 : x1 - x2) + 1;
+	const uint8_t height = (y1 < y2 ? y2 - y1 : y1 - y2) + 1;
+	DrawCursorRect(left * 8 - UIState.scrollX, top * 8 - UIState.scrollY, width * TILE_SIZE, height * TILE_SIZE);
+}
+
+// The stroke being drawn, a cursor around each straight run of its path
+void DrawStrokeCursor()
+{
+	uint16_t count;
+	int32_t cost;
+	const uint16_t* tiles = GetStrokePath(count, cost);
+
+	int runStart = 0;
+	for (int n = 1; n <= count; n++)
+	{
+		// a run ends where the path turns, or at the end of the path
+		if (n == count || (n - runStart >= 2 && tiles[n] - tiles[n - 1] != tiles[n - 1] - tiles[n - 2]))
+		{
+			const int runEnd = n - 1;
+			DrawTileSpanCursor(tiles[runStart] % MAP_WIDTH, tiles[runStart] / MAP_WIDTH, tiles[runEnd] % MAP_WIDTH, tiles[runEnd] / MAP_WIDTH);
+			runStart = runEnd;
+		}
+	}
+}
+
 void AnimatePowercuts()
 {
 	bool showPowercut = (AnimationFrame & 8) != 0;
@@ -529,18 +749,15 @@ void AnimatePowercuts()
 
 		if (building->type && building->type != Park && !IsRubble(building->type))
 		{
-			int screenX = building->x + 1 - CachedScrollX;
-			int screenY = building->y + 1 - CachedScrollY;
-
-			if (screenX >= 0 && screenY >= 0 && screenX < VISIBLE_TILES_X && screenY < VISIBLE_TILES_Y)
+			if (IsTileInVisibleTileCache(building->x + 1, building->y + 1))
 			{
 				if (showPowercut && !building->hasPower)
 				{
-					VisibleTileCache[screenY * VISIBLE_TILES_X + screenX] = POWERCUT_TILE;
+					GetVisibleTile(building->x + 1, building->y + 1) = POWERCUT_TILE;
 				}
 				else
 				{
-					VisibleTileCache[screenY * VISIBLE_TILES_X + screenX] = CalculateBuildingTile(building, 1, 1);
+					GetVisibleTile(building->x + 1, building->y + 1) = CalculateBuildingTile(building, 1, 1);
 				}
 			}
 		}
@@ -550,23 +767,18 @@ void AnimatePowercuts()
 
 void RefreshTile(uint8_t x, uint8_t y)
 {
-	int screenX = x - CachedScrollX;
-	int screenY = y - CachedScrollY;
-
-	if (screenX >= 0 && screenY >= 0 && screenX < VISIBLE_TILES_X && screenY < VISIBLE_TILES_Y)
+	if (IsTileInVisibleTileCache(x, y))
 	{
-		VisibleTileCache[screenY * VISIBLE_TILES_X + screenX] = CalculateTile(x, y);
+		GetVisibleTile(x, y) = GetResolvedTile(x, y);
 	}
 }
 
+// Only changes the visible tile, the resolved tile layer isn't affected
 void SetTile(uint8_t x, uint8_t y, uint8_t tile)
 {
-	int screenX = x - CachedScrollX;
-	int screenY = y - CachedScrollY;
-
-	if (screenX >= 0 && screenY >= 0 && screenX < VISIBLE_TILES_X && screenY < VISIBLE_TILES_Y)
+	if (IsTileInVisibleTileCache(x, y))
 	{
-		VisibleTileCache[screenY * VISIBLE_TILES_X + screenX] = tile;
+		GetVisibleTile(x, y) = tile;
 	}
 }
 
@@ -585,6 +797,21 @@ void RefreshTileAndConnectedNeighbours(uint8_t x, uint8_t y)
 
 }
 
+// Parts of the area off the map are skipped
+void RefreshTileArea(int x, int y, int width, int height)
+{
+	for (int j = y; j < y + height; j++)
+	{
+		for (int i = x; i < x + width; i++)
+		{
+			if (i >= 0 && j >= 0 && i < MAP_WIDTH && j < MAP_HEIGHT)
+			{
+				RefreshTile(i, j);
+			}
+		}
+	}
+}
+
 void RefreshBuildingTiles(Building* building)
 {
 	const BuildingInfo* info = GetBuildingInfo(building->type);
@@ -597,12 +824,10 @@ void RefreshBuildingTiles(Building* building)
 		for (int i = 0; i < width; i++)
 		{
 			uint8_t x = building->x + i;
-			int screenX = x - CachedScrollX;
-			int screenY = y - CachedScrollY;
 
-			if (screenX >= 0 && screenY >= 0 && screenX < VISIBLE_TILES_X && screenY < VISIBLE_TILES_Y)
+			if (IsTileInVisibleTileCache(x, y))
 			{
-				VisibleTileCache[screenY * VISIBLE_TILES_X + screenX] = CalculateBuildingTile(building, i, j);
+				GetVisibleTile(x, y) = CalculateBuildingTile(building, i, j);
 			}
 		}
 	}
@@ -632,8 +857,9 @@ void RefreshBuildingTiles(Building* building)
 
 void DrawTileAt(uint8_t tile, int x, int y)
 {
-	*DRAW_COLORS = ((GetTileForegroundColor(tile) << 4) | GetTileBackgroundColor(tile));
+	SetDrawColors((GetTileForegroundColor(tile) << 4) | GetTileBackgroundColor(tile));
 	blit(GetTileData(tile),x,y,TILE_SIZE,TILE_SIZE,BLIT_1BPP|BLIT_ROTATE);
+	COUNT_DRAW_CALL(Blits);
 	/*
 	for (int col = 0; col < TILE_SIZE; col++)
 	{
@@ -651,30 +877,91 @@ void DrawTileAt(uint8_t tile, int x, int y)
 	*/
 }
 
+// Rects and lines go through the native rect/hline/vline calls, or SurfaceFillRect() when there is a DrawTarget
+// All DRAW_COLORS writes go through SetDrawColors() so runs of draws with the same colors only set it once
+uint16_t LastDrawColors = 0;
+
+void SetDrawColors(uint16_t colors)
+{
+	if (LastDrawColors != colors)
+	{
+		*DRAW_COLORS = colors;
+		LastDrawColors = colors;
+		COUNT_DRAW_CALL(ColorWrites);
+	}
+	else
+	{
+		COUNT_DRAW_CALL(ColorWritesSkipped);
+	}
+}
+
+void DrawHLine(int32_t x, int32_t y, int32_t len, uint8_t color)
+{
+	if (len <= 0)
+	{
+		return;
+	}
+	if (DrawTarget)
+	{
+		SurfaceFillRect(*DrawTarget, x - DrawTargetX, y - DrawTargetY, len, 1, color);
+		return;
+	}
+	SetDrawColors(color);
+	hline(x, y, len);
+	COUNT_DRAW_CALL(Lines);
+}
+
+void DrawVLine(int32_t x, int32_t y, int32_t len, uint8_t color)
+{
+	if (len <= 0)
+	{
+		return;
+	}
+	if (DrawTarget)
+	{
+		SurfaceFillRect(*DrawTarget, x - DrawTargetX, y - DrawTargetY, 1, len, color);
+		return;
+	}
+	SetDrawColors(color);
+	vline(x, y, len);
+	COUNT_DRAW_CALL(Lines);
+}
+
 void DrawFilledRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color)
 {
-	for (int j = 0; j < h; j++)
+	if (w <= 0 || h <= 0)
 	{
-		for (int i = 0; i < w; i++)
-		{
-			PutPixel(x + i, y + j, color);
-		}
+		return;
+	}
+	if (DrawTarget)
+	{
+		SurfaceFillRect(*DrawTarget, x - DrawTargetX, y - DrawTargetY, w, h, color);
+		return;
 	}
+	// rect fills with the first color and outlines with the second
+	SetDrawColors((color << 4) | color);
+	rect(x, y, w, h);
+	COUNT_DRAW_CALL(Rects);
 }
 
 void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color)
 {
-	for (int j = 0; j < w; j++)
+	if (w <= 0 || h <= 0)
 	{
-		PutPixel(x + j, y, color);
-		PutPixel(x + j, y + h - 1, color);
+		return;
 	}
-
-	for (int j = 1; j < h - 1; j++)
+	if (DrawTarget)
 	{
-		PutPixel(x, y + j, color);
-		PutPixel(x + w - 1, y + j, color);
+		DrawHLine(x, y, w, color);
+		DrawHLine(x, y + h - 1, w, color);
+		DrawVLine(x, y + 1, h - 2, color);
+		DrawVLine(x + w - 1, y + 1, h - 2, color);
+		return;
 	}
+	// transparent fill, outline only
+	SetDrawColors(color << 4);
+	rect(x, y, w, h);
+	COUNT_DRAW_CALL(Rects);
 }
 
 const char FireReportedStr[] = "Fire reported!";
@@ -753,6 +1040,19 @@ void DrawUI()
 		DrawFilledRect(0, DISPLAY_HEIGHT - TILE_SIZE - 2, TILE_SIZE + 2 + strlen(currentSelection) * FONT_WIDTH + 2, TILE_SIZE + 2, PALETTE_WHITE);
 		DrawTileAt(FIRST_BRUSH_TILE + UIState.brush, 1, DISPLAY_HEIGHT - TILE_SIZE - 1);
 		DrawString(currentSelection, TILE_SIZE + 2, DISPLAY_HEIGHT - FONT_HEIGHT - 1);
+
+		if (UIState.state == DrawingStroke)
+		{
+			// What the stroke will cost, nothing if it can't be built
+			uint16_t count;
+			int32_t cost;
+			GetStrokePath(count, cost);
+			if (cost >= 0)
+			{
+				const uint8_t costStrLen = DrawCurrency(cost, DISPLAY_WIDTH - FONT_WIDTH - 1, DISPLAY_HEIGHT - FONT_HEIGHT - 1);
+				DrawRect(DISPLAY_WIDTH - 2 - costStrLen * FONT_WIDTH, DISPLAY_HEIGHT - FONT_HEIGHT - 2, costStrLen * FONT_WIDTH + 2, FONT_HEIGHT + 2, PALETTE_WHITE);
+			}
+		}
 	}
 
 	// Date at top left
@@ -779,55 +1079,12 @@ void DrawUI()
 void DrawInGame()
 {
 	// Check to see if scrolled to a new location and need to update the visible tile cache
-	int tileScrollX = UIState.scrollX >> TILE_SIZE_SHIFT;
-	int tileScrollY = UIState.scrollY >> TILE_SIZE_SHIFT;
-	int scrollDiffX = tileScrollX - CachedScrollX;
-	int scrollDiffY = tileScrollY - CachedScrollY;
-
-	if (scrollDiffX < 0)
-	{
-		if (scrollDiffX > -VISIBLE_TILES_X)
-		{
-			ScrollLeft(-scrollDiffX);
-		}
-		else
-		{
-			ResetVisibleTileCache();
-		}
-	}
-	else if (scrollDiffX > 0)
-	{
-		if (scrollDiffX < VISIBLE_TILES_X)
-		{
-			ScrollRight(scrollDiffX);
-		}
-		else
-		{
-			ResetVisibleTileCache();
-		}
-	}
+	const int tileScrollX = UIState.scrollX >> TILE_SIZE_SHIFT;
+	const int tileScrollY = UIState.scrollY >> TILE_SIZE_SHIFT;
 
-	if (scrollDiffY < 0)
-	{
-		if (scrollDiffY > -VISIBLE_TILES_Y)
-		{
-			ScrollUp(-scrollDiffY);
-		}
-		else
-		{
-			ResetVisibleTileCache();
-		}
-	}
-	else if (scrollDiffY > 0)
+	if (tileScrollX != CachedScrollX || tileScrollY != CachedScrollY)
 	{
-		if (scrollDiffY < VISIBLE_TILES_Y)
-		{
-			ScrollDown(scrollDiffY);
-		}
-		else
-		{
-			ResetVisibleTileCache();
-		}
+		ScrollVisibleTileCache(tileScrollX, tileScrollY);
 	}
 
 	AnimatePowercuts();
@@ -838,6 +1095,10 @@ void DrawInGame()
 	{
 		DrawCursor();
 	}
+	else if (UIState.state == DrawingStroke)
+	{
+		DrawStrokeCursor();
+	}
 
 	if (UIState.state != StartScreen && UIState.state != SaveLoadMenu && UIState.state != BudgetMenu && UIState.state != DemographicsMenu && UIState.state != ScenarioWinScreen && UIState.state != ScenarioLoseScreen)
 	{
@@ -852,6 +1113,8 @@ const char AutoBudgetStr[] = "Auto Budget:";
 const char OnStr[] = "On";
 const char OffStr[] = "Off";
 const char ExportCityPPMStr[] = "Export City PPM";
+const char UndoStr[] = "Undo";
+const char RedoStr[] = "Redo";
 const char VersionStr[] = "v0.4.1";
 
 void DrawSaveLoadMenu()
@@ -859,7 +1122,7 @@ void DrawSaveLoadMenu()
 	DrawInGame();
 
 	const int menuWidth = 68;
-	const int menuHeight = 58;
+	const int menuHeight = 78;
 	const int spacing = 10;
 	DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2 + 1, DISPLAY_HEIGHT / 2 - menuHeight / 2 + 1, menuWidth, menuHeight, PALETTE_BLACK);
 	DrawFilledRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_WHITE);
@@ -883,7 +1146,10 @@ void DrawSaveLoadMenu()
 
 	y += spacing;
 	DrawString(ExportCityPPMStr, x, y);
-
+	y += spacing;
+	DrawString(UndoStr, x, y);
+	y += spacing;
+	DrawString(RedoStr, x, y);
 }
 
 void DrawStartScreen()
@@ -895,7 +1161,13 @@ void DrawStartScreen()
 
 	DrawFilledRect((DISPLAY_WIDTH / 2 - (logoWidth /2 )) - 1, logoY -1 , logoWidth + 2, logoHeight + spacing * 2 + 2, PALETTE_WHITE);
 	DrawFilledRect(DISPLAY_WIDTH / 2 - logoWidth / 2, logoY, logoWidth, logoHeight, PALETTE_BLACK);
-	DrawBitmap(LogoBitmap, DISPLAY_WIDTH / 2 - logoWidth / 2, logoY, logoWidth, logoHeight, PALETTE_BLACK, PALETTE_WHITE);
+	const size_t mark = ScratchMark();
+	const uint8_t *logo = UnpackAsset(Asset_Logo);
+	if(logo)
+	{
+		DrawBitmap(logo, DISPLAY_WIDTH / 2 - logoWidth / 2, logoY, logoWidth, logoHeight, PALETTE_BLACK, PALETTE_WHITE);
+	}
+	ScratchRelease(mark);
 
 	int32_t y = logoY + logoHeight - 2;
 	int32_t x = DISPLAY_WIDTH / 2 - FONT_WIDTH * 5;
@@ -919,18 +1191,36 @@ void DrawNewCityMenu()
 	DrawFilledRect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, PALETTE_WHITE);
 
 	DrawFilledRect(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2, mapY, MAP_WIDTH, MAP_HEIGHT, PALETTE_BLACK);
-	DrawBitmap(GetTerrainData(State.terrainType), DISPLAY_WIDTH / 2 - MAP_WIDTH / 2, mapY, MAP_WIDTH, MAP_HEIGHT, PALETTE_BLUE, PALETTE_GREEN);
+	const size_t mark = ScratchMark();
+	const uint8_t *terrain = GetTerrainData(State.terrainType);
+	if(terrain)
+	{
+		DrawBitmap(terrain, DISPLAY_WIDTH / 2 - MAP_WIDTH / 2, mapY, MAP_WIDTH, MAP_HEIGHT, PALETTE_BLUE, PALETTE_GREEN);
+	}
+	ScratchRelease(mark);
+	// hide the rows of a random map that haven't been generated yet
+	if(IsGeneratingRandomTerrain())
+	{
+		const uint8_t rows = GetRandomTerrainProgress();
+		DrawFilledRect(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2, mapY + rows, MAP_WIDTH, MAP_HEIGHT - rows, PALETTE_BLACK);
+	}
 	DrawRect(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2 - 2, mapY - 2, MAP_WIDTH + 4, MAP_HEIGHT + 4, PALETTE_BLACK);
 
-	// draw roads on map
+	// draw roads on map, a line per horizontal run of road
 	for(int y=0; y<MAP_HEIGHT; y++)
 	{
-		for(int x=0; x<MAP_WIDTH; x++)
+		int runStart=-1;
+		for(int x=0; x<=MAP_WIDTH; x++)
 		{
-			uint8_t c=GetConnections(x,y);
-			if((c & RoadMask)==RoadMask)
+			const bool road=x<MAP_WIDTH && (GetConnections(x,y) & RoadMask)==RoadMask;
+			if(road && runStart<0)
 			{
-				PutPixel(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2 + x, mapY + y, PALETTE_BLACK);
+				runStart=x;
+			}
+			else if(!road && runStart>=0)
+			{
+				DrawHLine(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2 + runStart, mapY + y, x - runStart, PALETTE_BLACK);
+				runStart=-1;
 			}
 		}
 	}
@@ -939,13 +1229,7 @@ void DrawNewCityMenu()
 	{
 		if(State.buildings[i].type!=BuildingType_None && State.buildings[i].type<Num_BuildingTypes)
 		{
-			for(int h=0; h<BuildingMetaData[State.buildings[i].type].height; h++)
-			{
-				for(int w=0; w<BuildingMetaData[State.buildings[i].type].width; w++)
-				{
-					PutPixel(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2 + (State.buildings[i].x + w), mapY + State.buildings[i].y + h, PALETTE_WHITE);
-				}
-			}
+			DrawFilledRect(DISPLAY_WIDTH / 2 - MAP_WIDTH / 2 + State.buildings[i].x, mapY + State.buildings[i].y, BuildingMetaData[State.buildings[i].type].width, BuildingMetaData[State.buildings[i].type].height, PALETTE_WHITE);
 		}
 	}
 
@@ -956,6 +1240,10 @@ void DrawNewCityMenu()
 	if((ScenarioData[UIState.selection].flags & SCENARIO_FLAG_SANDBOX) == SCENARIO_FLAG_SANDBOX)
 	{
 		DrawStringCentered("Sandbox", DISPLAY_WIDTH / 2, mapY + MAP_HEIGHT + 30);
+		if(IsGeneratingRandomTerrain())
+		{
+			DrawStringCentered("Generating...", DISPLAY_WIDTH / 2, mapY + MAP_HEIGHT + 15);
+		}
 	}
 	else
 	{
@@ -1072,6 +1360,126 @@ const char FireBudgetStr[] =		"Fire budget";
 const char RoadBudgetStr[] =		"Road budget";
 const char CashFlowStr[] =			"Cash flow";
 
+// Menu panels are drawn into an off screen surface that is composited over the game each frame
+// The static parts are only drawn when a different panel is opened, and values only when they change
+#define PANEL_MAX_WIDTH 132			// largest panel plus its shadow, rounded up to a multiple of 4
+#define PANEL_MAX_HEIGHT 121
+#define PANEL_MAX_FIELDS 8
+#define PANEL_TRANSPARENT PALETTE_GREEN		// panels only use black and white
+
+enum
+{
+	Panel_None,
+	Panel_Budget,
+	Panel_Demographics,
+	Panel_ScenarioStats,
+	Panel_ScenarioWin,
+	Panel_ScenarioLose
+};
+
+enum
+{
+	PanelField_Int,
+	PanelField_RightJustifiedInt,
+	PanelField_Currency
+};
+
+typedef struct
+{
+	int32_t value;
+	int16_t x;			// area the value was drawn in, cleared before a new value is drawn
+	uint8_t width;
+} PanelFieldCache;
+
+Surface PanelSurface = { nullptr, 0, 0 };
+uint8_t PanelId = Panel_None;
+uint32_t PanelKey = 0;
+int32_t PanelX = 0, PanelY = 0;
+bool PanelRedraw = false;
+PanelFieldCache PanelFields[PANEL_MAX_FIELDS];
+
+// Starts a panel with a drop shadow - key should change whenever the static contents would
+// Returns true if the static contents need drawing, which then goes to the panel until EndPanel()
+bool BeginPanel(uint8_t id, uint32_t key, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	if(PanelSurface.data==nullptr)
+	{
+		PanelSurface.data=(uint8_t *)malloc(GetSurfaceSize(PANEL_MAX_WIDTH,PANEL_MAX_HEIGHT));
+		PanelId=Panel_None;
+	}
+
+	PanelRedraw=(PanelSurface.data==nullptr || PanelId!=id || PanelKey!=key || PanelX!=x || PanelY!=y);
+	if(PanelRedraw==true)
+	{
+		PanelId=id;
+		PanelKey=key;
+		PanelX=x;
+		PanelY=y;
+		// if there's no memory for the panel it's just drawn directly every frame
+		if(PanelSurface.data!=nullptr)
+		{
+			PanelSurface.width=(w+1+3) & ~3;
+			PanelSurface.height=h+1;
+			SurfaceClear(PanelSurface,PANEL_TRANSPARENT);
+			SetDrawTarget(&PanelSurface,x,y);
+		}
+
+		DrawRect(x + 1, y + 1, w, h, PALETTE_BLACK);
+		DrawFilledRect(x, y, w, h, PALETTE_WHITE);
+		DrawRect(x, y, w, h, PALETTE_BLACK);
+	}
+	return PanelRedraw;
+}
+
+void DrawPanelField(uint8_t index, int32_t value, int32_t x, int32_t y, uint8_t format)
+{
+	PanelFieldCache *field=&PanelFields[index];
+	if(PanelRedraw==false && field->value==value)
+	{
+		return;
+	}
+
+	Surface *target=DrawTarget;
+	if(PanelSurface.data!=nullptr)
+	{
+		SetDrawTarget(&PanelSurface,PanelX,PanelY);
+	}
+	if(PanelRedraw==false)
+	{
+		DrawFilledRect(field->x, y, field->width, FONT_HEIGHT, PALETTE_WHITE);
+	}
+
+	uint8_t len=0;
+	switch(format)
+	{
+	case PanelField_Int:
+		len=DrawInt(value, x, y);
+		field->x=x;
+		break;
+	case PanelField_RightJustifiedInt:
+		len=DrawRightJustifiedInt(value, x, y);
+		field->x=x-((len-1)*FONT_WIDTH);
+		break;
+	case PanelField_Currency:
+		len=DrawCurrency(value, x, y);
+		field->x=x-((len-1)*FONT_WIDTH);
+		break;
+	}
+	field->width=len*FONT_WIDTH;
+	field->value=value;
+
+	SetDrawTarget(target,PanelX,PanelY);
+}
+
+void EndPanel()
+{
+	SetDrawTarget(nullptr,0,0);
+	if(PanelSurface.data!=nullptr)
+	{
+		BlitSurfaceTransparent(PanelSurface,PanelX,PanelY,PANEL_TRANSPARENT);
+	}
+}
+
 void DrawBudgetMenu()
 {
 	DrawInGame();
@@ -1079,47 +1487,51 @@ void DrawBudgetMenu()
 	const int menuWidth = 100;
 	const int menuHeight = 63;
 	const int spacing = FONT_HEIGHT + 1;
-	DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2 + 1, DISPLAY_HEIGHT / 2 - menuHeight / 2 + 1, menuWidth, menuHeight, PALETTE_BLACK);
-	DrawFilledRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_WHITE);
-	DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_BLACK);
+	const bool redraw = BeginPanel(Panel_Budget, 0, DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight);
 
 	int32_t y = DISPLAY_HEIGHT / 2 - menuHeight / 2 + 2;
 	int32_t x = DISPLAY_WIDTH / 2 - menuWidth / 2 + 2;
 	int32_t x2 = DISPLAY_WIDTH / 2 + menuWidth / 2 - 2 - FONT_WIDTH;
 
-	DrawString(BudgetHeaderStr, x, y);
+	if (redraw)
+	{
+		DrawString(BudgetHeaderStr, x, y);
+		DrawString(TaxRateStr, x, y + spacing + 2);
+		DrawString(EstYearTaxes, x, y + spacing * 2 + 2);
+		DrawString(TaxesCollectedStr, x, y + spacing * 3 + 2);
+		DrawString(FireBudgetStr, x, y + spacing * 4 + 2);
+		DrawString(PoliceBudgetStr, x, y + spacing * 5 + 2);
+		DrawString(RoadBudgetStr, x, y + spacing * 6 + 2);
+		DrawString(CashFlowStr, x, y + spacing * 7 + 4);
+	}
+
 	int year = State.year > 0 ? State.year + 1899 : 1900;
-	DrawInt(year, x + FONT_WIDTH * 18, y);
+	DrawPanelField(0, year, x + FONT_WIDTH * 18, y, PanelField_Int);
 	y += spacing + 2;
 
-	DrawString(TaxRateStr, x, y);
-	DrawInt(State.taxRate, x + FONT_WIDTH * 19, y);
+	DrawPanelField(1, State.taxRate, x + FONT_WIDTH * 19, y, PanelField_Int);
 	y += spacing;
 
-	DrawString(EstYearTaxes, x, y);
-	DrawCurrency(GetEstimatedYearTaxes(), x2, y);
+	DrawPanelField(2, GetEstimatedYearTaxes(State), x2, y, PanelField_Currency);
 	y += spacing;
 
-	DrawString(TaxesCollectedStr, x, y);
-	DrawCurrency(State.taxesCollected, x2, y);
+	DrawPanelField(3, State.taxesCollected, x2, y, PanelField_Currency);
 	y += spacing;
 
-	DrawString(FireBudgetStr, x, y);
-	DrawCurrency(State.fireBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y);
+	DrawPanelField(4, State.fireBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y, PanelField_Currency);
 	y += spacing;
 
-	DrawString(PoliceBudgetStr, x, y);
-	DrawCurrency(State.policeBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y);
+	DrawPanelField(5, State.policeBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y, PanelField_Currency);
 	y += spacing;
 
-	DrawString(RoadBudgetStr, x, y);
-	DrawCurrency(State.roadBudget, x2, y);
+	DrawPanelField(6, State.roadBudget, x2, y, PanelField_Currency);
 	y += spacing + 2;
 
-	DrawString(CashFlowStr, x, y);
-	DrawCurrency(State.taxesCollected - State.roadBudget - State.policeBudget * FIRE_AND_POLICE_MAINTENANCE_COST - State.fireBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y);
+	DrawPanelField(7, State.taxesCollected - State.roadBudget - State.policeBudget * FIRE_AND_POLICE_MAINTENANCE_COST - State.fireBudget * FIRE_AND_POLICE_MAINTENANCE_COST, x2, y, PanelField_Currency);
 	y += spacing;
 
+	EndPanel();
+
 	if (UIState.selection < MIN_BUDGET_DISPLAY_TIME)
 	{
 		UIState.selection++;
@@ -1135,150 +1547,152 @@ void DrawDemographicsMenu()
 		const int menuWidth = 100;
 		const int menuHeight = 56;
 		const int spacing = FONT_HEIGHT + 1;
-		DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2 + 1, DISPLAY_HEIGHT / 2 - menuHeight / 2 + 1, menuWidth, menuHeight, PALETTE_BLACK);
-		DrawFilledRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_WHITE);
-		DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_BLACK);
+		const bool redraw = BeginPanel(Panel_Demographics, 0, DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight);
 
 		int32_t y = DISPLAY_HEIGHT / 2 - menuHeight / 2 + 2;
 		int32_t x = DISPLAY_WIDTH / 2 - menuWidth / 2 + 2;
 		int32_t x2 = DISPLAY_WIDTH / 2 + menuWidth / 2 - 2 - FONT_WIDTH;
 
-		DrawStringCentered("Demographics",DISPLAY_WIDTH / 2, y);
-		DrawString(RightArrowStr,DISPLAY_WIDTH / 2 + 40, y);
-		DrawString(LeftArrowStr,DISPLAY_WIDTH / 2 - 40, y);
+		if(redraw)
+		{
+			DrawStringCentered("Demographics",DISPLAY_WIDTH / 2, y);
+			DrawString(RightArrowStr,DISPLAY_WIDTH / 2 + 40, y);
+			DrawString(LeftArrowStr,DISPLAY_WIDTH / 2 - 40, y);
+			DrawString("Population", x, y + spacing + 2);
+			DrawString("Residential", x, y + spacing * 2 + 2);
+			DrawString("Commercial", x, y + spacing * 3 + 2);
+			DrawString("Industrial", x, y + spacing * 4 + 2);
+			DrawString("Total", x, y + spacing * 5 + 4);
+		}
 		y += spacing + 2;
-
-		DrawString("Population", x, y);
 		y += spacing;
 
-		DrawString("Residential", x, y);
-		DrawRightJustifiedInt(State.residentialPopulation, x2, y);
+		DrawPanelField(0, State.residentialPopulation, x2, y, PanelField_RightJustifiedInt);
 		y += spacing;
 
-		DrawString("Commercial", x, y);
-		DrawRightJustifiedInt(State.commercialPopulation, x2, y);
+		DrawPanelField(1, State.commercialPopulation, x2, y, PanelField_RightJustifiedInt);
 		y += spacing;
 
-		DrawString("Industrial", x, y);
-		DrawRightJustifiedInt(State.industrialPopulation, x2, y);
+		DrawPanelField(2, State.industrialPopulation, x2, y, PanelField_RightJustifiedInt);
 		y += spacing;
 
 		y += 2;
-		DrawString("Total", x, y);
-		DrawRightJustifiedInt(State.residentialPopulation + State.commercialPopulation + State.industrialPopulation, x2, y);
+		DrawPanelField(3, State.residentialPopulation + State.commercialPopulation + State.industrialPopulation, x2, y, PanelField_RightJustifiedInt);
 		y += spacing;
+
+		EndPanel();
 	}
 	else if(UIState.selection==1)	// scenario stats
 	{
 		const int menuWidth = 130;
 		const int menuHeight = 120;
 		const int spacing = FONT_HEIGHT + 1;
-		DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2 + 1, DISPLAY_HEIGHT / 2 - menuHeight / 2 + 1, menuWidth, menuHeight, PALETTE_BLACK);
-		DrawFilledRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_WHITE);
-		DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_BLACK);
-
-		int32_t y = DISPLAY_HEIGHT / 2 - menuHeight / 2 + 2;
-		int32_t x = DISPLAY_WIDTH / 2 - menuWidth / 2 + 2;
-		int32_t x2 = DISPLAY_WIDTH / 2 + menuWidth / 2 - 2 - FONT_WIDTH;
-
-		DrawStringCentered("Scenario",DISPLAY_WIDTH / 2, y);
-		DrawString(RightArrowStr,DISPLAY_WIDTH / 2 + 40, y);
-		DrawString(LeftArrowStr,DISPLAY_WIDTH / 2 - 40, y);
-		y += spacing + 2;
-
-		uint8_t scenario=(State.data[0] >> 2);
-		if(scenario)
+		// nothing on this panel changes unless the scenario is won or lost
+		if(BeginPanel(Panel_ScenarioStats, State.data[0], DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight))
 		{
-			DrawStringCentered(ScenarioData[scenario].title,DISPLAY_WIDTH / 2, y);
-			y+=spacing+2;
+			int32_t y = DISPLAY_HEIGHT / 2 - menuHeight / 2 + 2;
+			int32_t x = DISPLAY_WIDTH / 2 - menuWidth / 2 + 2;
+			int32_t x2 = DISPLAY_WIDTH / 2 + menuWidth / 2 - 2 - FONT_WIDTH;
 
-			if(State.data[0] & 0b00000010)
-			{
-				DrawStringCentered("You Won!",DISPLAY_WIDTH / 2, y);
-				y+=spacing+2;
-			}
-			if(State.data[0] & 0b00000001)
-			{
-				DrawStringCentered("You Lost!",DISPLAY_WIDTH / 2, y);
-				y+=spacing+2;
-			}
+			DrawStringCentered("Scenario",DISPLAY_WIDTH / 2, y);
+			DrawString(RightArrowStr,DISPLAY_WIDTH / 2 + 40, y);
+			DrawString(LeftArrowStr,DISPLAY_WIDTH / 2 - 40, y);
+			y += spacing + 2;
 
-			DrawString("End Year :",x,y);
-			DrawInt(ScenarioData[scenario].goalyear,x+(12*FONT_WIDTH),y);
-			y+=spacing+2;
-			if(ScenarioData[scenario].goalfunds>0)
-			{
-				DrawString("Target Funds :",x,y);
-				DrawCurrency(ScenarioData[scenario].goalfunds,x+(24*FONT_WIDTH),y);
-				y+=spacing+2;
-			}
-			if(ScenarioData[scenario].goalrespop>0)
-			{
-				DrawString("Residential Population :",x,y);
-				DrawRightJustifiedInt(ScenarioData[scenario].goalrespop,x+(29*FONT_WIDTH),y);
-				y+=spacing+2;
-			}
-			if(ScenarioData[scenario].goalcompop>0)
+			uint8_t scenario=(State.data[0] >> 2);
+			if(scenario)
 			{
-				DrawString("Commercial Population :",x,y);
-				DrawRightJustifiedInt(ScenarioData[scenario].goalcompop,x+(29*FONT_WIDTH),y);
+				DrawStringCentered(ScenarioData[scenario].title,DISPLAY_WIDTH / 2, y);
 				y+=spacing+2;
-			}
-			if(ScenarioData[scenario].goalindpop>0)
-			{
-				DrawString("Industrial Population :",x,y);
-				DrawRightJustifiedInt(ScenarioData[scenario].goalindpop,x+(29*FONT_WIDTH),y);
-				y+=spacing+2;
-			}
 
-			for(int i=0; i<SCENARIO_GOAL_BUILDING_COUNT; i++)
-			{
-				if(ScenarioData[scenario].goalbuilding[i]!=BuildingType_None && ScenarioData[scenario].goalbuildingcount[i]>0)
+				if(State.data[0] & 0b00000010)
+				{
+					DrawStringCentered("You Won!",DISPLAY_WIDTH / 2, y);
+					y+=spacing+2;
+				}
+				if(State.data[0] & 0b00000001)
+				{
+					DrawStringCentered("You Lost!",DISPLAY_WIDTH / 2, y);
+					y+=spacing+2;
+				}
+
+				DrawString("End Year :",x,y);
+				DrawInt(ScenarioData[scenario].goalyear,x+(12*FONT_WIDTH),y);
+				y+=spacing+2;
+				if(ScenarioData[scenario].goalfunds>0)
+				{
+					DrawString("Target Funds :",x,y);
+					DrawCurrency(ScenarioData[scenario].goalfunds,x+(24*FONT_WIDTH),y);
+					y+=spacing+2;
+				}
+				if(ScenarioData[scenario].goalrespop>0)
 				{
-					DrawInt(ScenarioData[scenario].goalbuildingcount[i],x,y);
+					DrawString("Residential Population :",x,y);
+					DrawRightJustifiedInt(ScenarioData[scenario].goalrespop,x+(29*FONT_WIDTH),y);
+					y+=spacing+2;
+				}
+				if(ScenarioData[scenario].goalcompop>0)
+				{
+					DrawString("Commercial Population :",x,y);
+					DrawRightJustifiedInt(ScenarioData[scenario].goalcompop,x+(29*FONT_WIDTH),y);
+					y+=spacing+2;
+				}
+				if(ScenarioData[scenario].goalindpop>0)
+				{
+					DrawString("Industrial Population :",x,y);
+					DrawRightJustifiedInt(ScenarioData[scenario].goalindpop,x+(29*FONT_WIDTH),y);
+					y+=spacing+2;
+				}
 
-					switch(ScenarioData[scenario].goalbuilding[i])
+				for(int i=0; i<SCENARIO_GOAL_BUILDING_COUNT; i++)
+				{
+					if(ScenarioData[scenario].goalbuilding[i]!=BuildingType_None && ScenarioData[scenario].goalbuildingcount[i]>0)
 					{
-					case Residential:
-						DrawString("Residential",x+15,y);
-						break;
-					case Commercial:
-						DrawString("Commercial",x+15,y);
-						break;
-					case Industrial:
-						DrawString("Industrial",x+15,y);
-						break;
-					case Powerplant:
-						DrawString("Powerplant",x+15,y);
-						break;
-					case Park:
-						DrawString("Park",x+15,y);
-						break;
-					case PoliceDept:
-						DrawString("Police Dept",x+15,y);
-						break;
-					case FireDept:
-						DrawString("Fire Dept",x+15,y);
-						break;
-					case Stadium:
-						DrawString("Stadium",x+15,y);
-						break;
-					default:
-						DrawString("???",x+15,y);
-						break;
+						DrawInt(ScenarioData[scenario].goalbuildingcount[i],x,y);
+
+						switch(ScenarioData[scenario].goalbuilding[i])
+						{
+						case Residential:
+							DrawString("Residential",x+15,y);
+							break;
+						case Commercial:
+							DrawString("Commercial",x+15,y);
+							break;
+						case Industrial:
+							DrawString("Industrial",x+15,y);
+							break;
+						case Powerplant:
+							DrawString("Powerplant",x+15,y);
+							break;
+						case Park:
+							DrawString("Park",x+15,y);
+							break;
+						case PoliceDept:
+							DrawString("Police Dept",x+15,y);
+							break;
+						case FireDept:
+							DrawString("Fire Dept",x+15,y);
+							break;
+						case Stadium:
+							DrawString("Stadium",x+15,y);
+							break;
+						default:
+							DrawString("???",x+15,y);
+							break;
+						}
+						y+=spacing+2;
 					}
-					y+=spacing+2;
 				}
-			}
 
+			}
+			else
+			{
+				DrawStringCentered("Sandbox", DISPLAY_WIDTH / 2, y+30);
+				DrawStringCentered("There are no win conditions", DISPLAY_WIDTH / 2, y+40);
+				DrawStringCentered("in sandbox mode", DISPLAY_WIDTH / 2, y+48);
+			}
 		}
-		else
-		{
-			DrawStringCentered("Sandbox", DISPLAY_WIDTH / 2, y+30);
-			DrawStringCentered("There are no win conditions", DISPLAY_WIDTH / 2, y+40);
-			DrawStringCentered("in sandbox mode", DISPLAY_WIDTH / 2, y+48);
-		}
-
+		EndPanel();
 	}
 
 }
@@ -1290,39 +1704,36 @@ void DrawScenarioWinLoseScreen()
 	const int menuWidth = 100;
 	const int menuHeight = 56;
 	const int spacing = FONT_HEIGHT + 1;
-	DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2 + 1, DISPLAY_HEIGHT / 2 - menuHeight / 2 + 1, menuWidth, menuHeight, PALETTE_BLACK);
-	DrawFilledRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_WHITE);
-	DrawRect(DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight, PALETTE_BLACK);
 
 	int32_t y = DISPLAY_HEIGHT / 2 - menuHeight / 2 + 2;
 	int32_t x = DISPLAY_WIDTH / 2 - menuWidth / 2 + 2;
 	int32_t x2 = DISPLAY_WIDTH / 2 + menuWidth / 2 - 2 - FONT_WIDTH;
 
-	if(UIState.state==ScenarioWinScreen)
-	{
-		DrawStringCentered("You Won!",DISPLAY_WIDTH / 2, y);
-	}
-	else
+	if(BeginPanel(UIState.state==ScenarioWinScreen ? Panel_ScenarioWin : Panel_ScenarioLose, 0, DISPLAY_WIDTH / 2 - menuWidth / 2, DISPLAY_HEIGHT / 2 - menuHeight / 2, menuWidth, menuHeight))
 	{
-		DrawStringCentered("You Lose!",DISPLAY_WIDTH / 2, y);
+		if(UIState.state==ScenarioWinScreen)
+		{
+			DrawStringCentered("You Won!",DISPLAY_WIDTH / 2, y);
+		}
+		else
+		{
+			DrawStringCentered("You Lose!",DISPLAY_WIDTH / 2, y);
+		}
+		DrawStringCentered("Continue", DISPLAY_WIDTH / 2, y + 20);
+		DrawStringCentered("New Game", DISPLAY_WIDTH / 2, y + 30);
 	}
-	y+=10;
+	EndPanel();
 
-	y+=10;
-	DrawStringCentered("Continue", DISPLAY_WIDTH / 2, y);
-	y+=10;
-	DrawStringCentered("New Game", DISPLAY_WIDTH / 2, y);
-	y+=10;
-
-	DrawCursorRect(50, (y-20)+(UIState.selection*10)-2, DISPLAY_WIDTH-100, 10);
+	DrawCursorRect(50, (y+20)+(UIState.selection*10)-2, DISPLAY_WIDTH-100, 10);
 
 }
 
 void DrawTile(const uint8_t tile, const int32_t x, const int32_t y, const uint8_t fg, const uint8_t bg, const bool transparent)
 {
 	const uint8_t *data=GetTileData(tile);
-	*DRAW_COLORS = ((!transparent ? (bg << 4) : 0) | fg);
+	SetDrawColors((!transparent ? (bg << 4) : 0) | fg);
 	blit(data,x,y,TILE_SIZE,TILE_SIZE,BLIT_1BPP|BLIT_ROTATE);
+	COUNT_DRAW_CALL(Blits);
 	/*
 	int32_t byte=0;
 	int32_t bit=0;
@@ -1349,146 +1760,223 @@ void DrawTile(const uint8_t tile, const int32_t x, const int32_t y, const uint8_
 	*/
 }
 
-void DrawMapMenu()
+// The map menu is rendered into a cached 2bpp surface, which is only rebuilt when MapVersion or the selected layers change,
+// or CityStatsVersion does while an overlay or the fire dept range (which depends on power) is shown
+// The surface is (MAP_WIDTH*3)x(MAP_HEIGHT*3) pixels (5184 bytes) and is allocated the first time the map menu is opened
+#define MINIMAP_TILE_SIZE 3
+Surface MinimapSurface = { nullptr, MAP_WIDTH * MINIMAP_TILE_SIZE, MAP_HEIGHT * MINIMAP_TILE_SIZE };
+uint32_t MinimapVersion = 0;
+uint32_t MinimapStatsVersion = 0;
+uint8_t MinimapFlags = 0;
+uint8_t MinimapOverlay = Field_None;
+// 1 bit per building - set if the building shows the fire dept icon
+uint8_t MinimapFDRange[(MAX_BUILDINGS + 7) / 8];
+
+// Draws the connections of a tile and the links to its neighbours in the minimap
+void DrawMinimapConnections(int x, int y, uint8_t mask, uint8_t color)
 {
-	bool showbuildings=(State.flags & FLAG_MAP_SHOWBUILDINGS)==FLAG_MAP_SHOWBUILDINGS;
-	bool showroads=(State.flags & FLAG_MAP_SHOWROADS)==FLAG_MAP_SHOWROADS;
-	bool showpower=(State.flags & FLAG_MAP_SHOWELECTRIC)==FLAG_MAP_SHOWELECTRIC;
-	bool showfdrange=(State.flags & FLAG_MAP_SHOWFDRANGE)==FLAG_MAP_SHOWFDRANGE;
+	if((GetConnections(x,y) & mask) == mask)
+	{
+		const int32_t px=(x*MINIMAP_TILE_SIZE)+1;
+		const int32_t py=(y*MINIMAP_TILE_SIZE)+1;
+		SurfacePutPixel(MinimapSurface,px,py,color);
+		if(x>0 && (GetConnections(x-1,y) & mask)==mask)
+		{
+			SurfacePutPixel(MinimapSurface,px-1,py,color);
+		}
+		if(x<MAP_WIDTH-1 && (GetConnections(x+1,y) & mask)==mask)
+		{
+			SurfacePutPixel(MinimapSurface,px+1,py,color);
+		}
+		if(y>0 && (GetConnections(x,y-1) & mask)==mask)
+		{
+			SurfacePutPixel(MinimapSurface,px,py-1,color);
+		}
+		if(y<MAP_HEIGHT-1 && (GetConnections(x,y+1) & mask)==mask)
+		{
+			SurfacePutPixel(MinimapSurface,px,py+1,color);
+		}
+	}
+}
+
+bool IsInFireDeptRange(int i)
+{
+	uint8_t closestdistance = 0xff;
+	for(int j=0; j<MAX_BUILDINGS; j++)
+	{
+		if(i!=j && State.buildings[j].type==FireDept && State.buildings[j].hasPower==true)
+		{
+			uint8_t dist=GetManhattanDistance(&State.buildings[i],&State.buildings[j]);
+			if(dist<closestdistance)
+			{
+				closestdistance=dist;
+			}
+		}
+	}
 
-	const int32_t offsetx=(SCREEN_SIZE-(3*MAP_WIDTH))/2;
+	//calc from Simulation.cpp - SimulateBuilding
+	int fireDeptInfluence = SIM_FIRE_DEPT_BASE_INFLUENCE + closestdistance * SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER;
 
-	*DRAW_COLORS=(PALETTE_WHITE << 4) | PALETTE_WHITE;
-	rect(0,0,SCREEN_SIZE,SCREEN_SIZE);
+	return (fireDeptInfluence <= 255 || (State.buildings[i].type==FireDept && State.buildings[i].hasPower==true));
+}
 
-	/*
-	for(int i=0; i<MAX_BUILDINGS; i++)
+// Order pixels of a tile are filled in as a field value goes up, so overlays are dithered
+const uint8_t MinimapDitherOrder[MINIMAP_TILE_SIZE * MINIMAP_TILE_SIZE] =
+{ 0,7,3,6,5,2,4,1,8 };
+
+void DrawMinimapOverlay(const uint8_t *field)
+{
+	for(int y=0; y<MAP_HEIGHT; y++)
 	{
-		if(State.buildings[i].type)
+		for(int x=0; x<MAP_WIDTH; x++)
 		{
-			State.buildings[i].type
+			// 0-9 pixels set
+			const uint8_t level=(field[(y*MAP_WIDTH)+x]*10) >> 8;
+			for(int i=0; i<MINIMAP_TILE_SIZE*MINIMAP_TILE_SIZE; i++)
+			{
+				if(MinimapDitherOrder[i]<level)
+				{
+					SurfacePutPixel(MinimapSurface,(x*MINIMAP_TILE_SIZE)+(i%MINIMAP_TILE_SIZE),(y*MINIMAP_TILE_SIZE)+(i/MINIMAP_TILE_SIZE),PALETTE_BLACK);
+				}
+			}
 		}
 	}
-	*/
+}
+
+inline bool HasMinimapFDIcon(int i)
+{
+	return (MinimapFDRange[i >> 3] & (1 << (i & 7))) != 0;
+}
+
+inline bool HasMinimapPowerIcon(const Building &building)
+{
+	return building.type != Park && !IsRubble(building.type) && (building.type==Powerplant || building.hasPower==false);
+}
+
+// Draws everything that doesn't flash into the minimap surface
+void RenderMinimap(const uint8_t flags, const uint8_t overlay)
+{
+	bool showbuildings=(flags & FLAG_MAP_SHOWBUILDINGS)==FLAG_MAP_SHOWBUILDINGS;
+	bool showroads=(flags & FLAG_MAP_SHOWROADS)==FLAG_MAP_SHOWROADS;
+	bool showpower=(flags & FLAG_MAP_SHOWELECTRIC)==FLAG_MAP_SHOWELECTRIC;
+	bool showfdrange=(flags & FLAG_MAP_SHOWFDRANGE)==FLAG_MAP_SHOWFDRANGE;
+
 	for(int y=0; y<MAP_HEIGHT; y++)
 	{
 		for(int x=0; x<MAP_WIDTH; x++)
 		{
-			if(IsTerrainClear(x,y)==true)
+			SurfaceFillRect(MinimapSurface,x*MINIMAP_TILE_SIZE,y*MINIMAP_TILE_SIZE,MINIMAP_TILE_SIZE,MINIMAP_TILE_SIZE,IsTerrainClear(x,y) ? PALETTE_GREEN : PALETTE_BLUE);
+
+			if(showroads==true)
 			{
-				*DRAW_COLORS=(PALETTE_GREEN << 4) | PALETTE_GREEN;
+				DrawMinimapConnections(x,y,RoadMask,PALETTE_BLACK);
 			}
-			else
+			if(showpower==true)
 			{
-				*DRAW_COLORS=(PALETTE_BLUE << 4) | PALETTE_BLUE;
+				DrawMinimapConnections(x,y,PowerlineMask,PALETTE_WHITE);
 			}
-			rect(offsetx+(x*3),y*3,3,3);
+		}
+	}
 
-			if(showroads==true)
+	for(int i=0; i<(MAX_BUILDINGS + 7) / 8; i++)
+	{
+		MinimapFDRange[i]=0;
+	}
+
+	if(showbuildings==true)
+	{
+		for(int i=0; i<MAX_BUILDINGS; i++)
+		{
+			const Building &building=State.buildings[i];
+			if(building.type!=BuildingType_None)
 			{
-				uint8_t connections=GetConnections(x,y);
-				if((connections & RoadMask) == RoadMask)
+				const BuildingInfo *bi=GetBuildingInfo(building.type);
+				SurfaceFillRect(MinimapSurface,building.x*MINIMAP_TILE_SIZE,building.y*MINIMAP_TILE_SIZE,MINIMAP_TILE_SIZE*bi->width,MINIMAP_TILE_SIZE*bi->height,PALETTE_WHITE);
+				// power plants always show the icon, unpowered buildings flash it
+				if(showpower==true && building.type==Powerplant)
 				{
-					*DRAW_COLORS=PALETTE_BLACK;
-					line(offsetx+1+(x*3),1+(y*3),offsetx+1+(x*3),1+(y*3));
-					if(x>0 && (GetConnections(x-1,y) & RoadMask)==RoadMask)
-					{
-						line(offsetx+(x*3),1+(y*3),offsetx+(x*3),1+(y*3));
-					}
-					if(x<MAP_WIDTH-1 && (GetConnections(x+1,y) & RoadMask)==RoadMask)
-					{
-						line(offsetx+2+(x*3),1+(y*3),offsetx+2+(x*3),1+(y*3));
-					}
-					if(y>0 && (GetConnections(x,y-1) & RoadMask)==RoadMask)
-					{
-						line(offsetx+1+(x*3),(y*3),offsetx+1+(x*3),(y*3));
-					}
-					if(y<MAP_HEIGHT-1 && (GetConnections(x,y+1) & RoadMask)==RoadMask)
-					{
-						line(offsetx+1+(x*3),2+(y*3),offsetx+1+(x*3),2+(y*3));
-					}
+					SurfaceDrawTile(MinimapSurface,GetTileData(POWERCUT_TILE),building.x*MINIMAP_TILE_SIZE,building.y*MINIMAP_TILE_SIZE,(PALETTE_WHITE << 4) | PALETTE_BLACK);
 				}
-			}
-
-			if(showpower==true)
-			{
-				uint8_t connections=GetConnections(x,y);
-				if((connections & PowerlineMask) == PowerlineMask)
+				if(showfdrange==true && IsInFireDeptRange(i))
 				{
-					*DRAW_COLORS=PALETTE_WHITE;
-					line(offsetx+1+(x*3),1+(y*3),offsetx+1+(x*3),1+(y*3));
-					if(x>0 && (GetConnections(x-1,y) & PowerlineMask)==PowerlineMask)
+					MinimapFDRange[i >> 3]|=(1 << (i & 7));
+					// fire depts flash the icon
+					if(building.type!=FireDept)
 					{
-						line(offsetx+(x*3),1+(y*3),offsetx+(x*3),1+(y*3));
-					}
-					if(x<MAP_WIDTH-1 && (GetConnections(x+1,y) & PowerlineMask)==PowerlineMask)
-					{
-						line(offsetx+2+(x*3),1+(y*3),offsetx+2+(x*3),1+(y*3));
-					}
-					if(y>0 && (GetConnections(x,y-1) & PowerlineMask)==PowerlineMask)
-					{
-						line(offsetx+1+(x*3),(y*3),offsetx+1+(x*3),(y*3));
-					}
-					if(y<MAP_HEIGHT-1 && (GetConnections(x,y+1) & PowerlineMask)==PowerlineMask)
-					{
-						line(offsetx+1+(x*3),2+(y*3),offsetx+1+(x*3),2+(y*3));
+						SurfaceDrawTile(MinimapSurface,GetTileData(247),building.x*MINIMAP_TILE_SIZE,building.y*MINIMAP_TILE_SIZE,(PALETTE_WHITE << 4) | PALETTE_BLACK);
 					}
 				}
 			}
+		}
+	}
+
+	const uint8_t *field=GetField(overlay);
+	if(field!=nullptr)
+	{
+		DrawMinimapOverlay(field);
+	}
+}
+
+void DrawMapMenu()
+{
+	bool showbuildings=(State.flags & FLAG_MAP_SHOWBUILDINGS)==FLAG_MAP_SHOWBUILDINGS;
+	bool showroads=(State.flags & FLAG_MAP_SHOWROADS)==FLAG_MAP_SHOWROADS;
+	bool showpower=(State.flags & FLAG_MAP_SHOWELECTRIC)==FLAG_MAP_SHOWELECTRIC;
+	bool showfdrange=(State.flags & FLAG_MAP_SHOWFDRANGE)==FLAG_MAP_SHOWFDRANGE;
+
+	const int32_t offsetx=(SCREEN_SIZE-(MINIMAP_TILE_SIZE*MAP_WIDTH))/2;
 
+	SetDrawColors((PALETTE_WHITE << 4) | PALETTE_WHITE);
+	rect(0,0,SCREEN_SIZE,SCREEN_SIZE);
+
+	const uint8_t flags=State.flags & (FLAG_MAP_SHOWBUILDINGS | FLAG_MAP_SHOWROADS | FLAG_MAP_SHOWELECTRIC | FLAG_MAP_SHOWFDRANGE);
+	if(MinimapSurface.data==nullptr)
+	{
+		MinimapSurface.data=(uint8_t *)malloc(GetSurfaceSize(MinimapSurface.width,MinimapSurface.height));
+		if(MinimapSurface.data==nullptr)
+		{
+			return;
 		}
+		MinimapVersion=MapVersion-1;
 	}
+	const bool showsstats=UIState.mapOverlay!=Field_None || showfdrange==true;
+	if(MinimapVersion!=MapVersion || MinimapFlags!=flags || MinimapOverlay!=UIState.mapOverlay || (showsstats==true && MinimapStatsVersion!=CityStatsVersion))
+	{
+		RenderMinimap(flags,UIState.mapOverlay);
+		MinimapVersion=MapVersion;
+		MinimapStatsVersion=CityStatsVersion;
+		MinimapFlags=flags;
+		MinimapOverlay=UIState.mapOverlay;
+	}
+	BlitSurface(MinimapSurface,offsetx,0);
 
-	if(showbuildings==true)
+	// flashing icons - each building's icons are redrawn in the same order as the cached ones so they overlap the same way
+	if(showbuildings==true && (AnimationFrame & 8))
 	{
 		for(int i=0; i<MAX_BUILDINGS; i++)
 		{
-			if(State.buildings[i].type!=BuildingType_None)
+			const Building &building=State.buildings[i];
+			if(building.type==BuildingType_None)
 			{
-				const BuildingInfo *bi=GetBuildingInfo(State.buildings[i].type);
-				*DRAW_COLORS=(PALETTE_WHITE << 4) | PALETTE_WHITE;
-				rect(offsetx+(State.buildings[i].x*3),(State.buildings[i].y*3),3*bi->width,3*bi->height);
-				if(showpower==true && State.buildings[i].type != Park && !IsRubble(State.buildings[i].type))
+				continue;
+			}
+
+			const bool powericon=showpower==true && HasMinimapPowerIcon(building);
+			const bool fdicon=showfdrange==true && HasMinimapFDIcon(i);
+			if((powericon && building.type!=Powerplant) || (fdicon && building.type==FireDept) || building.onFire)
+			{
+				if(powericon==true)
 				{
-					if(State.buildings[i].type==Powerplant || (State.buildings[i].hasPower==false && (AnimationFrame & 8)))
-					{
-						DrawTile(POWERCUT_TILE,offsetx+(State.buildings[i].x*3),(State.buildings[i].y*3),PALETTE_BLACK,PALETTE_WHITE,false);
-					}
+					DrawTile(POWERCUT_TILE,offsetx+(building.x*MINIMAP_TILE_SIZE),(building.y*MINIMAP_TILE_SIZE),PALETTE_BLACK,PALETTE_WHITE,false);
 				}
-				if(showfdrange==true)
+				if(fdicon==true)
 				{
-					uint8_t closestdistance = 0xff;
-					for(int j=0; j<MAX_BUILDINGS; j++)
-					{
-						if(i!=j && State.buildings[j].type==FireDept && State.buildings[j].hasPower==true)
-						{
-							uint8_t dist=GetManhattanDistance(&State.buildings[i],&State.buildings[j]);
-							if(dist<closestdistance)
-							{
-								closestdistance=dist;
-							}
-						}
-					}
-					
-					//calc from Simulation.cpp - SimulateBuilding
-					int fireDeptInfluence = SIM_FIRE_DEPT_BASE_INFLUENCE + closestdistance * SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER;
-
-					if(fireDeptInfluence <= 255 || (State.buildings[i].type==FireDept && State.buildings[i].hasPower==true))
-					{
-						// draw fire extingisher icon - if building is a fire dept, then flash icon
-						if(State.buildings[i].type!=FireDept || (AnimationFrame & 8))
-						{
-							DrawTile(247,offsetx+(State.buildings[i].x*3),(State.buildings[i].y*3),PALETTE_BLACK,PALETTE_WHITE,false);
-						}
-					}
-
+					DrawTile(247,offsetx+(building.x*MINIMAP_TILE_SIZE),(building.y*MINIMAP_TILE_SIZE),PALETTE_BLACK,PALETTE_WHITE,false);
 				}
 				// if on fire - show flasing fire icon
-				//if(State.buildings[i].onFire)
-				if(State.buildings[i].onFire && (AnimationFrame & 8))
+				if(building.onFire)
 				{
-					DrawTile(FIRST_FIRE_TILE,offsetx+(State.buildings[i].x*3),(State.buildings[i].y*3),PALETTE_BLACK,PALETTE_WHITE,false);
-					//const uint8_t tile = FIRST_FIRE_TILE + ((tile - FIRST_FIRE_TILE + (AnimationFrame >> 3)) & 3)
+					DrawTile(FIRST_FIRE_TILE,offsetx+(building.x*MINIMAP_TILE_SIZE),(building.y*MINIMAP_TILE_SIZE),PALETTE_BLACK,PALETTE_WHITE,false);
 				}
 			}
 		}
@@ -1498,6 +1986,8 @@ void DrawMapMenu()
 	DrawString("Roads",18,SCREEN_SIZE-7);
 	DrawString("Electric",SCREEN_SIZE/2+9,SCREEN_SIZE-15);
 	DrawString("FD Range",SCREEN_SIZE/2+9,SCREEN_SIZE-7);
+	DrawString("Overlay",SCREEN_SIZE-31,SCREEN_SIZE-15);
+	DrawString(GetFieldName(UIState.mapOverlay),SCREEN_SIZE-35,SCREEN_SIZE-7);
 
 	if(showbuildings==true)
 	{
@@ -1515,6 +2005,10 @@ void DrawMapMenu()
 	{
 		DrawString("*",SCREEN_SIZE/2+1,SCREEN_SIZE-7);
 	}
+	if(UIState.mapOverlay!=Field_None)
+	{
+		DrawString("*",SCREEN_SIZE-38,SCREEN_SIZE-15);
+	}
 
 	int32_t xpos=9;
 	int32_t ypos=SCREEN_SIZE-16;
@@ -1531,6 +2025,10 @@ void DrawMapMenu()
 	case 3:
 		xpos=SCREEN_SIZE/2-1;
 		ypos=SCREEN_SIZE-8;
+		break;
+	case 4:
+		xpos=SCREEN_SIZE-39;
+		break;
 	}
 	DrawCursorRect(xpos, ypos, 7, 7);
 }
@@ -1549,6 +2047,7 @@ void Draw()
 	case InGame:
 	case InGameDisaster:
 	case ShowingToolbar:
+	case DrawingStroke:
 		DrawInGame();
 		break;
 	case SaveLoadMenu:
@@ -1569,6 +2068,15 @@ void Draw()
 		break;
 	}
 
+#ifdef DEBUG
+	// host calls made by the draw helpers, reported about once a second
+	if ((AnimationFrame & 63) == 0)
+	{
+		tracef("draw calls: %d blits, %d lines, %d rects, %d color writes (%d skipped)", DrawCallCounts.Blits, DrawCallCounts.Lines, DrawCallCounts.Rects, DrawCallCounts.ColorWrites, DrawCallCounts.ColorWritesSkipped);
+	}
+	DrawCallCounts = {};
+#endif
+
 	AnimationFrame++;
 
 }
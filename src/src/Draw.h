@@ -4,7 +4,27 @@
 
 #include "Building.h"
 
+#ifdef DEBUG
+// Host draw calls made during the current frame, traced by Draw()
+struct DrawCallCounters
+{
+	uint16_t Blits;
+	uint16_t Lines;
+	uint16_t Rects;
+	uint16_t ColorWrites;
+	uint16_t ColorWritesSkipped;
+};
+extern DrawCallCounters DrawCallCounts;
+#define COUNT_DRAW_CALL(counter) DrawCallCounts.counter++
+#else
+#define COUNT_DRAW_CALL(counter)
+#endif
+
 void PutPixel(int32_t x, int32_t y, uint8_t color);
+// Sets DRAW_COLORS, skipping the write if it already has that value - always use this instead of writing DRAW_COLORS directly
+void SetDrawColors(uint16_t colors);
+void DrawHLine(int32_t x, int32_t y, int32_t len, uint8_t color);
+void DrawVLine(int32_t x, int32_t y, int32_t len, uint8_t color);
 void DrawFilledRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color);
 void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color);
 void DrawBitmap(const uint8_t* bmp, int32_t x, int32_t y, int32_t w, int32_t h, uint8_t fg, uint8_t bg);
@@ -12,8 +32,12 @@ void DrawBitmap(const uint8_t* bmp, int32_t x, int32_t y, int32_t w, int32_t h,
 void Draw(void);
 
 void ResetVisibleTileCache(void);
+// Final tile for a map cell, from the resolved tile layer when it's enabled
+uint8_t GetResolvedTile(int x, int y);
+void RegisterDrawListeners(void);
 void RefreshBuildingTiles(Building* building);
 void RefreshTile(uint8_t x, uint8_t y);
 void RefreshTileAndConnectedNeighbours(uint8_t x, uint8_t y);
+void RefreshTileArea(int x, int y, int width, int height);
 
 void SetTile(uint8_t x, uint8_t y, uint8_t tile);
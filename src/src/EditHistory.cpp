@@ -0,0 +1,338 @@
+#include "EditHistory.h"
+#include "Game.h"
+#include "Draw.h"
+#include "Arena.h"
+#include "Connectivity.h"
+#include "Snapshot.h"
+#include "WorldEvents.h"
+#include "wasmmemcpy.h"
+#include "wasm4.h"
+
+// A record is its length, the cell and building counts and the money change (int16, low byte first), then a before and
+// after Building for each changed slot, then 2 bytes for each changed cell - the tile index in the low 12 bits, the old
+// connections in the next 2 and the new in the top 2. The length is repeated at the end so undo can step backwards
+#define EDIT_HEADER_SIZE 5
+#define EDIT_RECORD_MAX_SIZE 255		// the length is a byte
+
+static uint8_t History[EDIT_HISTORY_SIZE];
+// Byte positions that only ever go up, the buffer index is the position modulo the size
+// Undo goes back from the cursor, redo forward from it towards the end
+static uint16_t HistoryBegin = 0;
+static uint16_t HistoryCursor = 0;
+static uint16_t HistoryEnd = 0;
+
+// The city as it was when BeginEdit() was called, in the scratch arena
+static uint8_t* EditConnectionMap = nullptr;
+static Building* EditBuildings = nullptr;
+static int32_t EditMoney = 0;
+static size_t EditScratchMark = 0;
+
+static_assert((EDIT_HISTORY_SIZE & (EDIT_HISTORY_SIZE - 1)) == 0 && EDIT_HISTORY_SIZE <= 65536, "positions wrap at 65536");
+static_assert(MAP_WIDTH * MAP_HEIGHT <= 4096, "tile index has to fit 12 bits");
+static_assert(EDIT_HEADER_SIZE + EDIT_MAX_CELLS * 2 + 1 <= EDIT_RECORD_MAX_SIZE, "EDIT_MAX_CELLS has to fit a record");
+
+void ClearEditHistory()
+{
+	HistoryBegin = HistoryCursor = HistoryEnd = 0;
+}
+
+bool CanUndoEdit()
+{
+	return HistoryCursor != HistoryBegin;
+}
+
+bool CanRedoEdit()
+{
+	return HistoryCursor != HistoryEnd;
+}
+
+bool CanRecordEdit(const uint16_t cellCount, const uint16_t buildingCount)
+{
+	return EDIT_HEADER_SIZE + buildingCount * 2 * sizeof(Building) + cellCount * 2 + 1 <= EDIT_RECORD_MAX_SIZE;
+}
+
+void BeginEdit()
+{
+	const GameState& state = MainCity.state;
+
+	EditScratchMark = ScratchMark();
+	EditConnectionMap = (uint8_t*)ScratchAlloc(sizeof(state.connectionMap));
+	EditBuildings = (Building*)ScratchAlloc(sizeof(state.buildings));
+	if (EditConnectionMap == nullptr || EditBuildings == nullptr)
+	{
+		EditConnectionMap = nullptr;
+		return;
+	}
+	memcpy(EditConnectionMap, state.connectionMap, sizeof(state.connectionMap));
+	memcpy(EditBuildings, state.buildings, sizeof(state.buildings));
+	EditMoney = state.money;
+}
+
+static void PushRecord(const uint8_t* record, const uint8_t length)
+{
+	// a new edit loses whatever could have been redone, then the oldest edits go until it fits
+	HistoryEnd = HistoryCursor;
+	while ((uint16_t)(HistoryEnd - HistoryBegin) + length > EDIT_HISTORY_SIZE)
+	{
+		HistoryBegin += History[HistoryBegin % EDIT_HISTORY_SIZE];
+	}
+	for (int n = 0; n < length; n++)
+	{
+		History[(uint16_t)(HistoryEnd + n) % EDIT_HISTORY_SIZE] = record[n];
+	}
+	HistoryEnd += length;
+	HistoryCursor = HistoryEnd;
+}
+
+static bool IsSameBuilding(const Building& a, const Building& b)
+{
+	const uint8_t* bytesA = (const uint8_t*)&a;
+	const uint8_t* bytesB = (const uint8_t*)&b;
+	for (int n = 0; n < (int)sizeof(Building); n++)
+	{
+		if (bytesA[n] != bytesB[n])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void EndEdit()
+{
+	if (EditConnectionMap == nullptr)
+	{
+		// couldn't keep a copy to compare with, so the history before this edit can't be trusted any more
+		trace("undo: no scratch space to diff the edit, history cleared");
+		ClearEditHistory();
+		ScratchRelease(EditScratchMark);
+		return;
+	}
+
+	const GameState& state = MainCity.state;
+	uint8_t record[EDIT_RECORD_MAX_SIZE];
+	uint8_t length = EDIT_HEADER_SIZE;
+	uint8_t buildingCount = 0;
+	uint8_t cellCount = 0;
+	bool tooBig = false;
+
+	for (int n = 0; n < MAX_BUILDINGS && !tooBig; n++)
+	{
+		if (!IsSameBuilding(EditBuildings[n], state.buildings[n]))
+		{
+			tooBig = length + 2 * sizeof(Building) > EDIT_RECORD_MAX_SIZE - 1;
+			if (!tooBig)
+			{
+				memcpy(&record[length], &EditBuildings[n], sizeof(Building));
+				memcpy(&record[length + sizeof(Building)], &state.buildings[n], sizeof(Building));
+				length += 2 * sizeof(Building);
+				buildingCount++;
+			}
+		}
+	}
+
+	for (int n = 0; n < (int)sizeof(state.connectionMap) && !tooBig; n++)
+	{
+		if (EditConnectionMap[n] == state.connectionMap[n])
+		{
+			continue;
+		}
+		for (int cell = 0; cell < 4 && !tooBig; cell++)
+		{
+			const uint8_t before = (EditConnectionMap[n] >> (cell * 2)) & 3;
+			const uint8_t after = (state.connectionMap[n] >> (cell * 2)) & 3;
+			if (before != after)
+			{
+				tooBig = length + 2 > EDIT_RECORD_MAX_SIZE - 1;
+				if (!tooBig)
+				{
+					const uint16_t value = (n * 4 + cell) | (before << 12) | (after << 14);
+					record[length++] = value & 0xff;
+					record[length++] = value >> 8;
+					cellCount++;
+				}
+			}
+		}
+	}
+
+	const int32_t moneyChange = state.money - EditMoney;
+	ScratchRelease(EditScratchMark);
+	EditConnectionMap = nullptr;
+
+	if (tooBig || moneyChange < INT16_MIN || moneyChange > INT16_MAX)
+	{
+		trace("undo: edit too big to keep, history cleared");
+		ClearEditHistory();
+		return;
+	}
+	if (buildingCount == 0 && cellCount == 0 && moneyChange == 0)
+	{
+		return;
+	}
+
+	record[0] = length + 1;
+	record[1] = cellCount;
+	record[2] = buildingCount;
+	record[3] = moneyChange & 0xff;
+	record[4] = (moneyChange >> 8) & 0xff;
+	record[length++] = record[0];
+	PushRecord(record, length);
+}
+
+static int FindBuildingSlot(const Building& building)
+{
+	const GameState& state = MainCity.state;
+	for (int n = 0; n < MAX_BUILDINGS; n++)
+	{
+		const Building& other = state.buildings[n];
+		if (other.type == building.type && other.x == building.x && other.y == building.y)
+		{
+			return n;
+		}
+	}
+	return -1;
+}
+
+// Takes the city from one side of the edit to the other, after checking it's still on the side it's coming from
+static bool ApplyEdit(const uint8_t* record, const bool undo, uint8_t& outX, uint8_t& outY)
+{
+	GameState& state = MainCity.state;
+	const uint8_t cellCount = record[1];
+	const uint8_t buildingCount = record[2];
+	const int16_t moneyChange = (int16_t)(record[3] | (record[4] << 8));
+	const int32_t money = state.money + (undo ? -moneyChange : moneyChange);
+	const uint8_t* cells = &record[EDIT_HEADER_SIZE + buildingCount * 2 * sizeof(Building)];
+
+	// redoing has to be affordable, like the edit was
+	if (!undo && moneyChange < 0 && money < 0)
+	{
+		return false;
+	}
+
+	int slots[EDIT_RECORD_MAX_SIZE / (2 * sizeof(Building))];
+	int emptyNeeded = 0;
+	for (int n = 0; n < buildingCount; n++)
+	{
+		Building from, to;
+		memcpy(&from, &record[EDIT_HEADER_SIZE + n * 2 * sizeof(Building) + (undo ? sizeof(Building) : 0)], sizeof(Building));
+		memcpy(&to, &record[EDIT_HEADER_SIZE + n * 2 * sizeof(Building) + (undo ? 0 : sizeof(Building))], sizeof(Building));
+		slots[n] = from.type != BuildingType_None ? FindBuildingSlot(from) : -1;
+		if (from.type != BuildingType_None && slots[n] < 0)
+		{
+			return false;
+		}
+		if (from.type == BuildingType_None && to.type != BuildingType_None)
+		{
+			emptyNeeded++;
+		}
+	}
+	for (int n = 0; n < MAX_BUILDINGS && emptyNeeded > 0; n++)
+	{
+		emptyNeeded -= state.buildings[n].type == BuildingType_None ? 1 : 0;
+	}
+	if (emptyNeeded > 0)
+	{
+		return false;
+	}
+	for (int n = 0; n < cellCount; n++)
+	{
+		const uint16_t value = cells[n * 2] | (cells[n * 2 + 1] << 8);
+		const int index = value & 0xfff;
+		if (GetConnections(MainCity, index % MAP_WIDTH, index / MAP_WIDTH) != ((value >> (undo ? 14 : 12)) & 3))
+		{
+			return false;
+		}
+	}
+
+	// buildings go first so their footprints can change, then come back once the cells are as they were
+	for (int n = 0; n < buildingCount; n++)
+	{
+		if (slots[n] >= 0)
+		{
+			Building* building = &state.buildings[slots[n]];
+			PostBuildingEvent(MainCity, WorldEvent_BuildingRemoved, building);
+			SnapshotBeforeWrite(MainCity, building, sizeof(Building));
+			// an emptied slot gets back exactly what it held, so the next diff doesn't see a change
+			memcpy(building, &record[EDIT_HEADER_SIZE + n * 2 * sizeof(Building) + (undo ? 0 : sizeof(Building))], sizeof(Building));
+			building->type = BuildingType_None;
+		}
+	}
+	for (int n = 0; n < cellCount; n++)
+	{
+		const uint16_t value = cells[n * 2] | (cells[n * 2 + 1] << 8);
+		const int index = value & 0xfff;
+		outX = index % MAP_WIDTH;
+		outY = index / MAP_WIDTH;
+		SetConnections(MainCity, outX, outY, (value >> (undo ? 12 : 14)) & 3);
+		RefreshTileAndConnectedNeighbours(outX, outY);
+	}
+	for (int n = 0; n < buildingCount; n++)
+	{
+		Building to;
+		memcpy(&to, &record[EDIT_HEADER_SIZE + n * 2 * sizeof(Building) + (undo ? 0 : sizeof(Building))], sizeof(Building));
+		if (to.type == BuildingType_None)
+		{
+			continue;
+		}
+		int slot = slots[n];
+		for (int s = 0; s < MAX_BUILDINGS && slot < 0; s++)
+		{
+			slot = state.buildings[s].type == BuildingType_None ? s : -1;
+		}
+		Building* building = &state.buildings[slot];
+		SnapshotBeforeWrite(MainCity, building, sizeof(Building));
+		*building = to;
+		PostBuildingEvent(MainCity, WorldEvent_BuildingPlaced, building);
+		outX = to.x + 1;
+		outY = to.y + 1;
+	}
+
+	state.money = money;
+	return true;
+}
+
+static void ReadRecord(const uint16_t start, const uint8_t length, uint8_t* record)
+{
+	for (int n = 0; n < length; n++)
+	{
+		record[n] = History[(uint16_t)(start + n) % EDIT_HISTORY_SIZE];
+	}
+}
+
+bool UndoEdit(uint8_t& outX, uint8_t& outY)
+{
+	if (!CanUndoEdit())
+	{
+		return false;
+	}
+	uint8_t record[EDIT_RECORD_MAX_SIZE];
+	const uint8_t length = History[(uint16_t)(HistoryCursor - 1) % EDIT_HISTORY_SIZE];
+	const uint16_t start = HistoryCursor - length;
+	ReadRecord(start, length, record);
+	if (!ApplyEdit(record, true, outX, outY))
+	{
+		// the edits before this one build on it, so none of them can be undone either
+		HistoryBegin = HistoryCursor;
+		return false;
+	}
+	HistoryCursor = start;
+	return true;
+}
+
+bool RedoEdit(uint8_t& outX, uint8_t& outY)
+{
+	if (!CanRedoEdit())
+	{
+		return false;
+	}
+	uint8_t record[EDIT_RECORD_MAX_SIZE];
+	const uint8_t length = History[HistoryCursor % EDIT_HISTORY_SIZE];
+	ReadRecord(HistoryCursor, length, record);
+	if (!ApplyEdit(record, false, outX, outY))
+	{
+		HistoryEnd = HistoryCursor;
+		return false;
+	}
+	HistoryCursor += length;
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// Undo and redo for the player's edits to MainCity (bulldozing, roads, power lines and buildings)
+// Each edit is kept as a small diff - the connection map cells it changed, the building slots before and after, and what
+// it cost - in a ring buffer that forgets the oldest edits when it fills up
+#define EDIT_HISTORY_SIZE 512			// bytes, a power of 2 - a road tile takes 8, a 3x3 building 30, a stroke across the map 196
+
+// The most connection cells one edit can change, if it changes no buildings
+#define EDIT_MAX_CELLS 124
+
+// Wrap an edit in these, the diff is worked out by EndEdit() so the edit itself needn't know about the history
+// An edit too big to keep can't be undone, and neither can any before it, so the history is cleared
+void BeginEdit(void);
+void EndEdit(void);
+// Whether an edit that changes this many connection cells and building slots can be kept, check before making it
+bool CanRecordEdit(uint16_t cellCount, uint16_t buildingCount);
+
+bool CanUndoEdit(void);
+bool CanRedoEdit(void);
+// Put the edit back, refunding or charging what it cost. Returns false if there was nothing to undo or redo, or the city
+// has changed too much since (a fire, the edit's cells built over) - the history that no longer applies is dropped
+// outX, outY are where the edit was
+bool UndoEdit(uint8_t& outX, uint8_t& outY);
+bool RedoEdit(uint8_t& outX, uint8_t& outY);
+
+// For a new or loaded city
+void ClearEditHistory(void);
@@ -0,0 +1,391 @@
+#include "Fields.h"
+#include "Game.h"
+#include "Simulation.h"
+#include "wasmmalloc.h"
+
+const char FieldNoneStr[] = "None";
+const char FieldPollutionStr[] = "Pollution";
+const char FieldCrimeStr[] = "Crime";
+const char FieldLandValueStr[] = "Land Val";
+const char FieldTrafficStr[] = "Traffic";
+
+// Field values for the whole map - MAP_WIDTH*MAP_HEIGHT bytes allocated the first time a field is shown
+uint8_t *FieldData = nullptr;
+uint8_t FieldDataType = Field_None;
+uint32_t FieldDataVersion = 0;
+uint32_t FieldDataStatsVersion = 0;
+
+// Kernels are added to a row as second differences and then integrated twice, so adding a tent or a span
+// costs the same no matter how wide it is, and a whole field is one pass over the buildings per row
+// The margin lets tents hang off the edge of the map without being clipped
+#define FIELD_ROW_MARGIN 64
+#define FIELD_ROW_SIZE (MAP_WIDTH + FIELD_ROW_MARGIN * 2)
+int16_t FieldRows[2][FIELD_ROW_SIZE];
+
+const char* GetFieldName(uint8_t type)
+{
+	switch (type)
+	{
+	default:
+	case Field_None: return FieldNoneStr;
+	case Field_Pollution: return FieldPollutionStr;
+	case Field_Crime: return FieldCrimeStr;
+	case Field_LandValue: return FieldLandValueStr;
+	case Field_Traffic: return FieldTrafficStr;
+	}
+}
+
+void ClearFieldRow(int16_t *row)
+{
+	for(int i=0; i<FIELD_ROW_SIZE; i++)
+	{
+		row[i]=0;
+	}
+}
+
+// adds max(0, height - |x - cx|) to the row
+void AddFieldRowTent(int16_t *row, int32_t cx, int32_t height)
+{
+	if(height<=0)
+	{
+		return;
+	}
+	if(height>=FIELD_ROW_MARGIN)
+	{
+		height=FIELD_ROW_MARGIN-1;
+	}
+
+	row+=FIELD_ROW_MARGIN+cx;
+	row[1-height]+=1;
+	row[1]-=2;
+	row[1+height]+=1;
+}
+
+// adds val to x1 <= x <= x2
+void AddFieldRowSpan(int16_t *row, int32_t x1, int32_t x2, int16_t val)
+{
+	if(x1<0)
+	{
+		x1=0;
+	}
+	if(x2>=MAP_WIDTH)
+	{
+		x2=MAP_WIDTH-1;
+	}
+	if(x1>x2)
+	{
+		return;
+	}
+
+	row+=FIELD_ROW_MARGIN;
+	row[x1]+=val;
+	row[x1+1]-=val;
+	row[x2+1]-=val;
+	row[x2+2]+=val;
+}
+
+// turns the second differences into values - afterwards row[FIELD_ROW_MARGIN+x] is the value at x
+void IntegrateFieldRow(int16_t *row)
+{
+	for(int pass=0; pass<2; pass++)
+	{
+		int16_t sum=0;
+		for(int i=0; i<FIELD_ROW_SIZE; i++)
+		{
+			sum+=row[i];
+			row[i]=sum;
+		}
+	}
+}
+
+inline uint8_t ScaleFieldValue(int32_t val, int32_t max)
+{
+	if(val<=0)
+	{
+		return 0;
+	}
+	if(val>=max)
+	{
+		return 255;
+	}
+	return (val*255)/max;
+}
+
+inline int32_t Abs(int32_t val)
+{
+	return val<0 ? -val : val;
+}
+
+inline bool IsZoned(const Building &building)
+{
+	return building.type==Residential || building.type==Commercial || building.type==Industrial;
+}
+
+// same sources and strengths as SimulateBuilding()
+int32_t GetPollutionStrength(const Building &building)
+{
+	if(building.type==BuildingType_None || !(building.hasPower || building.type==Park) || building.onFire)
+	{
+		return 0;
+	}
+	if(building.type==Industrial)
+	{
+		return SIM_INDUSTRIAL_BASE_POLLUTION + building.populationDensity;
+	}
+	if(building.type==Powerplant)
+	{
+		return SIM_POWERPLANT_BASE_POLLUTION;
+	}
+	if(building.heavyTraffic)
+	{
+		return SIM_TRAFFIC_BASE_POLLUTION;
+	}
+	return 0;
+}
+
+// sum of max(0, strength - manhattan distance) over all sources, like the simulation
+void AccumulatePollutionRow(int16_t *row, int32_t y)
+{
+	ClearFieldRow(row);
+	for(int i=0; i<MAX_BUILDINGS; i++)
+	{
+		const int32_t strength=GetPollutionStrength(State.buildings[i]);
+		if(strength>0)
+		{
+			AddFieldRowTent(row,State.buildings[i].x,strength-Abs(y-State.buildings[i].y));
+		}
+	}
+	IntegrateFieldRow(row);
+}
+
+// Manhattan distance to the closest working police dept, as a two pass distance transform
+void CalculatePoliceDistance(uint8_t *dist)
+{
+	for(int i=0; i<MAP_WIDTH*MAP_HEIGHT; i++)
+	{
+		dist[i]=0xff;
+	}
+	for(int i=0; i<MAX_BUILDINGS; i++)
+	{
+		const Building &building=State.buildings[i];
+		if(building.type==PoliceDept && building.hasPower && !building.onFire)
+		{
+			dist[(building.y*MAP_WIDTH)+building.x]=0;
+		}
+	}
+
+	for(int y=0; y<MAP_HEIGHT; y++)
+	{
+		for(int x=0; x<MAP_WIDTH; x++)
+		{
+			uint8_t *d=&dist[(y*MAP_WIDTH)+x];
+			if(x>0 && d[-1]<*d-1)
+			{
+				*d=d[-1]+1;
+			}
+			if(y>0 && d[-MAP_WIDTH]<*d-1)
+			{
+				*d=d[-MAP_WIDTH]+1;
+			}
+		}
+	}
+	for(int y=MAP_HEIGHT-1; y>=0; y--)
+	{
+		for(int x=MAP_WIDTH-1; x>=0; x--)
+		{
+			uint8_t *d=&dist[(y*MAP_WIDTH)+x];
+			if(x<MAP_WIDTH-1 && d[1]<*d-1)
+			{
+				*d=d[1]+1;
+			}
+			if(y<MAP_HEIGHT-1 && d[MAP_WIDTH]<*d-1)
+			{
+				*d=d[MAP_WIDTH]+1;
+			}
+		}
+	}
+}
+
+// crime as calculated in SimulateBuilding() for a building with the given police distance
+int32_t CalculateCrime(uint8_t populationDensity, uint8_t policeDistance)
+{
+	// the simulation starts looking for police depts at this distance
+	if(policeDistance>24)
+	{
+		policeDistance=24;
+	}
+
+	int32_t crime=populationDensity*(policeDistance-16);
+	if(crime>SIM_MAX_CRIME)
+	{
+		crime=SIM_MAX_CRIME;
+	}
+	else if(crime<0)
+	{
+		crime=0;
+	}
+	return crime;
+}
+
+void CalculatePollutionField(uint8_t *field)
+{
+	int16_t *row=FieldRows[0];
+	for(int y=0; y<MAP_HEIGHT; y++)
+	{
+		AccumulatePollutionRow(row,y);
+		for(int x=0; x<MAP_WIDTH; x++)
+		{
+			field[(y*MAP_WIDTH)+x]=ScaleFieldValue(row[FIELD_ROW_MARGIN+x],SIM_MAX_POLLUTION);
+		}
+	}
+}
+
+// crime is only shown on populated buildings, over their whole footprint
+void CalculateCrimeField(uint8_t *field)
+{
+	uint8_t crime[MAX_BUILDINGS];
+
+	CalculatePoliceDistance(field);
+	for(int i=0; i<MAX_BUILDINGS; i++)
+	{
+		Building *building=&State.buildings[i];
+		crime[i]=0;
+		if(IsZoned(*building) && building->hasPower && !building->onFire)
+		{
+			const uint8_t distance=GetNumRoadConnections(MainCity,building)>=3 ? field[(building->y*MAP_WIDTH)+building->x] : 0xff;
+			crime[i]=ScaleFieldValue(CalculateCrime(building->populationDensity,distance),SIM_MAX_CRIME);
+		}
+	}
+
+	for(int i=0; i<MAP_WIDTH*MAP_HEIGHT; i++)
+	{
+		field[i]=0;
+	}
+	for(int i=0; i<MAX_BUILDINGS; i++)
+	{
+		if(crime[i]>0)
+		{
+			const Building &building=State.buildings[i];
+			const BuildingInfo *info=GetBuildingInfo(building.type);
+			for(int y=building.y; y<building.y+info->height && y<MAP_HEIGHT; y++)
+			{
+				for(int x=building.x; x<building.x+info->width && x<MAP_WIDTH; x++)
+				{
+					field[(y*MAP_WIDTH)+x]=crime[i];
+				}
+			}
+		}
+	}
+}
+
+// How a residential building at each tile would be affected by its surroundings, centred on 128
+// Parks and stadiums within SIM_LOCAL_BUILDING_DISTANCE raise it, pollution and crime (at average density) lower it
+void CalculateLandValueField(uint8_t *field)
+{
+	int16_t *pollution=FieldRows[0];
+	int16_t *amenities=FieldRows[1];
+
+	CalculatePoliceDistance(field);
+	for(int y=0; y<MAP_HEIGHT; y++)
+	{
+		AccumulatePollutionRow(pollution,y);
+
+		ClearFieldRow(amenities);
+		for(int i=0; i<MAX_BUILDINGS; i++)
+		{
+			Building *building=&State.buildings[i];
+			if((building->type==Park || (building->type==Stadium && building->hasPower)) && !building->onFire)
+			{
+				const int32_t range=SIM_LOCAL_BUILDING_DISTANCE-Abs(y-building->y);
+				if(range>=0 && GetNumRoadConnections(MainCity,building)>=3)
+				{
+					AddFieldRowSpan(amenities,building->x-range,building->x+range,building->type==Park ? SIM_PARK_BOOST : SIM_STADIUM_BOOST);
+				}
+			}
+		}
+		IntegrateFieldRow(amenities);
+
+		for(int x=0; x<MAP_WIDTH; x++)
+		{
+			int32_t p=pollution[FIELD_ROW_MARGIN+x];
+			if(p>SIM_MAX_POLLUTION)
+			{
+				p=SIM_MAX_POLLUTION;
+			}
+			uint8_t *val=&field[(y*MAP_WIDTH)+x];
+			const int32_t score=amenities[FIELD_ROW_MARGIN+x]-(p*SIM_POLLUTION_INFLUENCE)-CalculateCrime(AVERAGE_POPULATION_DENSITY,*val);
+			*val=ScaleFieldValue(128+score,255);
+		}
+	}
+}
+
+// Populated buildings add their density to the tiles around them (the same area HasHighTraffic() checks)
+// Only road tiles are shown, a single building at SIM_HEAVY_TRAFFIC_THRESHOLD is half strength
+void CalculateTrafficField(uint8_t *field)
+{
+	int16_t *row=FieldRows[0];
+	for(int y=0; y<MAP_HEIGHT; y++)
+	{
+		ClearFieldRow(row);
+		for(int i=0; i<MAX_BUILDINGS; i++)
+		{
+			const Building &building=State.buildings[i];
+			if(IsZoned(building) && building.populationDensity>0 && !building.onFire)
+			{
+				const BuildingInfo *info=GetBuildingInfo(building.type);
+				if(y>=building.y-1 && y<=building.y+info->height)
+				{
+					AddFieldRowSpan(row,building.x-1,building.x+info->width,building.populationDensity);
+				}
+			}
+		}
+		IntegrateFieldRow(row);
+
+		for(int x=0; x<MAP_WIDTH; x++)
+		{
+			field[(y*MAP_WIDTH)+x]=(GetConnections(x,y) & RoadMask) ? ScaleFieldValue(row[FIELD_ROW_MARGIN+x],SIM_HEAVY_TRAFFIC_THRESHOLD*2) : 0;
+		}
+	}
+}
+
+const uint8_t* GetField(uint8_t type)
+{
+	if(type==Field_None || type>=Num_FieldTypes)
+	{
+		return nullptr;
+	}
+
+	if(FieldData==nullptr)
+	{
+		FieldData=(uint8_t *)malloc(MAP_WIDTH*MAP_HEIGHT);
+		if(FieldData==nullptr)
+		{
+			return nullptr;
+		}
+		FieldDataType=Field_None;
+	}
+
+	if(FieldDataType!=type || FieldDataVersion!=MapVersion || FieldDataStatsVersion!=CityStatsVersion)
+	{
+		switch(type)
+		{
+		case Field_Pollution:
+			CalculatePollutionField(FieldData);
+			break;
+		case Field_Crime:
+			CalculateCrimeField(FieldData);
+			break;
+		case Field_LandValue:
+			CalculateLandValueField(FieldData);
+			break;
+		case Field_Traffic:
+			CalculateTrafficField(FieldData);
+			break;
+		}
+		FieldDataType=type;
+		FieldDataVersion=MapVersion;
+		FieldDataStatsVersion=CityStatsVersion;
+	}
+
+	return FieldData;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per tile scalar fields that can be shown as overlays on the map screen
+enum FieldType
+{
+	Field_None = 0,
+	Field_Pollution,
+	Field_Crime,
+	Field_LandValue,
+	Field_Traffic,
+	Num_FieldTypes
+};
+
+// Returns MAP_WIDTH*MAP_HEIGHT values scaled 0-255, only recalculated when the type, MapVersion or CityStatsVersion changes
+// Returns nullptr for Field_None or if the field buffer couldn't be allocated
+const uint8_t* GetField(uint8_t type);
+const char* GetFieldName(uint8_t type);
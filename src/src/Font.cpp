@@ -7,6 +7,7 @@
 #include "Draw.h"
 #include "palette.h"
 #include "wasmstring.h"
+#include "Surface.h"
 
 // Font Definition
 const uint8_t font4x6[96][2] = {
@@ -134,88 +135,43 @@ unsigned char getFontLine(unsigned char data, int line_num) {
 
 static int32_t PrintX, PrintY;
 
-void DrawChar(char c)
-{
-	const uint8_t index = ((unsigned char)(c)) - 32;
-	uint8_t data1 = font4x6[index][0];
-	uint8_t data2 = font4x6[index][1];
-	int32_t y = PrintY;
+// font4x6 expanded by InitFont() into 1bpp 4x6 bitmaps with descenders already moved down a row
+// 2 rows of 4 pixels per byte, so each glyph is drawn with a single blit
+uint8_t FontGlyphs[96][(FONT_WIDTH * FONT_HEIGHT) / 8];
 
-	if (data2 & 1)	// Descender e.g. j, g
+void InitFont()
+{
+	for (int index = 0; index < 96; index++)
 	{
-		PutPixel(PrintX, y, PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data1 & 0x80) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x40) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data1 & 0x20) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data1 & 0x10) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x8) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data1 & 0x4) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data1 & 0x2) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x1) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x2) ? PALETTE_BLACK :PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data2 & 0x80) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data2 & 0x40) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x20) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data2 & 0x10) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data2 & 0x8) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x4) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
+		uint8_t rows[FONT_HEIGHT] = { 0 };
+		const uint8_t data1 = font4x6[index][0];
+		const uint8_t data2 = font4x6[index][1];
+		const int first = (data2 & 1) ? 1 : 0;		// Descender e.g. j, g
+
+		rows[first] = (data1 >> 4) & 0xE;
+		rows[first + 1] = (data1 >> 1) & 0xE;
+		rows[first + 2] = ((data1 & 0x03) << 2) | (data2 & 0x02);
+		rows[first + 3] = (data2 >> 4) & 0xE;
+		rows[first + 4] = (data2 >> 1) & 0xE;
+
+		for (int n = 0; n < FONT_HEIGHT / 2; n++)
+		{
+			FontGlyphs[index][n] = (rows[n * 2] << 4) | rows[n * 2 + 1];
+		}
 	}
-	else
-	{
-		PutPixel(PrintX, y, (data1 & 0x80) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x40) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data1 & 0x20) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data1 & 0x10) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x8) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data1 & 0x4) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data1 & 0x2) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data1 & 0x1) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x2) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data2 & 0x80) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data2 & 0x40) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x20) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
-
-		PutPixel(PrintX, y, (data2 & 0x10) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, (data2 & 0x8) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, (data2 & 0x4) ? PALETTE_BLACK : PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
-		y++;
+}
 
-		PutPixel(PrintX, y, PALETTE_WHITE);
-		PutPixel(PrintX + 1, y, PALETTE_WHITE);
-		PutPixel(PrintX + 2, y, PALETTE_WHITE);
-		PutPixel(PrintX + 3, y, PALETTE_WHITE);
+void DrawChar(char c)
+{
+	const uint8_t index = ((unsigned char)(c)) - 32;
+	if (DrawTarget != nullptr)
+	{
+		SurfaceBlit1BPP(*DrawTarget, FontGlyphs[index], PrintX - DrawTargetX, PrintY - DrawTargetY, FONT_WIDTH, FONT_HEIGHT, (PALETTE_BLACK << 4) | PALETTE_WHITE);
+		return;
 	}
+	SetDrawColors((PALETTE_BLACK << 4) | PALETTE_WHITE);
+	blit(FontGlyphs[index], PrintX, PrintY, FONT_WIDTH, FONT_HEIGHT, BLIT_1BPP);
+	COUNT_DRAW_CALL(Blits);
 }
 
 void DrawCharOld(char c)
@@ -277,14 +233,37 @@ int32_t DrawStringWrapped(const char *str, int32_t x, int32_t y, int32_t linehei
 	return lines;
 }
 
+// Lengths of recently centered strings, keyed by pointer - only string constants are passed to DrawStringCentered
+#define STRING_LENGTH_CACHE_SIZE 8
+static const char *StringLengthCacheStr[STRING_LENGTH_CACHE_SIZE];
+static uint8_t StringLengthCacheLen[STRING_LENGTH_CACHE_SIZE];
+static uint8_t StringLengthCacheNext = 0;
+
+size_t GetCachedStringLength(const char *str)
+{
+	for (int i = 0; i < STRING_LENGTH_CACHE_SIZE; i++)
+	{
+		if (StringLengthCacheStr[i] == str)
+		{
+			return StringLengthCacheLen[i];
+		}
+	}
+
+	const size_t len = strlen(str);
+	StringLengthCacheStr[StringLengthCacheNext] = str;
+	StringLengthCacheLen[StringLengthCacheNext] = len;
+	StringLengthCacheNext = (StringLengthCacheNext + 1) % STRING_LENGTH_CACHE_SIZE;
+	return len;
+}
+
 void DrawStringCentered(const char *str, int32_t cx, int32_t y)
 {
-	size_t len=strlen(str);
+	size_t len=GetCachedStringLength(str);
 	DrawString(str,cx-((len*FONT_WIDTH)/2),y);
 }
 
 #define MAX_DIGITS 5
-void DrawInt(int16_t val, int32_t x, int32_t y)
+uint8_t DrawInt(int16_t val, int32_t x, int32_t y)
 {
 	PrintX = x;
 	PrintY = y;
@@ -292,7 +271,7 @@ void DrawInt(int16_t val, int32_t x, int32_t y)
 	if (val == 0)
 	{
 		DrawChar('0');
-		return;
+		return 1;
 	}
 	else if (val < 0)
 	{
@@ -315,6 +294,8 @@ void DrawInt(int16_t val, int32_t x, int32_t y)
 		DrawChar(buffer[n]);
 		PrintX += FONT_WIDTH;
 	}
+
+	return (PrintX - x) / FONT_WIDTH;
 }
 
 uint8_t DrawRightJustifiedInt(int32_t val, int32_t x, int32_t y)
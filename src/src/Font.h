@@ -5,9 +5,11 @@
 #define FONT_WIDTH 4
 #define FONT_HEIGHT 6
 
+void InitFont(void);
+
 void DrawString(const char* str, int32_t x, int32_t y);
 int32_t DrawStringWrapped(const char *str, int32_t x, int32_t y, int32_t lineheight);
-void DrawStringCentered(const char *str, int32_t cx, int32_t y);
-void DrawInt(int16_t val, int32_t x, int32_t y);
+void DrawStringCentered(const char *str, int32_t cx, int32_t y);		// str must be a string constant
+uint8_t DrawInt(int16_t val, int32_t x, int32_t y);
 uint8_t DrawRightJustifiedInt(int32_t val, int32_t x, int32_t y);
 uint8_t DrawCurrency(int32_t val, int32_t x, int32_t y);
@@ -3,45 +3,20 @@
 #include "Interface.h"
 #include "Simulation.h"
 #include "global.h"
-
-GameState State;
-
-uint16_t GetRandFromSeed(uint16_t randVal)
-{
-	uint16_t lsb = randVal & 1;
-	randVal >>= 1;
-	if (lsb == 1)
-		randVal ^= 0xB400u;
-
-	return randVal;
-}
-
-uint16_t GetRand()
-{
-	static uint16_t randVal = 0xABC;
-
-	randVal = GetRandFromSeed(randVal);
-
-	return randVal - 1;
-}
+#include "WorldEvents.h"
+#include "Snapshot.h"
+#include "EditHistory.h"
 
 void InitGame()
 {
-	uint8_t* ptr = (uint8_t*)(&State);
-	for (int n = 0; n < sizeof(GameState); n++)
-	{
-		*ptr = 0;
-		ptr++;
-	}
-
-	State.taxRate = STARTING_TAX_RATE;
-	State.timeToNextDisaster = MAX_TIME_BETWEEN_DISASTERS;
+	SnapshotBeforeWrite(MainCity, &State, sizeof(GameState));
+	InitGameState(State);
+	ClearEditHistory();
 
 	ResetVisibleTileCache();
 	UIState.brush = RoadBrush; //FirstBuildingBrush + 1;
 	FocusTile(MAP_WIDTH / 2, MAP_HEIGHT / 2);
 
-	State.money = STARTING_FUNDS;
 	UIState.autoBudget = true;
 }
 
@@ -53,6 +28,28 @@ void FocusTile(uint8_t x, uint8_t y)
 	UIState.scrollY = UIState.selectY * 8 + TILE_SIZE / 2 - DISPLAY_HEIGHT / 2;
 }
 
+// The simulation doesn't touch the interface, anything the player needs to see comes back as events
+void HandleSimulationEvents(const SimulationEvents& events)
+{
+	if ((events.flags & SimulationEvent_YearEnd) && (!UIState.autoBudget || (events.flags & SimulationEvent_BudgetShortfall)))
+	{
+		UIState.state = BudgetMenu;
+		UIState.selection = 0;
+	}
+	// after the budget so the budget screen won't pop up over the result
+	if (events.flags & (SimulationEvent_ScenarioWon | SimulationEvent_ScenarioLost))
+	{
+		UIState.selection = 0;
+		UIState.state = (events.flags & SimulationEvent_ScenarioWon) ? ScenarioWinScreen : ScenarioLoseScreen;
+	}
+	if (events.flags & SimulationEvent_Disaster)
+	{
+		FocusTile(events.x + 1, events.y + 1);
+		UIState.state = InGameDisaster;
+		UIState.selection = DISASTER_MESSAGE_DISPLAY_TIME;
+	}
+}
+
 void TickGame()
 {
 	if (UIState.state == StartScreen)
@@ -64,9 +61,14 @@ void TickGame()
 			UIState.selectY=(GetRand()%(MAP_HEIGHT-20))+10;
 		}
 	}
-	if (UIState.state == InGame || UIState.state == ShowingToolbar)
+	if (UIState.state == NewCityMenu)
+	{
+		// random terrain preview is generated a few rows at a time so the menu stays responsive
+		StepRandomTerrainGeneration(TERRAIN_GENERATION_ROWS_PER_FRAME);
+	}
+	if (UIState.state == InGame || UIState.state == ShowingToolbar || UIState.state == DrawingStroke)
 	{
-		Simulate();
+		HandleSimulationEvents(Simulate(MainCity));
 	}
 	if (UIState.state == InGameDisaster)
 	{
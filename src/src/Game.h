@@ -8,6 +8,7 @@
 #include "Building.h"
 #include "Connectivity.h"
 #include "Terrain.h"
+#include "SimParams.h"
 
 enum GameFlags
 {
@@ -51,12 +52,45 @@ typedef struct
 	Building buildings[MAX_BUILDINGS];
 } GameState;
 
-extern GameState State;
+struct CitySnapshot;
+
+// A city and everything derived from it, so any number of cities can be simulated side by side
+// The simulation, buildings and connectivity take the city they work on, the interface works on MainCity
+// Terrain is still shared - the terrain tile cache follows the terrain type asked for and there's one random map
+struct CityContext
+{
+	GameState state;
+	// map size (w*h) bits - PowerFloodFill() uses the bytes after the map size for a stack
+	uint8_t powerGrid[((MAP_WIDTH * MAP_HEIGHT) / 8) + 128];
+	bool powerGridDirty;				// power grid needs flood filling again
+	uint8_t* buildingOwnerMap;			// building index + 1 for every tile, allocated the first time it's needed
+	bool buildingOwnerMapDirty;
+	uint16_t randVal;
+	CitySnapshot* snapshot;				// the snapshot taking copies of what changes, see Snapshot.h
+#ifdef NATIVE_BUILD
+	const SimParams* simParams;			// see SIM_PARAM(), the cart always uses DefaultSimParams
+#endif
+};
+
+// The city being played, State is its game state
+extern CityContext MainCity;
+extern GameState& State;
+
+void InitGameState(GameState& state);			// a new city with the starting funds and tax rate
+void InitCityContext(CityContext& city);
+void FreeCityContext(CityContext& city);		// frees the caches allocated for the city
+
+// Incremented whenever the tiles, roads, power lines, buildings or fires change, so cached views of the map know to rebuild
+extern uint32_t MapVersion;
+// Incremented whenever building density, traffic or power change, which only the overlays show
+extern uint32_t CityStatsVersion;
 
 uint16_t GetRandFromSeed(uint16_t randVal);
-uint16_t GetRand();
+uint16_t GetRand(CityContext& city);
+uint16_t GetRand();			// MainCity
 
 void InitGame(void);
+void RegisterGameListeners(void);
 void TickGame(void);
 
 void SaveCity(void);
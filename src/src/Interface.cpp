@@ -4,6 +4,12 @@
 #include "global.h"
 #include "exportcityppm.h"
 #include "scenario.h"
+#include "Assets.h"
+#include "Fields.h"
+#include "EditHistory.h"
+#include "Stroke.h"
+#include "Route.h"
+#include "wasmmemcpy.h"
 
 UIStateStruct UIState;
 
@@ -226,9 +232,9 @@ void HandleInput(uint8_t input)
 			{
 				UIState.selection--;
 			}
-			if(ScenarioData[UIState.selection].stateptr)
+			if(ScenarioData[UIState.selection].stateasset!=Asset_None)
 			{
-				LoadStaticCity(ScenarioData[UIState.selection].stateptr);
+				LoadStaticCity(ScenarioData[UIState.selection].stateasset);
 			}
 			else
 			{
@@ -238,7 +244,11 @@ void HandleInput(uint8_t input)
 			if(State.terrainType==NUM_TERRAIN_TYPES-1)
 			{
 				State.seed=global::ticks;
-				GenerateRandomTerrain(State.terrainType,State.seed);
+				StartRandomTerrainGeneration(State.terrainType,State.seed);
+			}
+			else
+			{
+				CancelRandomTerrainGeneration();
 			}
 		}
 		if (input & INPUT_RIGHT)
@@ -251,9 +261,9 @@ void HandleInput(uint8_t input)
 			{
 				UIState.selection++;
 			}
-			if(ScenarioData[UIState.selection].stateptr)
+			if(ScenarioData[UIState.selection].stateasset!=Asset_None)
 			{
-				LoadStaticCity(ScenarioData[UIState.selection].stateptr);
+				LoadStaticCity(ScenarioData[UIState.selection].stateasset);
 			}
 			else
 			{
@@ -263,31 +273,24 @@ void HandleInput(uint8_t input)
 			if(State.terrainType==NUM_TERRAIN_TYPES-1)
 			{
 				State.seed=global::ticks;
-				GenerateRandomTerrain(State.terrainType,State.seed);
+				StartRandomTerrainGeneration(State.terrainType,State.seed);
+			}
+			else
+			{
+				CancelRandomTerrainGeneration();
 			}
 		}
 		if (input & (INPUT_B))
 		{
+			// finish off the random terrain if the preview is still being generated
+			StepRandomTerrainGeneration(MAP_HEIGHT);
 			uint8_t terrainType = State.terrainType;
 			uint32_t seed = State.seed;
 			const uint8_t scenario = UIState.selection;
 			InitGame();
 			if(ScenarioData[scenario].flags & SCENARIO_FLAG_SCENARIO)
 			{
-				LoadStaticCity(ScenarioData[scenario].stateptr);
-				State.data[0] = scenario << 2;
-				State.year=ScenarioData[scenario].startyear-1900;
-				State.month=0;
-				State.money=ScenarioData[scenario].startfunds;
-				State.taxesCollected=0;
-				State.taxRate=7;
-				State.accumulatedMonthlyTaxes=0;
-				State.flags&=~FLAG_FAST;
-				State.flags&=~FLAG_PAUSE;
-				State.flags&=~FLAG_MAP_SHOWBUILDINGS;
-				State.flags&=~FLAG_MAP_SHOWFDRANGE;
-				State.flags&=~FLAG_MAP_SHOWROADS;
-				State.flags&=~FLAG_MAP_SHOWELECTRIC;
+				StartScenario(MainCity, scenario);
 			}
 			State.terrainType = terrainType;
 			State.seed = seed;
@@ -298,7 +301,7 @@ void HandleInput(uint8_t input)
 	}
 	else if (UIState.state == SaveLoadMenu)
 	{
-		WrapMenuInput(input, 5);
+		WrapMenuInput(input, 7);
 		if (input & (INPUT_A))
 		{
 			UIState.state = ShowingToolbar;
@@ -335,6 +338,17 @@ void HandleInput(uint8_t input)
 			case 4:
 				ExportCityPPM();
 				break;
+			case 5:
+			case 6:
+			{
+				uint8_t x, y;
+				if (UIState.selection == 5 ? UndoEdit(x, y) : RedoEdit(x, y))
+				{
+					UIState.state = InGame;
+					FocusTile(x, y);
+				}
+				break;
+			}
 			}
 		}
 	}
@@ -352,6 +366,7 @@ void HandleInput(uint8_t input)
 		{
 			if (UIState.brush == Bulldozer)
 			{
+				BeginEdit();
 				Building* building = GetBuilding(UIState.selectX, UIState.selectY);
 				if (building && !IsRubble(building->type))
 				{
@@ -364,7 +379,7 @@ void HandleInput(uint8_t input)
 					{
 						State.money -= cost;
 
-						DestroyBuilding(building);
+						DestroyBuilding(MainCity, building);
 					}
 					else
 					{
@@ -379,7 +394,7 @@ void HandleInput(uint8_t input)
 						{
 							State.money -= BULLDOZER_COST;
 
-							SetConnections(UIState.selectX, UIState.selectY, 0);
+							SetConnections(MainCity, UIState.selectX, UIState.selectY, 0);
 							RefreshTileAndConnectedNeighbours(UIState.selectX, UIState.selectY);
 							SetTile(UIState.selectX, UIState.selectY, RUBBLE_TILE);
 						}
@@ -393,62 +408,31 @@ void HandleInput(uint8_t input)
 						// TODO: nothing to bulldoze
 					}
 				}
+				EndEdit();
 			}
 			else if (UIState.brush < FirstBuildingBrush)
 			{
-				// Is powerline or road
-
-				Building* building = GetBuilding(UIState.selectX, UIState.selectY);
-				if (building && !IsRubble(building->type))
-				{
-					// TODO: can't build here
-				}
-				else
-				{
-					int cost = UIState.brush == RoadBrush ? ROAD_COST : POWERLINE_COST;
-					uint8_t mask = UIState.brush == RoadBrush ? RoadMask : PowerlineMask;
-					uint8_t currentConnections = GetConnections(UIState.selectX, UIState.selectY);
-					bool onGround =  IsTerrainClear(UIState.selectX, UIState.selectY);
-					
-					if(onGround || (currentConnections == 0 && IsSuitableForBridgedTile(UIState.selectX, UIState.selectY, mask)))
-					{
-						if ((currentConnections & mask) == 0)
-						{
-							if (State.money >= cost)
-							{
-								State.money -= cost;
-								SetConnections(UIState.selectX, UIState.selectY, currentConnections | mask);
-
-								// Remove rubble
-								if (building)
-								{
-									building->type = 0;
-								}
-
-								RefreshTileAndConnectedNeighbours(UIState.selectX, UIState.selectY);
-							}
-							else
-							{
-								// TODO: not enough cash
-							}
-						}
-					}
-				}
+				// Is powerline or road, drawn as a stroke while B is held
+				UIState.state = DrawingStroke;
+				UIState.strokeX = UIState.selectX;
+				UIState.strokeY = UIState.selectY;
+				UIState.strokeVerticalFirst = false;
 			}
 			else
 			{
 				// Is building placement
+				BeginEdit();
 				BuildingType buildingType = (BuildingType)(UIState.brush - FirstBuildingBrush + 1);
 				const BuildingInfo* buildingInfo = GetBuildingInfo(buildingType);
 				uint8_t placeX, placeY;
 				GetBuildingBrushLocation(buildingType, &placeX, &placeY);
 				uint16_t cost = buildingInfo->cost;
 
-				if (CanPlaceBuilding(buildingType, placeX, placeY))
+				if (CanPlaceBuilding(MainCity, buildingType, placeX, placeY))
 				{
 					if (State.money >= cost)
 					{
-						if (PlaceBuilding(buildingType, placeX, placeY))
+						if (PlaceBuilding(MainCity, buildingType, placeX, placeY))
 						{
 							State.money -= cost;
 						}
@@ -466,9 +450,25 @@ void HandleInput(uint8_t input)
 				{
 					// TODO: cannot place here, e.g. obstructed
 				}
+				EndEdit();
 			}
 		}
 	}
+	else if (UIState.state == DrawingStroke)
+	{
+		// the first move away from the start decides which way an L shaped stroke goes first
+		if (UIState.selectX == UIState.strokeX && UIState.selectY == UIState.strokeY && (input & (INPUT_LEFT | INPUT_RIGHT | INPUT_UP | INPUT_DOWN)))
+		{
+			UIState.strokeVerticalFirst = (input & (INPUT_UP | INPUT_DOWN)) != 0;
+		}
+		HandleMovementInput(input);
+
+		if (input & INPUT_A)
+		{
+			// cancelled
+			UIState.state = InGame;
+		}
+	}
 	else if (UIState.state == BudgetMenu)
 	{
 		// Display for a minimum of a few frames to prevent closing the budget menu by accident
@@ -582,12 +582,15 @@ void HandleInput(uint8_t input)
 			case 3:
 				State.flags^=FLAG_MAP_SHOWFDRANGE;
 				break;
+			case 4:
+				UIState.mapOverlay=(UIState.mapOverlay+1)%Num_FieldTypes;
+				break;
 			}
 		}
 		else if(input & (INPUT_DOWN | INPUT_RIGHT))
 		{
 			UIState.selection++;
-			if(UIState.selection>3)
+			if(UIState.selection>4)
 			{
 				UIState.selection=0;
 			}
@@ -596,7 +599,7 @@ void HandleInput(uint8_t input)
 		{
 			if(UIState.selection==0)
 			{
-				UIState.selection=3;
+				UIState.selection=4;
 			}
 			else
 			{
@@ -606,10 +609,90 @@ void HandleInput(uint8_t input)
 	}
 }
 
+static_assert(MAX_ROUTE_TILES <= EDIT_MAX_CELLS && MAX_STROKE_TILES <= EDIT_MAX_CELLS, "a stroke has to fit one edit");
+
+// The cost of laying mask along the path, or -1 if it can't be built or would be too big to undo - rubble it clears
+// takes more room in the history than the tiles
+static int32_t GetStrokeCost(const uint16_t* tiles, const uint16_t count, const uint8_t mask)
+{
+	uint16_t cells, buildings;
+	GetConnectionPathChanges(MainCity, tiles, count, mask, cells, buildings);
+	return CanRecordEdit(cells, buildings) ? GetConnectionPathCost(MainCity, tiles, count, mask) : -1;
+}
+
+// The stroke's path is only worked out again when the cursor moves or the map changes
+static uint16_t StrokeTiles[MAX_ROUTE_TILES];
+static uint16_t StrokeTileCount = 0;
+static int32_t StrokeCost = -1;
+static uint32_t StrokeMapVersion = 0;
+static uint8_t StrokeKey[5] = { 0xff };		// start, end, which way the L goes and the brush
+
+const uint16_t* GetStrokePath(uint16_t& outCount, int32_t& outCost)
+{
+	const uint8_t key[5] = { UIState.strokeX, UIState.strokeY, UIState.selectX, UIState.selectY, (uint8_t)(UIState.strokeVerticalFirst | (UIState.brush << 1)) };
+	bool changed = StrokeMapVersion != MapVersion;
+	for (int n = 0; n < 5; n++)
+	{
+		changed |= StrokeKey[n] != key[n];
+		StrokeKey[n] = key[n];
+	}
+
+	if (changed)
+	{
+		const uint8_t mask = UIState.brush == RoadBrush ? RoadMask : PowerlineMask;
+		uint16_t lineTiles[MAX_STROKE_TILES];
+		const uint8_t lineCount = GetStrokeTiles(UIState.strokeX, UIState.strokeY, UIState.selectX, UIState.selectY, UIState.strokeVerticalFirst, lineTiles);
+		const int32_t lineCost = GetStrokeCost(lineTiles, lineCount, mask);
+
+		// the stroke goes the way it was drawn, unless that's blocked or the cheapest route costs less
+		int32_t routeCost = 0;
+		StrokeTileCount = FindConnectionRoute(MainCity, UIState.strokeX, UIState.strokeY, UIState.selectX, UIState.selectY, mask, StrokeTiles, routeCost);
+		if (StrokeTileCount > 0 && GetStrokeCost(StrokeTiles, StrokeTileCount, mask) < 0)
+		{
+			StrokeTileCount = 0;
+		}
+		StrokeCost = routeCost;
+		if (StrokeTileCount == 0 || (lineCost >= 0 && lineCost <= routeCost))
+		{
+			memcpy(StrokeTiles, lineTiles, lineCount * sizeof(uint16_t));
+			StrokeTileCount = lineCount;
+			StrokeCost = lineCost;
+		}
+		StrokeMapVersion = MapVersion;
+	}
+
+	outCount = StrokeTileCount;
+	outCost = StrokeCost;
+	return StrokeTiles;
+}
+
+// The whole stroke is checked, paid for and laid together, and the screen refreshed once
+static void FinishStroke()
+{
+	uint16_t count;
+	int32_t cost;
+	const uint16_t* tiles = GetStrokePath(count, cost);
+	const uint8_t mask = UIState.brush == RoadBrush ? RoadMask : PowerlineMask;
+	uint8_t x, y, width, height;
+
+	BeginEdit();
+	if (cost >= 0 && BuildConnectionPath(MainCity, tiles, count, mask, x, y, width, height))
+	{
+		RefreshTileArea(x - 1, y - 1, width + 2, height + 2);
+	}
+	EndEdit();
+	UIState.state = InGame;
+}
+
 void ProcessInput()
 {
 	uint8_t input = GetInput();
 
+	if (UIState.state == DrawingStroke && (input & INPUT_B) == 0)
+	{
+		FinishStroke();
+	}
+
 	if (input != LastInput)
 	{
 		InputRepeatCounter = 0;
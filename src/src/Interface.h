@@ -40,7 +40,8 @@ enum
 	DemographicsMenu,
 	MapMenu,
 	ScenarioWinScreen,
-	ScenarioLoseScreen
+	ScenarioLoseScreen,
+	DrawingStroke			// B is held with the road or power line brush, the stroke is laid when it's let go
 };
 
 typedef struct
@@ -50,7 +51,10 @@ typedef struct
 	uint8_t brush;					// What will be placed 
 	uint8_t selection;      // For when toolbar is open or in a menu
 	uint8_t state;    // Which state the game is in
+	uint8_t strokeX, strokeY;		// Where the stroke being drawn started
 	bool autoBudget : 1;
+	uint8_t mapOverlay : 3;			// FieldType shown on the map screen
+	bool strokeVerticalFirst : 1;	// Which way an L shaped stroke goes before it turns
 } UIStateStruct;
 
 extern UIStateStruct UIState;
@@ -61,5 +65,7 @@ void ProcessInput(void);
 void UpdateInterface(void);
 
 void GetBuildingBrushLocation(BuildingType buildingType, uint8_t* outX, uint8_t* outY);
+// The tiles the stroke being drawn would be laid on and what it would cost, -1 if it can't be built
+const uint16_t* GetStrokePath(uint16_t& outCount, int32_t& outCost);
 
-bool LoadStaticCity(const uint8_t *citydata);		// MicroCity.cpp
\ No newline at end of file
+bool LoadStaticCity(const uint8_t asset);		// MicroCity.cpp
\ No newline at end of file
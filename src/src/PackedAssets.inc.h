@@ -0,0 +1,305 @@
+// Generated by tools/packassets.py from the files in assets/ - do not edit
+// 5716 bytes of assets packed to 4273
+
+static const uint8_t PackedAssetData[] =
+{
+	// Asset_Terrain1 - Terrain1.inc.h, 288 bytes packed to 224
+	0xff,0xff,0x00,0xc1,0xfc,0xff,0x00,0x83,0xfc,0xff,0x00,0x87,0xfc,0xff,0x00,0x0f,
+	0xfd,0xff,0x01,0xfe,0x0f,0xfd,0xff,0x01,0xfe,0x1f,0xfd,0xff,0x01,0xfc,0x3f,0xfd,
+	0xff,0x01,0xfc,0x3f,0xfd,0xff,0x01,0xfc,0x3f,0xfd,0xff,0x01,0xfc,0x3f,0xfd,0xff,
+	0x01,0xfc,0x1f,0xfd,0xff,0x01,0xfc,0x1f,0xfd,0xff,0x01,0xfc,0x0f,0xfd,0xff,0x01,
+	0xfe,0x07,0xfc,0xff,0x00,0x01,0xfc,0xff,0x00,0x80,0xfc,0xff,0x01,0xc0,0x3f,0xfd,
+	0xff,0x01,0xe0,0x1f,0xfd,0xff,0x01,0xf0,0x0f,0xfd,0xff,0x01,0xfc,0x07,0xfd,0xff,
+	0x01,0xfe,0x03,0xfc,0xff,0x00,0x03,0xfc,0xff,0x00,0x81,0xfc,0xff,0x00,0xc1,0xfc,
+	0xff,0x00,0xc0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x01,0xe0,0x7f,0xfd,0xff,0x01,0xf0,
+	0x7f,0xfd,0xff,0x01,0xf0,0x7f,0xfd,0xff,0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf8,0x7f,
+	0xfd,0xff,0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf8,0x7f,0xfd,
+	0xff,0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf8,0x7f,0xfd,0xff,
+	0x01,0xf8,0x7f,0xfd,0xff,0x01,0xf0,0x7f,0xfd,0xff,0x01,0xf0,0x7f,0xfd,0xff,0x01,
+	0xe0,0x7f,0xfd,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xc1,0xfc,0xff,
+	0x00,0x81,0xfc,0xff,0x00,0x81,0xfc,0xff,0x00,0x03,0xfc,0xff,0x02,0x07,0xff,0xff,
+	// Asset_Terrain2 - Terrain2.inc.h, 288 bytes packed to 258
+	0xfb,0x00,0x0c,0x03,0x81,0xfe,0x00,0x0f,0xf0,0x1f,0xff,0xff,0x00,0xff,0xf8,0x3f,
+	0xfd,0xff,0x01,0xfc,0x7f,0xfd,0xff,0x01,0xfc,0x7f,0xfd,0xff,0x01,0xfc,0x7f,0xfd,
+	0xff,0x01,0xfe,0x7f,0xfd,0xff,0x01,0xfe,0x3f,0xfd,0xff,0x01,0xfe,0x1f,0xfd,0xff,
+	0x02,0xfe,0x00,0x1f,0xfe,0xff,0x02,0xfe,0x00,0x07,0xfe,0xff,0x02,0xfe,0x00,0x03,
+	0xfe,0xff,0x02,0xfc,0x0f,0xe3,0xfe,0xff,0x02,0xfc,0x1f,0xf3,0xfe,0xff,0x02,0xfc,
+	0x3f,0xf3,0xfe,0xff,0x02,0xfc,0x3f,0xf3,0xfe,0xff,0x02,0xfc,0x3f,0xf3,0xfe,0xff,
+	0x02,0xf8,0x3f,0xf3,0xfe,0xff,0x2b,0x80,0x3f,0xf3,0xff,0xff,0xfc,0x00,0x3f,0xe3,
+	0xff,0xfe,0x00,0x00,0x1f,0xe3,0xff,0xfc,0x00,0x00,0x0f,0x07,0xff,0xfc,0x00,0x0c,
+	0x00,0x0f,0xff,0xfc,0x00,0x1e,0x00,0x7f,0xff,0xfe,0x00,0x7e,0x03,0xff,0xff,0xfe,
+	0x01,0xfe,0x07,0xfe,0xff,0x02,0x83,0xfe,0x0f,0xfd,0xff,0x01,0xfe,0x0f,0xfd,0xff,
+	0x01,0xfe,0x0f,0xfd,0xff,0x01,0xfe,0x1f,0xfd,0xff,0x01,0xfe,0x1f,0xfd,0xff,0x01,
+	0xfe,0x3f,0xfd,0xff,0x01,0xfc,0x3f,0xfd,0xff,0x01,0xfc,0x3f,0xfd,0xff,0x01,0xfc,
+	0x1f,0xfd,0xff,0x01,0xf8,0x1f,0xfd,0xff,0x01,0xf8,0x1f,0xfd,0xff,0x01,0xf8,0x1f,
+	0xfd,0xff,0x01,0xf8,0x1f,0xfd,0xff,0x01,0xf8,0x3f,0xfd,0xff,0x01,0xf8,0x3f,0xfd,
+	0xff,0x01,0xfc,0x7f,0xfd,0xff,0x18,0xfc,0x7f,0xff,0xf3,0xff,0xff,0xfc,0x7f,0xff,
+	0xc0,0x3f,0xff,0xfc,0x7f,0xff,0x00,0x3f,0x83,0xf8,0x3e,0x00,0x00,0x0c,0x01,0xf0,
+	0xfb,0x00,
+	// Asset_Terrain3 - Terrain3.inc.h, 288 bytes packed to 247
+	0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,
+	0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x3e,0xfc,0xff,0xff,0xc7,0xff,0xff,0xfc,0xff,0xfe,
+	0x03,0x9f,0xff,0xfc,0xff,0xfc,0x00,0x0f,0xff,0xfc,0xff,0xfc,0x00,0x07,0xff,0xfc,
+	0xff,0xfc,0x00,0x03,0xff,0xfc,0xff,0xfc,0x00,0x03,0xff,0xfc,0xff,0xfc,0x00,0x01,
+	0xff,0xfc,0xff,0xfc,0x00,0x01,0xff,0xf8,0xff,0xfc,0x00,0x01,0xff,0xc0,0xff,0xfe,
+	0x00,0x00,0x1f,0x00,0xff,0xff,0xfd,0x00,0xff,0xff,0x00,0xc0,0xfe,0x00,0xff,0xff,
+	0x5d,0xe0,0x00,0xe0,0x70,0xff,0xff,0xf0,0x01,0xff,0xf8,0xff,0xff,0xf8,0x03,0xff,
+	0xfc,0xff,0xff,0xf8,0x07,0xff,0xfc,0xff,0xff,0xf8,0x07,0xff,0xfc,0xff,0xff,0xfc,
+	0x07,0xff,0xfc,0xff,0xff,0xfc,0x07,0xff,0xf8,0xff,0xff,0xfc,0x07,0xff,0xf8,0xff,
+	0xff,0xf8,0x07,0xff,0xf8,0xff,0xff,0xf8,0x03,0xff,0xf8,0xff,0xff,0xf8,0x00,0xff,
+	0xf8,0xff,0xff,0xf0,0x00,0x7f,0xf8,0xff,0xff,0xf0,0x00,0x3f,0xf8,0xff,0xff,0xf0,
+	0x00,0x3f,0xf8,0xff,0xff,0xf8,0x00,0x3f,0xfc,0xff,0xff,0xfe,0x00,0x7f,0xfc,0xfc,
+	0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xf8,0xfc,
+	0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,
+	// Asset_Terrain4 - Terrain4.inc.h, 288 bytes packed to 6
+	0x81,0xff,0x81,0xff,0xe1,0xff,
+	// Asset_Terrain5 - Terrain5.inc.h, 288 bytes packed to 192
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf0,
+	0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,
+	0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,
+	0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,
+	0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xe0,
+	0xfc,0xff,0x00,0xe0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,
+	0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf8,
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,
+	0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,
+	0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,0xfc,0xff,0x00,0xf0,
+	0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xf8,0xfc,0xff,0x00,0xfc,0xfc,0xff,0x00,0xfc,
+	// Asset_Logo - LogoBitmap, 360 bytes packed to 296
+	0xf8,0x00,0x00,0x7f,0xfa,0xff,0x01,0xfe,0x40,0xfa,0x00,0x02,0x02,0x43,0xf7,0xfd,
+	0xff,0x7f,0xc1,0xff,0xc2,0x42,0x14,0x20,0x08,0x04,0x38,0x41,0x08,0x42,0x42,0xd5,
+	0xaf,0xeb,0xf5,0x93,0x41,0x6b,0x42,0x42,0xd5,0xaf,0xeb,0xf5,0xc7,0x41,0x6b,0x42,
+	0x42,0xd5,0xaf,0xeb,0x05,0xef,0x41,0x6b,0x42,0x42,0xd5,0xac,0x6b,0x7d,0xff,0x41,
+	0x6b,0x42,0x42,0xd5,0xad,0x6b,0x7d,0xbb,0x41,0x6b,0x42,0x42,0xd5,0xad,0x6b,0x05,
+	0x93,0x7f,0x63,0x42,0x42,0xdd,0xad,0x6b,0xf5,0xab,0x41,0x7f,0x42,0x42,0xd5,0xac,
+	0x6b,0xf5,0xbb,0x5d,0x7f,0x42,0x42,0xc9,0xaf,0xe8,0x35,0xab,0x41,0x03,0x42,0x42,
+	0xdd,0xaf,0xef,0xb5,0xab,0x7f,0xfb,0x42,0x42,0xff,0xaf,0xef,0xb5,0xab,0x40,0x0b,
+	0x42,0x42,0xf7,0xac,0x68,0x35,0xab,0x40,0x0b,0x42,0x42,0xe3,0xad,0x6b,0xf5,0xab,
+	0x40,0x0b,0xff,0x42,0x12,0xeb,0xad,0x6b,0xf5,0xab,0x40,0x0b,0x42,0x42,0x1c,0x21,
+	0x08,0x04,0x28,0x40,0x08,0x42,0x43,0xf7,0xfe,0xff,0x68,0xef,0xf0,0x0f,0xc2,0x40,
+	0x00,0x03,0x01,0x10,0x11,0x10,0x00,0x02,0x40,0x00,0x02,0xfd,0x57,0xd5,0x50,0x00,
+	0x02,0x60,0x00,0x02,0x81,0x51,0x16,0xd0,0x00,0x06,0xb0,0x00,0x02,0xbf,0x5d,0x7b,
+	0xb0,0x00,0x0d,0xd8,0x00,0x02,0xa1,0x55,0x4d,0x60,0x00,0x1b,0xec,0x00,0x02,0xa1,
+	0x55,0x45,0x40,0x00,0x37,0xf6,0x00,0x02,0xbf,0x55,0x45,0x40,0x00,0x6f,0xfb,0x00,
+	0x02,0x81,0x55,0x45,0x40,0x00,0xdf,0xfd,0x80,0x02,0xfd,0x55,0x45,0x40,0x01,0xbf,
+	0xfe,0xc0,0x03,0x01,0x14,0x44,0x40,0x03,0x7f,0xff,0x60,0x01,0xff,0xf7,0xc7,0xc0,
+	0x06,0xff,0xff,0xb0,0xfc,0x00,0x03,0x0d,0xff,0xff,0xdf,0xfc,0xff,0x03,0xfb,0xff,
+	0xff,0xe0,0xfc,0x00,0x00,0x07,0xd3,0xff,
+	// Asset_DemoCity - democity, 936 bytes packed to 929
+	0x03,0x35,0x00,0x01,0x02,0xfd,0x00,0x00,0x89,0xfa,0x00,0x0a,0xd1,0x35,0x10,0x00,
+	0x00,0x55,0x55,0x05,0x00,0x00,0x40,0xfc,0x55,0x49,0xa8,0xa9,0xaa,0x0a,0x00,0x00,
+	0xea,0xaa,0xaa,0xae,0xaa,0x6a,0xa8,0xa9,0xaa,0x0a,0x00,0x00,0x6a,0xaa,0xaa,0xa6,
+	0xaa,0x6a,0xa8,0xa9,0xaa,0x0a,0x00,0x00,0x6a,0xaa,0xaa,0xa6,0xaa,0x6a,0xa8,0xa9,
+	0xaa,0x0a,0x00,0xa8,0x6a,0xaa,0xaa,0xa6,0xaa,0x6a,0xa8,0xa9,0xaa,0x0a,0x00,0xa8,
+	0x6a,0xaa,0xaa,0xa6,0xaa,0x6a,0xa8,0xab,0xaa,0x0a,0x00,0xa8,0x6a,0xaa,0xaa,0xa6,
+	0xaa,0x6a,0x55,0x5d,0xfd,0x55,0x01,0x75,0x57,0xfe,0x55,0x33,0x75,0xa9,0xaa,0x1a,
+	0x00,0x00,0xaa,0xea,0xaa,0xaa,0xae,0xaa,0x6a,0xa9,0xaa,0x1a,0x00,0x00,0xaa,0x6a,
+	0xaa,0xaa,0xa6,0xaa,0x6a,0xa9,0xaa,0x1a,0x00,0x00,0xaa,0x6a,0xaa,0xaa,0xa6,0xaa,
+	0x6a,0xa9,0x80,0x1a,0x00,0x00,0xaa,0x6a,0x2a,0xa0,0xa6,0x02,0x6a,0xa9,0x80,0x1a,
+	0xfe,0x00,0x08,0x6a,0x2a,0xa0,0xa6,0x02,0x6a,0xa9,0x80,0x1a,0xfe,0x00,0x39,0x6a,
+	0x2a,0xa0,0xa6,0x02,0x6a,0xa9,0xaa,0xba,0x0a,0x00,0x00,0x40,0xaa,0xaa,0xa6,0xaa,
+	0x6a,0xa9,0xaa,0x9a,0x0a,0x00,0x00,0x40,0xaa,0xaa,0xa6,0xaa,0x6a,0xa9,0xaa,0x9a,
+	0x0a,0x00,0x00,0x40,0xaa,0xaa,0xa6,0xaa,0x6a,0x5d,0x55,0x9d,0x0a,0x00,0x00,0x40,
+	0x55,0x55,0x57,0x55,0x75,0xa9,0xaa,0x9a,0x0a,0xfe,0x00,0x08,0x80,0xaa,0xae,0xaa,
+	0x6a,0xa9,0xaa,0x9a,0x0a,0xfe,0x00,0x7f,0x80,0xaa,0xa6,0xaa,0x6a,0xa9,0xaa,0xda,
+	0x55,0x05,0x00,0x00,0x80,0xaa,0xa6,0xaa,0x6a,0x5d,0x55,0x9d,0xaa,0xa6,0x02,0x00,
+	0x00,0xa0,0xa6,0x02,0x6a,0xa9,0xaa,0x9a,0xaa,0xa6,0x02,0x00,0x00,0xa0,0xa6,0x02,
+	0x6a,0xa9,0xaa,0x9a,0xaa,0xa6,0x02,0x00,0x00,0xa0,0xa6,0x02,0x6a,0xa9,0xaa,0xda,
+	0x55,0x75,0x55,0x01,0x00,0xa0,0xa6,0xaa,0x6a,0xa9,0x80,0x9a,0xaa,0xae,0xaa,0x01,
+	0x00,0xa0,0xa6,0xaa,0x6a,0xa9,0x80,0x9a,0xaa,0xa6,0xaa,0x01,0x00,0xa0,0xa6,0xaa,
+	0x6a,0xa9,0x80,0x9a,0xaa,0xa6,0xaa,0x01,0x00,0x54,0x57,0x55,0x5d,0xa9,0xaa,0x9a,
+	0x0a,0xa4,0xaa,0x01,0x00,0xa8,0xea,0xaa,0x1a,0xa9,0xaa,0x9a,0x0a,0xa4,0xaa,0x01,
+	0x00,0xa8,0x6a,0xaa,0x1a,0xa9,0xaa,0x9a,0x7a,0x0a,0xa4,0xaa,0xa9,0x02,0xa8,0x6a,
+	0xaa,0x1a,0x55,0x55,0x9d,0xaa,0xa6,0xaa,0xa9,0x02,0xa8,0x6a,0xaa,0x1a,0xa9,0xaa,
+	0xba,0xaa,0xa6,0xaa,0xa9,0x02,0xa8,0x6a,0xaa,0x1a,0xa9,0xaa,0x9a,0xaa,0xa6,0xaa,
+	0xa9,0x02,0xa8,0x6a,0xaa,0x1a,0xa9,0xaa,0x5a,0x5d,0x55,0xd5,0x5d,0x55,0x5d,0x55,
+	0x55,0x1d,0xa9,0x00,0x00,0xa9,0xaa,0x9a,0x0a,0x00,0xa8,0xea,0xaa,0x1a,0xa9,0x00,
+	0x00,0xa9,0xaa,0x9a,0x0a,0x00,0xa8,0x6a,0xaa,0x1a,0xa9,0x00,0x00,0xa9,0xaa,0x9a,
+	0x0a,0x00,0xa8,0x6a,0xaa,0x1a,0xa9,0xaa,0x0a,0xa9,0xaa,0x9a,0x0a,0x00,0xa8,0x40,
+	0x80,0x1a,0xa9,0xaa,0x0a,0xa9,0xaa,0x9a,0x0a,0x00,0xa8,0x40,0x80,0x1a,0xa9,0xaa,
+	0x0a,0xa9,0xaa,0xba,0xfe,0xaa,0x32,0x40,0x80,0x1a,0x55,0x55,0x5d,0x55,0x55,0x5d,
+	0x55,0x55,0x5d,0x55,0x55,0x1d,0x80,0xaa,0xaa,0xab,0xaa,0x0a,0x00,0x00,0xa9,0xea,
+	0xaa,0x1a,0x80,0xaa,0xaa,0xa9,0xaa,0x0a,0x00,0x00,0xa9,0x6a,0xaa,0x1a,0x80,0xaa,
+	0xaa,0xa9,0xaa,0x0a,0x00,0x00,0xa9,0x6a,0xaa,0x1a,0xfe,0x00,0x00,0xa9,0xfd,0x00,
+	0x03,0xa9,0x6a,0xaa,0x1a,0xfe,0x00,0x00,0xa9,0xfd,0x00,0x03,0xa9,0x6a,0xaa,0x1a,
+	0xfe,0x00,0x00,0xa9,0xfd,0x00,0x0c,0xa9,0x6a,0xaa,0x1a,0x00,0x07,0x1f,0x03,0x35,
+	0x01,0xb0,0x02,0xe3,0xfe,0x00,0x7f,0xa4,0x0a,0x00,0x00,0x02,0x02,0x2d,0x00,0xb7,
+	0x63,0x73,0xc4,0xe3,0x10,0xf3,0x0c,0xe3,0x0c,0xf1,0x34,0xf2,0x10,0xe2,0x0c,0xe2,
+	0x0c,0x63,0x10,0x63,0x0c,0x63,0x0c,0x10,0x10,0xe3,0x00,0xf3,0x10,0xf3,0x0c,0xe3,
+	0x0c,0xf1,0x28,0xf1,0x0c,0xf2,0x10,0xf2,0x0c,0xf2,0x0c,0x63,0x10,0x63,0x0c,0x63,
+	0x0c,0x10,0x20,0xf3,0x00,0xf3,0x0c,0xe3,0x0c,0x04,0x34,0xf2,0x10,0xf1,0x10,0xf2,
+	0x0c,0xf2,0x0c,0x83,0x10,0x73,0x0c,0x73,0x0c,0x10,0x2c,0xe3,0x00,0xf3,0x18,0xf2,
+	0x44,0xf1,0x10,0x05,0x0c,0xf2,0x0c,0xf2,0x10,0xe3,0x18,0x10,0x38,0xe3,0x00,0xf2,
+	0x0c,0xf2,0x0c,0xf2,0x10,0xf1,0x44,0xf2,0x0c,0xf2,0x0c,0xf2,0x10,0xf2,0x0c,0xd3,
+	0x0c,0xb0,0x44,0xf2,0x00,0x11,0x98,0x7f,0xf1,0x0c,0xf1,0x0c,0xf1,0x60,0xf1,0x0c,
+	0xf2,0x10,0xf2,0x0c,0xe3,0x0c,0xb0,0x54,0x07,0x00,0x06,0x0c,0xf1,0x10,0x05,0x34,
+	0xf1,0x0c,0xf2,0x10,0x05,0x0c,0xf3,0x0c,0xf1,0x14,0xf1,0x0c,0xf1,0x0c,0x20,0x62,
+	0xf1,0x00,0xf2,0x10,0xf2,0x0c,0xf2,0x0c,0xf1,0x14,0x05,0x0c,0xf1,0x0c,0xf1,0x10,
+	0xf1,0x0c,0xf2,0x10,0xf2,0x0c,0x90,0x6d,0x05,0x00,0xf1,0x60,0xf1,0x0c,0xf1,0x0c,
+	0xf1,0x10,0x05,0x0c,0xf2,0x10,0xf2,0x0c,0x07,0x30,0x06,0x0c,0xf1,0x10,0xf1,0x0c,
+	0x90,0x79,0x08,0x00,0xf1,0x88,0xf1,0x0c,0xf2,0x10,0xf2,0x0c,0xf2,0x30,0xf2,0x0c,
+	0xf2,0x10,0xf2,0x0c,0xf1,0x18,0xf1,0x0c,0xf1,0x0c,0x10,0x8c,0xf1,0x00,0x05,0x0c,
+	0xf2,0x24,0xf2,0x0c,0xf2,0x0c,0xf1,0x10,0x47,0x05,0x0c,0xf2,0x1c,0xf2,0x0c,0xf2,
+	0x10,0xf2,0x0c,0x10,0x98,0xf1,0x00,0xf1,0x0c,0xf1,0x0c,0xf2,0x18,0xf2,0x0c,0xf2,
+	0x0c,0xf1,0x10,0xf1,0x28,0x05,0x0c,0x05,0x10,0xf1,0x0c,0x30,0xa8,0x51,0x00,0xf1,
+	0x0c,0xf1,0x0c,0xf1,0x10,0xf1,0x0c,0xf1,0x0c,0xf1,0x38,0xf1,0x0c,0xf1,0x10,0xf1,
+	0x0c,0xd0,0xb4,0xf1,0x00,0x05,0x0c,0xf1,0x44,0xf1,0x0c,0xf1,0x10,0xd1,0x0c,0xff,
+	0xff,
+	// Asset_CoastalScenario - coastalscenario, 788 bytes packed to 579
+	0x03,0x07,0x00,0x00,0x03,0xfd,0x00,0x00,0x49,0xfa,0x00,0x02,0x9a,0x07,0x0f,0xf7,
+	0x00,0x00,0x10,0xf7,0x00,0x01,0x80,0x3a,0xf7,0x00,0x01,0x80,0x1a,0xf7,0x00,0x01,
+	0x80,0x1a,0xf7,0x00,0x01,0x80,0x0a,0xf7,0x00,0x01,0x80,0x1a,0xf7,0x00,0x01,0x80,
+	0x3a,0xf8,0x00,0x03,0x40,0x44,0x11,0x05,0xf9,0x00,0x03,0x40,0x80,0xba,0x0a,0xf8,
+	0x00,0x02,0x80,0x9a,0x0a,0xf9,0x00,0x03,0x40,0x80,0x9a,0x0a,0xf9,0x00,0x03,0x6a,
+	0x00,0x80,0x0a,0xf9,0x00,0x03,0x6a,0x00,0x90,0x0a,0xf9,0x00,0x03,0x6a,0x00,0x80,
+	0x0a,0xf9,0x00,0x02,0x40,0xaa,0x1a,0xf8,0x00,0x02,0x40,0xaa,0x1a,0xf8,0x00,0x02,
+	0xc0,0xaa,0x1a,0xf9,0x00,0x04,0x55,0x51,0x55,0xdd,0x05,0xfb,0x00,0x05,0xa8,0xab,
+	0xc0,0x2a,0x90,0x0a,0xfb,0x00,0x05,0xa8,0xa9,0x40,0x2a,0x90,0x0a,0xfb,0x00,0x05,
+	0xa8,0xa9,0x40,0x2a,0x90,0x0a,0xfa,0x00,0x03,0xa8,0x40,0x80,0x1a,0xf9,0x00,0x03,
+	0xa9,0x40,0x80,0x1a,0xf9,0x00,0x03,0xa9,0x40,0x80,0x1a,0xfb,0x00,0x06,0xa0,0x02,
+	0xa8,0x6a,0x00,0x90,0x0a,0xfc,0x00,0x06,0xa0,0x02,0xa8,0x6a,0x00,0x90,0x0a,0xfc,
+	0x00,0x07,0xa0,0x02,0xa9,0x6a,0x00,0xb0,0x0a,0x00,0xfd,0x55,0x06,0x75,0x55,0x5d,
+	0x55,0x55,0xdd,0x55,0xfc,0x00,0x06,0xa4,0xaa,0x03,0xea,0x2a,0xb0,0x0a,0xfc,0x00,
+	0x06,0xa4,0xaa,0x00,0x6a,0x2a,0x90,0x0a,0xfc,0x00,0x06,0xa4,0xaa,0x01,0x6a,0x2a,
+	0x90,0x0a,0xfc,0x00,0x06,0x04,0x00,0xa9,0x40,0xaa,0x8a,0x0a,0xfc,0x00,0x06,0x04,
+	0x00,0xa8,0x00,0xaa,0x8a,0x0a,0xfc,0x00,0x06,0x04,0x00,0xa8,0x40,0xaa,0xba,0x0a,
+	0xfc,0x00,0x06,0xa4,0xaa,0xa9,0x6a,0xaa,0xca,0x55,0xfc,0x00,0x05,0xa4,0xaa,0xa9,
+	0x6a,0xaa,0x9a,0xfb,0x00,0x05,0xa4,0xaa,0xab,0xea,0xaa,0x9a,0xfb,0x00,0x05,0x54,
+	0x55,0x5d,0x55,0x55,0x9d,0xfa,0x00,0x04,0xa8,0x01,0x6a,0x00,0x98,0xfa,0x00,0x04,
+	0xa8,0x01,0xea,0xaa,0x9a,0xfa,0x00,0x04,0xa8,0x01,0x6a,0xaa,0x8a,0xf8,0x00,0x02,
+	0x6a,0xaa,0x9a,0xf8,0x00,0x02,0x6a,0x15,0x8c,0xf8,0x00,0x03,0xea,0x80,0xba,0x2a,
+	0xfc,0x00,0x06,0xa0,0x02,0xa9,0x40,0x80,0x9a,0x2a,0xfc,0x00,0x06,0xa0,0x02,0xa9,
+	0x40,0x80,0x9a,0x2a,0xfc,0x00,0x06,0xa0,0x02,0xab,0x40,0x55,0x90,0x2a,0xfc,0x00,
+	0x03,0x50,0x55,0x01,0x55,0xfd,0x00,0x06,0x04,0x00,0xe5,0x00,0x67,0x00,0x9d,0xf8,
+	0x00,0xff,0x01,0x7f,0x15,0x00,0x0f,0x1a,0x30,0x06,0xb1,0x00,0xf9,0x10,0x30,0x12,
+	0xe1,0x00,0xc9,0x10,0x00,0x22,0xf9,0x00,0xe2,0x0c,0xe1,0x10,0xc0,0x2d,0x71,0x00,
+	0x05,0x10,0xf9,0x0c,0xc1,0x10,0xc0,0x39,0x89,0x00,0xc1,0x10,0xe2,0x0c,0xf9,0x10,
+	0x50,0x49,0xb1,0x00,0xe2,0x10,0xe9,0x0c,0xe1,0x10,0xf9,0x0c,0xe2,0x10,0x50,0x55,
+	0xf9,0x00,0xe2,0x10,0xf9,0x0c,0xf9,0x10,0xe1,0x0c,0x05,0x10,0x20,0x61,0x62,0x00,
+	0x05,0x0c,0x21,0x10,0xe1,0x0c,0xe9,0x10,0xf9,0x0c,0xf1,0x10,0x20,0x71,0x72,0x00,
+	0x81,0x0c,0xf9,0x10,0xf1,0x0c,0xf1,0x10,0xf9,0x0c,0x06,0x10,0x05,0x0c,0x50,0x7d,
+	0xf9,0x00,0xf1,0x10,0xf9,0x0c,0xf1,0x10,0xf1,0x0c,0x07,0x10,0x09,0x0c,0x20,0x89,
+	0x51,0x00,0x11,0x0c,0x2d,0xf2,0x10,0xf2,0x0c,0xf2,0x10,0xf2,0x0c,0x50,0x99,0xe2,
+	0x00,0xf9,0x10,0xf3,0x0c,0xf3,0xd0,0xf3,0x0c,0x50,0xa5,0xf9,0x00,0xf9,0x10,0xf3,
+	0x0c,0x00,0xae,0xf9,0x00,0xf3,0x0c,0x04,0x10,0xe3,0x6c,0xf9,0x0c,0xe3,0x10,0xf9,
+	0x0c,0xff,0xff,
+	// Asset_RuralScenario - ruralscenario, 650 bytes packed to 228
+	0x03,0x07,0x00,0x00,0x03,0xfd,0x00,0x00,0x89,0xfa,0x00,0x05,0x86,0x08,0x00,0x00,
+	0x80,0x6a,0xf7,0x00,0x01,0x80,0x6a,0xf7,0x00,0x01,0x80,0x6a,0xf7,0x00,0x02,0x80,
+	0xea,0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,
+	0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,0x02,
+	0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,0x00,0x01,0x40,0x02,0xf7,
+	0x00,0x02,0x40,0x02,0x2a,0xf8,0x00,0x02,0x40,0x02,0x2a,0xf8,0x00,0x00,0xe0,0xfd,
+	0xaa,0xfb,0x00,0x05,0x55,0x75,0x5d,0x55,0x57,0x95,0xfa,0x00,0x04,0x2a,0xa8,0x00,
+	0x2a,0x90,0xfa,0x00,0x04,0x2a,0xa8,0x00,0x2a,0x90,0xfa,0x00,0x04,0x2a,0xa8,0x00,
+	0x2a,0x90,0xf7,0x00,0x01,0x80,0xba,0xf7,0x00,0x01,0x80,0x9a,0xf7,0x00,0x06,0x80,
+	0x9a,0x80,0xaa,0x02,0x00,0x2a,0xfb,0x00,0x05,0x90,0x80,0xaa,0x02,0x00,0x2a,0xfb,
+	0x00,0x00,0x90,0xfd,0xaa,0x00,0x2a,0xfb,0x00,0x00,0x50,0xfb,0x55,0x81,0x00,0x81,
+	0x00,0xf9,0x00,0x06,0x03,0x00,0x14,0x00,0x07,0x00,0x0f,0xf8,0x00,0xff,0x01,0x23,
+	0x08,0x00,0x6f,0x35,0x04,0x0c,0xc0,0x34,0x61,0x00,0x40,0x44,0x61,0x00,0xc2,0x14,
+	0x05,0x0c,0x07,0x10,0x05,0x0c,0x30,0x51,0x06,0x00,0xb0,0x59,0x81,0x00,0x32,0x0c,
+	0x73,0x28,0xff,0xff,
+	// Asset_RevitalizeScenario - revitalizescenario, 858 bytes packed to 794
+	0x03,0x09,0x00,0x04,0x3e,0xfd,0x00,0x00,0x84,0xfa,0x00,0x02,0x7c,0xfa,0x0e,0xf3,
+	0x00,0x01,0x80,0x0a,0xf7,0x00,0x01,0x90,0x0a,0xfe,0x00,0x00,0x50,0xfc,0x55,0x02,
+	0x00,0x90,0x0a,0xfe,0x00,0x08,0x90,0xaa,0xa6,0xaa,0xaa,0x1a,0x80,0x9a,0x0a,0xfe,
+	0x00,0x08,0x90,0xaa,0xa6,0xaa,0xaa,0x1a,0x80,0x9a,0x0a,0xfe,0x00,0x2b,0x90,0xaa,
+	0xae,0xaa,0xaa,0x1a,0x80,0x9a,0x0a,0x00,0x80,0x2a,0x50,0x55,0x57,0x55,0x55,0x15,
+	0x80,0x9a,0xaa,0x02,0x80,0x2a,0x90,0xaa,0xae,0xaa,0xaa,0x1a,0x80,0x9a,0xaa,0x02,
+	0x80,0x2a,0x90,0xaa,0xa6,0xaa,0xaa,0x1a,0x80,0xba,0xfd,0xaa,0x07,0xba,0xaa,0xa6,
+	0xaa,0xaa,0x1a,0x00,0xd0,0xfb,0x55,0x00,0x57,0xfe,0x55,0x02,0x80,0xba,0x0a,0xfd,
+	0x00,0x07,0xa0,0xae,0xaa,0x6a,0x00,0x80,0x9a,0x0a,0xfd,0x00,0x07,0xa0,0xa6,0xaa,
+	0x6a,0x00,0x80,0x9a,0x0a,0xfd,0x00,0x07,0xa0,0xa6,0xaa,0x6a,0x00,0x80,0x9a,0x0a,
+	0xfc,0x00,0x06,0xa4,0x02,0x6a,0x00,0x80,0x9a,0x0a,0xfc,0x00,0x06,0xa4,0x02,0x6a,
+	0x00,0x80,0x9a,0x0a,0xfc,0x00,0x07,0xa4,0x02,0x6a,0x00,0x80,0x9a,0xaa,0xaa,0xfe,
+	0x00,0x08,0xa0,0xa6,0xaa,0x6a,0x00,0x80,0x9a,0xaa,0xaa,0xfe,0x00,0x08,0xa0,0xa6,
+	0xaa,0x6a,0x00,0x80,0x9a,0xaa,0xaa,0xfe,0x00,0x06,0xa0,0xae,0xaa,0x6a,0x00,0x55,
+	0xd5,0xf9,0x55,0x03,0x75,0x00,0x80,0x9a,0xfe,0xaa,0x08,0x1a,0x00,0x00,0xa4,0xaa,
+	0x6a,0x00,0x80,0x9a,0xfe,0xaa,0x08,0x1a,0x00,0x00,0xa4,0xaa,0x6a,0x00,0x80,0x9a,
+	0xfe,0xaa,0x74,0x1a,0x00,0x00,0xa4,0xaa,0x6a,0x00,0x80,0x9a,0x0a,0xa8,0x5d,0x55,
+	0x05,0x00,0xa4,0x02,0x6a,0x00,0x80,0x9a,0x0a,0xa8,0xa9,0xaa,0x0a,0x00,0xa4,0x02,
+	0x6a,0x00,0x80,0x9a,0x0a,0xa8,0xa9,0xaa,0x0a,0x00,0xa4,0x02,0x6a,0x00,0x80,0x9a,
+	0x0a,0xa8,0xa9,0xaa,0x1a,0x00,0xa4,0xaa,0x6a,0x00,0x80,0x9a,0x0a,0xa8,0xa9,0x80,
+	0x1a,0x00,0xa4,0xaa,0x6a,0x00,0x80,0x9a,0x0a,0xa8,0xa9,0x80,0x1a,0x00,0xa4,0xaa,
+	0x6a,0x00,0x80,0x9a,0xaa,0xaa,0xa9,0xaa,0x1a,0x00,0x74,0x55,0x55,0x15,0x80,0x9a,
+	0xaa,0xaa,0x01,0x2a,0x10,0x00,0xa4,0xaa,0xaa,0x1a,0x80,0xba,0xaa,0xaa,0x01,0x2a,
+	0x10,0x00,0xa4,0xaa,0xaa,0x1a,0x55,0xd5,0xfb,0x55,0x71,0xa5,0xaa,0xaa,0x1a,0x00,
+	0x90,0xaa,0xaa,0xab,0xaa,0x1a,0x00,0xa4,0xaa,0xaa,0x1a,0x00,0x90,0xaa,0xaa,0xa9,
+	0xaa,0x1a,0x00,0xa4,0xaa,0xaa,0x1a,0x00,0x90,0xaa,0xaa,0xa9,0xaa,0x1a,0x00,0xa4,
+	0xaa,0xaa,0x1a,0x00,0x90,0x0a,0xa8,0xa9,0x6a,0x15,0x00,0x74,0x55,0x55,0x15,0x00,
+	0x90,0x0a,0xa8,0xa9,0x6a,0x00,0x00,0xa4,0xaa,0xaa,0x1a,0x00,0x90,0x0a,0xa8,0xa9,
+	0x6a,0x00,0x00,0xa4,0xaa,0xaa,0x1a,0x00,0x90,0xaa,0xaa,0xa9,0x6a,0x00,0x00,0xa4,
+	0xaa,0xaa,0x1a,0x00,0x90,0xaa,0xaa,0xa9,0x6a,0x00,0x00,0xa4,0xaa,0x80,0x1a,0x00,
+	0x90,0xaa,0xaa,0xa9,0x6a,0x00,0x00,0xa4,0xaa,0x80,0x1a,0x00,0x50,0xfd,0x55,0xff,
+	0x00,0x03,0xa4,0xaa,0x80,0x1a,0xf9,0x00,0x03,0x74,0x55,0x55,0x15,0xf9,0x00,0x03,
+	0xa4,0xaa,0xaa,0x0a,0xf9,0x00,0x03,0xa4,0xaa,0xaa,0x0a,0xf9,0x00,0x7f,0xa4,0xaa,
+	0xaa,0x0a,0x00,0x07,0x4c,0x01,0x0e,0x01,0x2c,0x01,0x7d,0x01,0x00,0x00,0x68,0x04,
+	0x00,0x00,0x01,0x02,0x26,0x00,0x9a,0x17,0x01,0xdc,0xb0,0x0d,0xf3,0x00,0xf3,0x0c,
+	0xf3,0x10,0xf3,0x0c,0xf3,0x0c,0xe3,0x0c,0x43,0x20,0x41,0x10,0x30,0x19,0x04,0x00,
+	0x43,0x80,0x62,0x10,0xb2,0x0c,0xf3,0x44,0xf3,0x0c,0xf2,0x10,0xf2,0x0c,0xf2,0x0c,
+	0x01,0x0c,0x30,0x2c,0x53,0x00,0xa2,0x10,0x05,0x0c,0xf2,0x50,0x06,0x10,0xc1,0x0c,
+	0xf2,0x0c,0x30,0x38,0x62,0x00,0x61,0x10,0x05,0x5c,0xd1,0x10,0x05,0x0c,0xf3,0x0c,
+	0x30,0x44,0x61,0x00,0x07,0x10,0x71,0x0c,0xa1,0x0c,0x07,0x44,0xc1,0x10,0xd1,0x0c,
+	0xf2,0x0c,0x30,0x54,0x61,0x00,0x72,0x10,0xb2,0x0c,0xc2,0x0c,0xc2,0x0c,0x7f,0xc2,
+	0x0c,0xd1,0x3c,0xd1,0x0c,0xd1,0x0c,0x30,0x60,0x61,0x00,0x53,0x10,0xc2,0x18,0xf1,
+	0x54,0x05,0x0c,0xc1,0x0c,0x51,0x64,0x61,0x0c,0xb1,0x0c,0x30,0x6c,0x61,0x00,0x63,
+	0x10,0xb2,0x18,0xf1,0x54,0xd1,0x0c,0xc1,0x0c,0x05,0x10,0xc3,0x54,0xc2,0x18,0x30,
+	0x78,0x51,0x00,0x21,0x10,0x21,0x0c,0x21,0x0c,0xc3,0x1c,0xc1,0xf8,0xc1,0x0c,0xc1,
+	0x0c,0xc1,0x0c,0x70,0x88,0x53,0x00,0x63,0x0c,0x73,0x0c,0x31,0x10,0x41,0x0c,0x61,
+	0x0c,0xc2,0x2c,0xc2,0x0c,0xc2,0x0c,0x81,0x0c,0x70,0x94,0x53,0x00,0x31,0x18,0x83,
+	0x10,0xb2,0x0c,0x61,0xf8,0x41,0x0c,0x21,0x0c,0x21,0x0c,0x62,0xf0,0x31,0x0c,0x31,
+	0x0c,0x63,0x10,0x63,0x0c,0xc2,0xf8,0xc2,0x0c,0x05,0x0c,0xb2,0x0c,0x20,0xb6,0x09,
+	0xc3,0x00,0xb3,0x0c,0xb3,0x0c,0xb3,0x0c,0xff,0xff,
+	// Asset_IslandScenario - islandscenario, 684 bytes packed to 520
+	0x03,0x01,0x00,0x09,0x02,0xfd,0x00,0x00,0x34,0xfa,0x00,0x02,0x82,0x10,0x0f,0xe7,
+	0x00,0x04,0xaa,0x40,0x55,0x55,0x05,0xfa,0x00,0x26,0xaa,0x40,0x2a,0x00,0x04,0x00,
+	0x00,0x40,0x55,0x55,0x00,0x00,0xaa,0x40,0x2a,0x00,0x54,0x01,0x00,0x50,0x00,0x40,
+	0x00,0x00,0xaa,0xea,0x2a,0x00,0x00,0x55,0x55,0x15,0x00,0x40,0x00,0x00,0x57,0x55,
+	0x02,0xfb,0x00,0x05,0x40,0x05,0x00,0xaa,0x4a,0x02,0xfa,0x00,0x04,0x04,0x00,0xaa,
+	0x4a,0x02,0xfa,0x00,0x05,0x04,0x00,0xaa,0x4a,0xaa,0x02,0xfb,0x00,0x05,0x04,0x00,
+	0x80,0x40,0x55,0x02,0xfb,0x00,0x05,0x04,0x00,0x80,0x00,0x40,0x02,0xfb,0x00,0x05,
+	0x04,0x00,0x80,0x00,0x40,0x02,0xfb,0x00,0x05,0x04,0x00,0x80,0x00,0x40,0x02,0xfb,
+	0x00,0x05,0x04,0x00,0xd0,0x55,0x55,0x02,0xfb,0x00,0x05,0x04,0x00,0x90,0x0a,0x40,
+	0x2a,0xfb,0x00,0x07,0x04,0x00,0x90,0x0a,0x40,0x2a,0x00,0x40,0xfd,0x55,0x07,0x05,
+	0x00,0x90,0x0a,0x40,0x2a,0x00,0x40,0xfb,0x00,0x05,0x90,0x0a,0x40,0x57,0x55,0x55,
+	0xfb,0x00,0x05,0x90,0x0a,0x40,0xaa,0xaa,0x6a,0xfb,0x00,0x05,0x90,0x0a,0x40,0x2a,
+	0x00,0x6a,0xfa,0x00,0x04,0x02,0x40,0x2a,0x00,0x6a,0xfa,0x00,0x04,0x02,0x40,0x00,
+	0x00,0x6a,0xfa,0x00,0x04,0x02,0x50,0x00,0x00,0x6a,0xfa,0x00,0x04,0x02,0x10,0x00,
+	0x00,0x6a,0xfe,0x00,0x08,0x40,0x15,0x00,0x00,0x02,0x10,0x00,0x00,0x40,0xfe,0x00,
+	0x08,0x40,0x00,0x00,0xa0,0x56,0x15,0x00,0x00,0x40,0xfe,0x00,0x04,0x40,0x00,0x00,
+	0xa0,0x06,0xfe,0x00,0x00,0x40,0xfe,0x00,0x04,0x40,0x00,0x00,0xaa,0x06,0xfe,0x00,
+	0x08,0x40,0x00,0x00,0x40,0x55,0x00,0x00,0x56,0x05,0xfe,0x00,0x07,0x40,0x55,0x01,
+	0x40,0x40,0x00,0x00,0x06,0xfb,0x00,0xff,0x55,0x03,0x40,0x00,0x00,0x06,0xf9,0x00,
+	0x03,0x40,0x00,0x80,0x06,0xf9,0x00,0x03,0x40,0x00,0x80,0x05,0xf9,0x00,0x03,0x50,
+	0x00,0x80,0x01,0xf9,0x00,0x03,0x10,0x00,0x80,0x01,0xf9,0x00,0x03,0x10,0x00,0x80,
+	0x01,0xf9,0x00,0x03,0x10,0x00,0x80,0x01,0xf9,0x00,0x03,0x10,0x00,0x80,0x01,0xf9,
+	0x00,0x08,0x10,0x00,0x80,0x01,0x00,0x54,0x55,0x55,0x01,0xfe,0x00,0x08,0x10,0x00,
+	0x80,0x01,0x00,0xa4,0xaa,0xaa,0x01,0xfe,0x00,0x08,0x10,0x00,0x80,0x01,0x00,0xa4,
+	0xaa,0xa8,0x01,0xfe,0x00,0x21,0x10,0x00,0x80,0x01,0x00,0xa4,0xaa,0xa8,0x55,0x55,
+	0x01,0x00,0x10,0x00,0xa8,0x01,0x00,0x24,0x00,0x80,0xaa,0x02,0x55,0x55,0x15,0x00,
+	0xa8,0xab,0xaa,0x2e,0x00,0x00,0xa0,0x02,0xfd,0x00,0x07,0xa8,0x55,0x55,0x05,0x00,
+	0x00,0xa0,0x02,0xe5,0x00,0x06,0x01,0x00,0x48,0x00,0x1d,0x00,0x2a,0xf8,0x00,0xff,
+	0x01,0x45,0x1a,0x00,0xcc,0x5c,0x40,0x08,0x04,0x00,0x21,0xe0,0x40,0x1c,0xe3,0x00,
+	0xf3,0x0c,0x30,0x3c,0x05,0x00,0x51,0x10,0xf2,0x24,0x20,0x46,0x05,0x00,0x05,0x44,
+	0xc1,0x10,0xf2,0xe4,0x06,0x20,0x80,0x59,0x07,0x00,0x80,0x66,0x05,0x00,0x05,0x10,
+	0xc1,0x28,0xe0,0xa0,0xc1,0x00,0xc2,0x0c,0xc1,0x10,0xb0,0xaa,0x05,0x00,0xb1,0x18,
+	0x61,0x64,0x05,0x0c,0x05,0xec,0xff,0xff,
+};
+
+static const PackedAsset PackedAssets[] =
+{
+	{ 0, 288 },		// Asset_Terrain1
+	{ 224, 288 },		// Asset_Terrain2
+	{ 482, 288 },		// Asset_Terrain3
+	{ 729, 288 },		// Asset_Terrain4
+	{ 735, 288 },		// Asset_Terrain5
+	{ 927, 360 },		// Asset_Logo
+	{ 1223, 936 },		// Asset_DemoCity
+	{ 2152, 788 },		// Asset_CoastalScenario
+	{ 2731, 650 },		// Asset_RuralScenario
+	{ 2959, 858 },		// Asset_RevitalizeScenario
+	{ 3753, 684 },		// Asset_IslandScenario
+};
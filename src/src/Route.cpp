@@ -0,0 +1,303 @@
+#include "Route.h"
+#include "Stroke.h"
+#include "Connectivity.h"
+#include "Terrain.h"
+#include "Arena.h"
+#include "wasmmemcpy.h"
+
+// Money always comes first, the step and turn weights only pick between paths that cost the same. A route's steps and
+// turns can't weigh more than ROUTE_TIE_BREAK_WEIGHT, and routes that cost different amounts differ by at least a tile,
+// so a tile's cost is weighted to be more than that
+#define ROUTE_STEP_WEIGHT 2
+#define ROUTE_TURN_WEIGHT 1
+#define ROUTE_TIE_BREAK_WEIGHT (MAX_ROUTE_TILES * (ROUTE_STEP_WEIGHT + ROUTE_TURN_WEIGHT))
+#define ROUTE_COST (ROAD_COST > POWERLINE_COST ? ROAD_COST : POWERLINE_COST)
+#define ROUTE_MIN_COST (ROAD_COST < POWERLINE_COST ? ROAD_COST : POWERLINE_COST)
+#define ROUTE_MONEY_WEIGHT (ROUTE_TIE_BREAK_WEIGHT / ROUTE_MIN_COST + 1)
+
+// Each tile has a nibble, which direction it was reached in and whether it's closed
+#define ROUTE_DIRECTION_MASK 3
+#define ROUTE_CLOSED 4
+
+// An open list entry is the estimate (cost so far plus the distance left) in the top bits, then the step that reached the
+// tile and the tile, so entries compare by their estimate. A route of MAX_ROUTE_TILES can't cost more than fits
+#define ROUTE_TILE_BITS 12
+#define ROUTE_ESTIMATE_SHIFT (ROUTE_TILE_BITS + 2)
+#define ROUTE_MAX_ESTIMATE ((1u << (32 - ROUTE_ESTIMATE_SHIFT)) - 1)
+typedef uint32_t RouteEntry;
+
+static_assert(MAP_WIDTH * MAP_HEIGHT <= (1 << ROUTE_TILE_BITS), "tiles have to fit an entry");
+static_assert((uint32_t)MAX_ROUTE_TILES * (ROUTE_COST * ROUTE_MONEY_WEIGHT + ROUTE_STEP_WEIGHT + ROUTE_TURN_WEIGHT) + (MAP_WIDTH + MAP_HEIGHT) * ROUTE_STEP_WEIGHT <= ROUTE_MAX_ESTIMATE, "estimates have to fit an entry");
+
+static RouteEntry MakeEntry(const uint32_t estimate, const uint16_t tile, const uint8_t direction)
+{
+	return (estimate << ROUTE_ESTIMATE_SHIFT) | (direction << ROUTE_TILE_BITS) | tile;
+}
+
+static uint32_t GetEntryEstimate(const RouteEntry entry)
+{
+	return entry >> ROUTE_ESTIMATE_SHIFT;
+}
+
+static uint16_t GetEntryTile(const RouteEntry entry)
+{
+	return entry & ((1 << ROUTE_TILE_BITS) - 1);
+}
+
+static uint8_t GetEntryDirection(const RouteEntry entry)
+{
+	return (entry >> ROUTE_TILE_BITS) & 3;
+}
+
+// North, east, south, west
+static const int8_t RouteStepX[4] = { 0, 1, 0, -1 };
+static const int8_t RouteStepY[4] = { -1, 0, 1, 0 };
+
+typedef struct
+{
+	RouteEntry* entries;
+	uint16_t count;
+} RouteOpenList;
+
+static void SwapEntries(RouteEntry& a, RouteEntry& b)
+{
+	const RouteEntry temp = a;
+	a = b;
+	b = temp;
+}
+
+static void SiftUp(RouteOpenList& list, int index)
+{
+	while (index > 0 && list.entries[(index - 1) / 2] > list.entries[index])
+	{
+		SwapEntries(list.entries[(index - 1) / 2], list.entries[index]);
+		index = (index - 1) / 2;
+	}
+}
+
+static void PushEntry(RouteOpenList& list, const RouteEntry entry)
+{
+	int index = list.count;
+	if (list.count == ROUTE_OPEN_LIST_SIZE)
+	{
+		// full, the highest estimate is one of the leaves and the new entry takes its place if it's better
+		index = list.count / 2;
+		for (int n = index + 1; n < list.count; n++)
+		{
+			index = list.entries[n] > list.entries[index] ? n : index;
+		}
+		if (entry >= list.entries[index])
+		{
+			return;
+		}
+	}
+	else
+	{
+		list.count++;
+	}
+	list.entries[index] = entry;
+	SiftUp(list, index);
+}
+
+static RouteEntry PopEntry(RouteOpenList& list)
+{
+	const RouteEntry top = list.entries[0];
+	list.entries[0] = list.entries[--list.count];
+
+	int index = 0;
+	for (;;)
+	{
+		const int left = index * 2 + 1;
+		const int right = left + 1;
+		int smallest = index;
+		if (left < list.count && list.entries[left] < list.entries[smallest])
+		{
+			smallest = left;
+		}
+		if (right < list.count && list.entries[right] < list.entries[smallest])
+		{
+			smallest = right;
+		}
+		if (smallest == index)
+		{
+			break;
+		}
+		SwapEntries(list.entries[index], list.entries[smallest]);
+		index = smallest;
+	}
+	return top;
+}
+
+static uint8_t GetNodeState(const uint8_t* nodes, const uint16_t tile)
+{
+	return (nodes[tile >> 1] >> ((tile & 1) * 4)) & 0xf;
+}
+
+static void SetNodeState(uint8_t* nodes, const uint16_t tile, const uint8_t value)
+{
+	const int shift = (tile & 1) * 4;
+	nodes[tile >> 1] = (nodes[tile >> 1] & ~(0xf << shift)) | (value << shift);
+}
+
+static bool IsWater(const CityContext& city, const int x, const int y)
+{
+	return !IsTerrainClear(city.state.terrainType, x, y);
+}
+
+static bool IsOnMap(const int x, const int y)
+{
+	return x >= 0 && y >= 0 && x < MAP_WIDTH && y < MAP_HEIGHT;
+}
+
+// A bridge tile has to stay straight, so nothing either side of it can have mask
+static int GetBridgeTileCost(const CityContext& city, const int x, const int y, const uint8_t direction, const uint8_t mask)
+{
+	const int tileCost = GetConnectionTileCost(city, x, y, mask);
+	for (int side = 1; side < 4 && tileCost >= 0; side += 2)
+	{
+		const uint8_t sideDirection = (direction + side) & 3;
+		const int sideX = x + RouteStepX[sideDirection];
+		const int sideY = y + RouteStepY[sideDirection];
+		if (IsOnMap(sideX, sideY) && (GetConnections(city, sideX, sideY) & mask))
+		{
+			return -1;
+		}
+	}
+	return tileCost;
+}
+
+static uint32_t GetDistanceEstimate(const uint16_t tile, const uint8_t endX, const uint8_t endY)
+{
+	const int x = tile % MAP_WIDTH;
+	const int y = tile / MAP_WIDTH;
+	return ((x > endX ? x - endX : endX - x) + (y > endY ? y - endY : endY - y)) * ROUTE_STEP_WEIGHT;
+}
+
+// Walks back from the end along the directions each tile was reached in, across any bridges, then puts it start first
+static uint16_t GetRouteTiles(const CityContext& city, const uint8_t* nodes, const uint16_t startTile, const uint16_t endTile, uint16_t* outTiles)
+{
+	uint16_t count = 0;
+	uint16_t tile = endTile;
+	for (;;)
+	{
+		if (count == MAX_ROUTE_TILES)
+		{
+			return 0;
+		}
+		outTiles[count++] = tile;
+		if (tile == startTile)
+		{
+			break;
+		}
+		const uint8_t direction = GetNodeState(nodes, tile) & ROUTE_DIRECTION_MASK;
+		const int step = RouteStepY[direction] * MAP_WIDTH + RouteStepX[direction];
+		tile -= step;
+		while (IsWater(city, tile % MAP_WIDTH, tile / MAP_WIDTH))
+		{
+			if (count == MAX_ROUTE_TILES)
+			{
+				return 0;
+			}
+			outTiles[count++] = tile;
+			tile -= step;
+		}
+	}
+
+	for (int n = 0; n < count / 2; n++)
+	{
+		const uint16_t temp = outTiles[n];
+		outTiles[n] = outTiles[count - 1 - n];
+		outTiles[count - 1 - n] = temp;
+	}
+	return count;
+}
+
+uint16_t FindConnectionRoute(const CityContext& city, uint8_t startX, uint8_t startY, uint8_t endX, uint8_t endY, uint8_t mask, uint16_t* outTiles, int32_t& outCost)
+{
+	if (IsWater(city, startX, startY) || IsWater(city, endX, endY))
+	{
+		return 0;
+	}
+	const int startCost = GetConnectionTileCost(city, startX, startY, mask);
+	if (startCost < 0)
+	{
+		return 0;
+	}
+
+	const size_t mark = ScratchMark();
+	uint8_t* nodes = (uint8_t*)ScratchAlloc(MAP_WIDTH * MAP_HEIGHT / 2);
+	RouteOpenList open = { (RouteEntry*)ScratchAlloc(ROUTE_OPEN_LIST_SIZE * sizeof(RouteEntry)), 0 };
+	if (nodes == nullptr || open.entries == nullptr)
+	{
+		ScratchRelease(mark);
+		return 0;
+	}
+	memset(nodes, 0, MAP_WIDTH * MAP_HEIGHT / 2);
+
+	const uint16_t startTile = startY * MAP_WIDTH + startX;
+	const uint16_t endTile = endY * MAP_WIDTH + endX;
+	uint16_t count = 0;
+	PushEntry(open, MakeEntry(startCost * ROUTE_MONEY_WEIGHT + GetDistanceEstimate(startTile, endX, endY), startTile, 0));
+
+	while (open.count > 0)
+	{
+		const RouteEntry entry = PopEntry(open);
+		const uint16_t entryTile = GetEntryTile(entry);
+		const uint8_t entryDirection = GetEntryDirection(entry);
+		if (GetNodeState(nodes, entryTile) & ROUTE_CLOSED)
+		{
+			continue;
+		}
+		SetNodeState(nodes, entryTile, ROUTE_CLOSED | entryDirection);
+		if (entryTile == endTile)
+		{
+			count = GetRouteTiles(city, nodes, startTile, endTile, outTiles);
+			break;
+		}
+
+		const uint32_t costSoFar = GetEntryEstimate(entry) - GetDistanceEstimate(entryTile, endX, endY);
+		for (uint8_t direction = 0; direction < 4; direction++)
+		{
+			int x = entryTile % MAP_WIDTH + RouteStepX[direction];
+			int y = entryTile / MAP_WIDTH + RouteStepY[direction];
+			int steps = 1;
+			int money = 0;
+
+			// water is crossed in one go, so a bridge can't turn
+			while (IsOnMap(x, y) && IsWater(city, x, y) && money >= 0)
+			{
+				const int tileCost = GetBridgeTileCost(city, x, y, direction, mask);
+				money = tileCost < 0 ? -1 : money + tileCost;
+				x += RouteStepX[direction];
+				y += RouteStepY[direction];
+				steps++;
+			}
+			if (money < 0 || !IsOnMap(x, y))
+			{
+				continue;
+			}
+			const uint16_t tile = y * MAP_WIDTH + x;
+			const int tileCost = GetConnectionTileCost(city, x, y, mask);
+			if (tileCost < 0 || (GetNodeState(nodes, tile) & ROUTE_CLOSED))
+			{
+				continue;
+			}
+
+			uint32_t cost = costSoFar + (money + tileCost) * ROUTE_MONEY_WEIGHT + steps * ROUTE_STEP_WEIGHT;
+			if (entryTile != startTile && direction != entryDirection)
+			{
+				cost += ROUTE_TURN_WEIGHT;
+			}
+			const uint32_t estimate = cost + GetDistanceEstimate(tile, endX, endY);
+			if (estimate <= ROUTE_MAX_ESTIMATE)
+			{
+				PushEntry(open, MakeEntry(estimate, tile, direction));
+			}
+		}
+	}
+
+	ScratchRelease(mark);
+	outCost = count > 0 ? GetConnectionPathCost(city, outTiles, count, mask) : 0;
+	// the search only knows the bridges already on the map, not the route's own tiles beside one
+	return outCost >= 0 ? count : 0;
+}
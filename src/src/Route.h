@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include "Game.h"
+
+// Least cost routes for roads and power lines, found with A* over the map
+// No longer than one edit can hold (EDIT_MAX_CELLS), so laying a route can always be undone
+#define MAX_ROUTE_TILES 124
+// Entries in the open list, when it's full the one with the highest estimate is dropped. Uses 4 bytes each of the
+// scratch arena, along with half a byte for every tile on the map
+#define ROUTE_OPEN_LIST_SIZE 768
+
+// The cheapest path from the start to the end to lay mask along. Tiles that already have it are free, buildings other than
+// rubble are in the way and water is crossed by straight bridges only. Of paths that cost the same the shortest, then the
+// one with fewest turns, is chosen. The path goes in outTiles in the same form as GetStrokeTiles() and outCost is what it
+// would cost. Returns how many tiles it has, 0 if there's no route, it's longer than
+// MAX_ROUTE_TILES or its own tiles would run alongside one of its bridges
+uint16_t FindConnectionRoute(const CityContext& city, uint8_t startX, uint8_t startY, uint8_t endX, uint8_t endY, uint8_t mask, uint16_t* outTiles, int32_t& outCost);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include "Defines.h"
+
+// Simulation tuning, defaulting to the SIM_* values in Defines.h
+// The cart only ever uses the defaults and SIM_PARAM() folds them to constants. On the native build each city
+// points at a table, so the tools can try other values without a rebuild
+typedef struct
+{
+	// Population growth
+	int32_t incrementPopThreshold;				// SIM_INCREMENT_POP_THRESHOLD
+	int32_t decrementPopThreshold;				// SIM_DECREMENT_POP_THRESHOLD
+	int32_t averagePopulationDensity;			// AVERAGE_POPULATION_DENSITY
+	int32_t baseScore;							// SIM_BASE_SCORE
+	int32_t averagingStrength;					// SIM_AVERAGING_STRENGTH
+	int32_t employmentBoost;					// SIM_EMPLOYMENT_BOOST
+	int32_t unemploymentPenalty;				// SIM_UNEMPLOYMENT_PENALTY
+	int32_t industrialOpportunityBoost;			// SIM_INDUSTRIAL_OPPORTUNITY_BOOST
+	int32_t commercialOpportunityBoost;			// SIM_COMMERCIAL_OPPORTUNITY_BOOST
+	int32_t localBuildingDistance;				// SIM_LOCAL_BUILDING_DISTANCE
+	int32_t localBuildingInfluence;				// SIM_LOCAL_BUILDING_INFLUENCE
+	int32_t stadiumBoost;						// SIM_STADIUM_BOOST
+	int32_t parkBoost;							// SIM_PARK_BOOST
+	int32_t maxCrime;							// SIM_MAX_CRIME
+	int32_t randomStrengthMask;					// SIM_RANDOM_STRENGTH_MASK
+	// Pollution and traffic
+	int32_t pollutionInfluence;					// SIM_POLLUTION_INFLUENCE
+	int32_t maxPollution;						// SIM_MAX_POLLUTION
+	int32_t industrialBasePollution;			// SIM_INDUSTRIAL_BASE_POLLUTION
+	int32_t trafficBasePollution;				// SIM_TRAFFIC_BASE_POLLUTION
+	int32_t powerplantBasePollution;			// SIM_POWERPLANT_BASE_POLLUTION
+	int32_t heavyTrafficThreshold;				// SIM_HEAVY_TRAFFIC_THRESHOLD
+	// Taxes and budget
+	int32_t idealTaxRate;						// SIM_IDEAL_TAX_RATE
+	int32_t taxRatePenalty;						// SIM_TAX_RATE_PENALTY
+	int32_t fireAndPoliceMaintenanceCost;		// FIRE_AND_POLICE_MAINTENANCE_COST
+	int32_t roadMaintenanceCost;				// ROAD_MAINTENANCE_COST
+	// Fires and disasters
+	int32_t fireSpreadChance;					// SIM_FIRE_SPREAD_CHANCE
+	int32_t fireBurnChance;						// SIM_FIRE_BURN_CHANCE
+	int32_t fireDeptBaseInfluence;				// SIM_FIRE_DEPT_BASE_INFLUENCE
+	int32_t fireDeptInfluenceMultiplier;		// SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER
+	int32_t minTimeBetweenDisasters;			// MIN_TIME_BETWEEN_DISASTERS
+	int32_t maxTimeBetweenDisasters;			// MAX_TIME_BETWEEN_DISASTERS
+} SimParams;
+
+constexpr SimParams DefaultSimParams =
+{
+	SIM_INCREMENT_POP_THRESHOLD,
+	SIM_DECREMENT_POP_THRESHOLD,
+	AVERAGE_POPULATION_DENSITY,
+	SIM_BASE_SCORE,
+	SIM_AVERAGING_STRENGTH,
+	SIM_EMPLOYMENT_BOOST,
+	SIM_UNEMPLOYMENT_PENALTY,
+	SIM_INDUSTRIAL_OPPORTUNITY_BOOST,
+	SIM_COMMERCIAL_OPPORTUNITY_BOOST,
+	SIM_LOCAL_BUILDING_DISTANCE,
+	SIM_LOCAL_BUILDING_INFLUENCE,
+	SIM_STADIUM_BOOST,
+	SIM_PARK_BOOST,
+	SIM_MAX_CRIME,
+	SIM_RANDOM_STRENGTH_MASK,
+	SIM_POLLUTION_INFLUENCE,
+	SIM_MAX_POLLUTION,
+	SIM_INDUSTRIAL_BASE_POLLUTION,
+	SIM_TRAFFIC_BASE_POLLUTION,
+	SIM_POWERPLANT_BASE_POLLUTION,
+	SIM_HEAVY_TRAFFIC_THRESHOLD,
+	SIM_IDEAL_TAX_RATE,
+	SIM_TAX_RATE_PENALTY,
+	FIRE_AND_POLICE_MAINTENANCE_COST,
+	ROAD_MAINTENANCE_COST,
+	SIM_FIRE_SPREAD_CHANCE,
+	SIM_FIRE_BURN_CHANCE,
+	SIM_FIRE_DEPT_BASE_INFLUENCE,
+	SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER,
+	MIN_TIME_BETWEEN_DISASTERS,
+	MAX_TIME_BETWEEN_DISASTERS
+};
+
+#ifdef NATIVE_BUILD
+#define SIM_PARAM(city, name) ((city).simParams->name)
+#else
+#define SIM_PARAM(city, name) (DefaultSimParams.name)
+#endif
@@ -1,9 +1,9 @@
 #include "Game.h"
 #include "Connectivity.h"
-#include "Draw.h"
-#include "Interface.h"
+#include "WorldEvents.h"
 #include "Simulation.h"
 #include "scenario.h"
+#include "Snapshot.h"
 
 enum SimulationSteps
 {
@@ -20,7 +20,7 @@ void DebugBuildingScore(Building* building, int score, int crime, int pollution,
 inline void DebugBuildingScore(Building* building, int score, int crime, int pollution, int localInfluence, int populationEffect, int randomEffect) {}
 #endif
 
-uint8_t GetNumRoadConnections(Building* building)
+uint8_t GetNumRoadConnections(const CityContext& city, Building* building)
 {
 	const BuildingInfo* info = GetBuildingInfo(building->type);
 	uint8_t width = info->width;
@@ -31,7 +31,7 @@ uint8_t GetNumRoadConnections(Building* building)
 	{
 		for(uint8_t i = 0; i < width; i++)
 		{
-			if(GetConnections(building->x + i, building->y - 1) & RoadMask)
+			if(GetConnections(city, building->x + i, building->y - 1) & RoadMask)
 			{
 				count++;
 			}
@@ -41,7 +41,7 @@ uint8_t GetNumRoadConnections(Building* building)
 	{
 		for(uint8_t i = 0; i < width; i++)
 		{
-			if(GetConnections(building->x + i, building->y + height) & RoadMask)
+			if(GetConnections(city, building->x + i, building->y + height) & RoadMask)
 			{
 				count++;
 			}
@@ -51,7 +51,7 @@ uint8_t GetNumRoadConnections(Building* building)
 	{
 		for(uint8_t i = 0; i < height; i++)
 		{
-			if(GetConnections(building->x - 1, building->y + i) & RoadMask)
+			if(GetConnections(city, building->x - 1, building->y + i) & RoadMask)
 			{
 				count++;
 			}
@@ -61,7 +61,7 @@ uint8_t GetNumRoadConnections(Building* building)
 	{
 		for(uint8_t i = 0; i < height; i++)
 		{
-			if(GetConnections(building->x + width, building->y + i) & RoadMask)
+			if(GetConnections(city, building->x + width, building->y + i) & RoadMask)
 			{
 				count++;
 			}
@@ -71,32 +71,35 @@ uint8_t GetNumRoadConnections(Building* building)
 	return count;
 }
 
-double MonthlyTaxes()
+double MonthlyTaxes(const GameState& state)
 {
-	const int32_t totalPopulation = static_cast<int32_t>(State.residentialPopulation + State.commercialPopulation + State.industrialPopulation) * POPULATION_MULTIPLIER;
-	return static_cast<double>(totalPopulation * State.taxRate) / 1200.0;
+	const int32_t totalPopulation = static_cast<int32_t>(state.residentialPopulation + state.commercialPopulation + state.industrialPopulation) * POPULATION_MULTIPLIER;
+	return static_cast<double>(totalPopulation * state.taxRate) / 1200.0;
 }
 
-int32_t GetEstimatedYearTaxes()
+int32_t GetEstimatedYearTaxes(const GameState& state)
 {
-	return State.accumulatedMonthlyTaxes + (State.month <= 11 ? (static_cast<double>(12-State.month) * MonthlyTaxes()) : 0);
+	return state.accumulatedMonthlyTaxes + (state.month <= 11 ? (static_cast<double>(12-state.month) * MonthlyTaxes(state)) : 0);
 }
 
-void DoMonthEndBudget()
+void DoMonthEndBudget(GameState& state)
 {
 	// Accumulate monthly taxes
-	State.accumulatedMonthlyTaxes += (MonthlyTaxes() + 0.5);		// round any decimal to nearest integer
+	state.accumulatedMonthlyTaxes += (MonthlyTaxes(state) + 0.5);		// round any decimal to nearest integer
 }
 
-void DoYearEndBudget()
+// Returns true if the cash flow or funds aren't positive, so the player should look at the budget
+bool DoYearEndBudget(CityContext& city)
 {
+	GameState& state = city.state;
+
 	// Collect taxes (taxes now accumulated monthly and then lump sum added at end of year)
-	//int32_t totalPopulation = (State.residentialPopulation + State.commercialPopulation + State.residentialPopulation) * POPULATION_MULTIPLIER;
-	//State.taxesCollected = (totalPopulation * State.taxRate) / 100;
-	State.taxesCollected = State.accumulatedMonthlyTaxes;
-	State.accumulatedMonthlyTaxes = 0;
+	//int32_t totalPopulation = (state.residentialPopulation + state.commercialPopulation + state.residentialPopulation) * POPULATION_MULTIPLIER;
+	//state.taxesCollected = (totalPopulation * state.taxRate) / 100;
+	state.taxesCollected = state.accumulatedMonthlyTaxes;
+	state.accumulatedMonthlyTaxes = 0;
 
-	State.money += State.taxesCollected;
+	state.money += state.taxesCollected;
 
 	// Count police and fire departments for costing
 	uint8_t numPoliceDept = 0;
@@ -104,21 +107,21 @@ void DoYearEndBudget()
 
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		if (State.buildings[n].type == PoliceDept)
+		if (state.buildings[n].type == PoliceDept)
 		{
 			numPoliceDept++;
 		}
-		else if (State.buildings[n].type == FireDept)
+		else if (state.buildings[n].type == FireDept)
 		{
 			numFireDept++;
 		}
 	}
 
-	State.fireBudget = numFireDept;
-	State.policeBudget = numPoliceDept;
+	state.fireBudget = numFireDept;
+	state.policeBudget = numPoliceDept;
 
-	State.money -= FIRE_AND_POLICE_MAINTENANCE_COST * numFireDept;
-	State.money -= FIRE_AND_POLICE_MAINTENANCE_COST * numPoliceDept;
+	state.money -= SIM_PARAM(city, fireAndPoliceMaintenanceCost) * numFireDept;
+	state.money -= SIM_PARAM(city, fireAndPoliceMaintenanceCost) * numPoliceDept;
 
 	// Count road tiles for cost of road maintenance
 	int numRoadTiles = 0;
@@ -126,32 +129,28 @@ void DoYearEndBudget()
 	{
 		for (int x = 0; x < MAP_WIDTH; x++)
 		{
-			if (GetConnections(x, y) & RoadMask)
+			if (GetConnections(city, x, y) & RoadMask)
 				numRoadTiles++;
 		}
 	}
 
-	State.roadBudget = (numRoadTiles * ROAD_MAINTENANCE_COST) / 100;
-	State.money -= State.roadBudget;
+	state.roadBudget = (numRoadTiles * SIM_PARAM(city, roadMaintenanceCost)) / 100;
+	state.money -= state.roadBudget;
 
 #ifdef _WIN32
-	printf("Budget for %d:\n", State.year + 1899);
+	printf("Budget for %d:\n", state.year + 1899);
 	printf("Population: %d\n", totalPopulation);
-	printf("Taxes collected: $%d\n", State.taxesCollected);
-	printf("Police cost: %d x $%d = $%d\n", numPoliceDept, FIRE_AND_POLICE_MAINTENANCE_COST, FIRE_AND_POLICE_MAINTENANCE_COST * numPoliceDept);
-	printf("Fire cost: %d x $%d = $%d\n", numFireDept, FIRE_AND_POLICE_MAINTENANCE_COST, FIRE_AND_POLICE_MAINTENANCE_COST * numFireDept);
-	printf("Road maintenance: %d tiles = $%d\n", numRoadTiles, State.roadBudget);
+	printf("Taxes collected: $%d\n", state.taxesCollected);
+	printf("Police cost: %d x $%d = $%d\n", numPoliceDept, SIM_PARAM(city, fireAndPoliceMaintenanceCost), SIM_PARAM(city, fireAndPoliceMaintenanceCost) * numPoliceDept);
+	printf("Fire cost: %d x $%d = $%d\n", numFireDept, SIM_PARAM(city, fireAndPoliceMaintenanceCost), SIM_PARAM(city, fireAndPoliceMaintenanceCost) * numFireDept);
+	printf("Road maintenance: %d tiles = $%d\n", numRoadTiles, state.roadBudget);
 #endif
 
-	int32_t cashFlow = State.taxesCollected - State.roadBudget - State.policeBudget * FIRE_AND_POLICE_MAINTENANCE_COST - State.fireBudget * FIRE_AND_POLICE_MAINTENANCE_COST;
-	if (!UIState.autoBudget || cashFlow <= 0 || State.money <= 0)
-	{
-		UIState.state = BudgetMenu;
-		UIState.selection = 0;
-	}
+	int32_t cashFlow = state.taxesCollected - state.roadBudget - state.policeBudget * SIM_PARAM(city, fireAndPoliceMaintenanceCost) - state.fireBudget * SIM_PARAM(city, fireAndPoliceMaintenanceCost);
+	return cashFlow <= 0 || state.money <= 0;
 }
 
-bool SpreadFire(Building* building)
+bool SpreadFire(CityContext& city, Building* building)
 {
 	const BuildingInfo* info = GetBuildingInfo(building->type);
 	uint8_t width = info->width;
@@ -160,18 +159,19 @@ bool SpreadFire(Building* building)
 	uint8_t y1 = building->y > 1 ? building->y - 2 : building->y;
 	uint8_t x2 = building->x + width + 2;
 	uint8_t y2 = building->y + height + 2;
-	uint8_t spreadDirection = GetRand() & 3;
+	uint8_t spreadDirection = GetRand(city) & 3;
 
 	if (spreadDirection & 1)
 	{
 		for (uint8_t j = building->y; j < building->y + height; j++)
 		{
-			Building* neighbour = GetBuilding(spreadDirection & 2 ? x1 : x2, j);
+			Building* neighbour = GetBuilding(city, spreadDirection & 2 ? x1 : x2, j);
 
 			if (neighbour && !neighbour->onFire && neighbour->type != Park && !IsRubble(neighbour->type))
 			{
+				SnapshotBeforeWrite(city, neighbour, sizeof(Building));
 				neighbour->onFire = 1;
-				RefreshBuildingTiles(neighbour);
+				PostBuildingEvent(city, WorldEvent_FireStateChanged, neighbour);
 				return true;
 			}
 		}
@@ -180,12 +180,13 @@ bool SpreadFire(Building* building)
 	{
 		for (uint8_t i = building->x; i < building->x + width; i++)
 		{
-			Building* neighbour = GetBuilding(i, spreadDirection & 2 ? y1 : y2);
+			Building* neighbour = GetBuilding(city, i, spreadDirection & 2 ? y1 : y2);
 
 			if (neighbour && !neighbour->onFire && neighbour->type != Park && !IsRubble(neighbour->type))
 			{
+				SnapshotBeforeWrite(city, neighbour, sizeof(Building));
 				neighbour->onFire = 1;
-				RefreshBuildingTiles(neighbour);
+				PostBuildingEvent(city, WorldEvent_FireStateChanged, neighbour);
 				return true;
 			}
 		}
@@ -194,20 +195,29 @@ bool SpreadFire(Building* building)
 	return false;
 }
 
-void SimulateBuilding(Building* building)
+void SimulateBuilding(CityContext& city, Building* building)
 {
+	GameState& state = city.state;
 	int8_t populationDensityChange = 0;
+	const bool hadHeavyTraffic = building->heavyTraffic;
+	const uint8_t oldFireState = building->onFire;
+
+	// empty slots are left as they are
+	if (building->type != BuildingType_None)
+	{
+		SnapshotBeforeWrite(city, building, sizeof(Building));
+	}
 
 	if (building->onFire)
 	{
 		if (IsRubble(building->type))
 		{
 			building->onFire--;
-			if ((GetRand() & 0xff) > SIM_FIRE_SPREAD_CHANCE)
+			PostBuildingEvent(city, WorldEvent_FireStateChanged, building);
+			if ((GetRand(city) & 0xff) > SIM_PARAM(city, fireSpreadChance))
 			{
-				SpreadFire(building);
+				SpreadFire(city, building);
 			}
-			RefreshBuildingTiles(building);
 			return;
 		}
 
@@ -216,7 +226,7 @@ void SimulateBuilding(Building* building)
 
 		for (int n = 0; n < MAX_BUILDINGS; n++)
 		{
-			Building* otherBuilding = &State.buildings[n];
+			Building* otherBuilding = &state.buildings[n];
 
 			if (otherBuilding->type == FireDept && otherBuilding->hasPower)
 			{
@@ -229,20 +239,22 @@ void SimulateBuilding(Building* building)
 			}
 		}
 
-		int fireDeptInfluence = SIM_FIRE_DEPT_BASE_INFLUENCE + closestFireDept * SIM_FIRE_DEPT_INFLUENCE_MULTIPLIER;
+		int fireDeptInfluence = SIM_PARAM(city, fireDeptBaseInfluence) + closestFireDept * SIM_PARAM(city, fireDeptInfluenceMultiplier);
 		
-		if (fireDeptInfluence <= 255 && (GetRand() & 0xff) > (uint8_t)(fireDeptInfluence))
+		if (fireDeptInfluence <= 255 && (GetRand(city) & 0xff) > (uint8_t)(fireDeptInfluence))
 		{
 			building->onFire--;
 		}
-		else if ((GetRand() & 0xff) > SIM_FIRE_SPREAD_CHANCE || !SpreadFire(building))
+		else if ((GetRand(city) & 0xff) > SIM_PARAM(city, fireSpreadChance) || !SpreadFire(city, building))
 		{
-			if ((GetRand() & 0xff) < SIM_FIRE_BURN_CHANCE)
+			if ((GetRand(city) & 0xff) < SIM_PARAM(city, fireBurnChance))
 			{
 				if (building->onFire >= BUILDING_MAX_FIRE_COUNTER)
 				{
-					DestroyBuilding(building);
+					DestroyBuilding(city, building);
+					// the rubble carries on burning
 					building->onFire = BUILDING_MAX_FIRE_COUNTER;
+					PostBuildingEvent(city, WorldEvent_FireStateChanged, building);
 				}
 				else
 				{
@@ -259,46 +271,46 @@ void SimulateBuilding(Building* building)
 			int score = 0;
 			
 			// random effect
-			int randomEffect = (GetRand() & SIM_RANDOM_STRENGTH_MASK) - (SIM_RANDOM_STRENGTH_MASK / 2);
+			int randomEffect = (GetRand(city) & SIM_PARAM(city, randomStrengthMask)) - (SIM_PARAM(city, randomStrengthMask) / 2);
 			score += randomEffect;
 			
 			// tend towards average population density
-			score += (AVERAGE_POPULATION_DENSITY - building->populationDensity) * SIM_AVERAGING_STRENGTH;
+			score += (SIM_PARAM(city, averagePopulationDensity) - building->populationDensity) * SIM_PARAM(city, averagingStrength);
 			
 			// tax rate effect
-			score -= (State.taxRate - SIM_IDEAL_TAX_RATE) * SIM_TAX_RATE_PENALTY;
+			score -= (state.taxRate - SIM_PARAM(city, idealTaxRate)) * SIM_PARAM(city, taxRatePenalty);
 
 			// general population effect
 			int populationEffect = 0;
 			switch(building->type)
 			{
 				case Residential:
-				if(State.residentialPopulation < State.industrialPopulation)
+				if(state.residentialPopulation < state.industrialPopulation)
 				{
-					populationEffect += SIM_EMPLOYMENT_BOOST;
+					populationEffect += SIM_PARAM(city, employmentBoost);
 				}
-				else if(State.residentialPopulation > State.industrialPopulation + State.commercialPopulation)
+				else if(state.residentialPopulation > state.industrialPopulation + state.commercialPopulation)
 				{
-					populationEffect -= SIM_UNEMPLOYMENT_PENALTY;
+					populationEffect -= SIM_PARAM(city, unemploymentPenalty);
 				}
 				break;
 				case Industrial:
-				if(State.industrialPopulation < State.residentialPopulation || State.industrialPopulation < State.commercialPopulation)
+				if(state.industrialPopulation < state.residentialPopulation || state.industrialPopulation < state.commercialPopulation)
 				{
-					populationEffect += SIM_INDUSTRIAL_OPPORTUNITY_BOOST;
+					populationEffect += SIM_PARAM(city, industrialOpportunityBoost);
 				}
 				break;
 				case Commercial:
-				if(State.commercialPopulation < State.residentialPopulation || State.commercialPopulation < State.industrialPopulation)
+				if(state.commercialPopulation < state.residentialPopulation || state.commercialPopulation < state.industrialPopulation)
 				{
-					populationEffect += SIM_COMMERCIAL_OPPORTUNITY_BOOST;
+					populationEffect += SIM_PARAM(city, commercialOpportunityBoost);
 				}
 				break;
 			}
 			score += populationEffect;
 			
 			// If at least 3 road tiles are adjacent then assume that it is connected to the road network
-			bool isRoadConnected = GetNumRoadConnections(building) >= 3;
+			bool isRoadConnected = GetNumRoadConnections(city, building) >= 3;
 			
 			uint8_t closestPoliceStationDistance = 24;
 			int16_t pollution = 0;
@@ -309,12 +321,12 @@ void SimulateBuilding(Building* building)
 			{
 				if (building->populationDensity == 0)
 				{
-					score += SIM_BASE_SCORE;
+					score += SIM_PARAM(city, baseScore);
 				}
 
 				for(int n = 0; n < MAX_BUILDINGS; n++)
 				{
-					Building* otherBuilding = &State.buildings[n];
+					Building* otherBuilding = &state.buildings[n];
 					
 					if(building != otherBuilding && otherBuilding->type && (otherBuilding->hasPower || otherBuilding->type == Park) && !otherBuilding->onFire)
 					{
@@ -329,56 +341,56 @@ void SimulateBuilding(Building* building)
 						
 						if(otherBuilding->type == Industrial)
 						{
-							buildingPollution = SIM_INDUSTRIAL_BASE_POLLUTION + otherBuilding->populationDensity - distance;
+							buildingPollution = SIM_PARAM(city, industrialBasePollution) + otherBuilding->populationDensity - distance;
 						}
 						else if(otherBuilding->type == Powerplant)
 						{
-							buildingPollution = SIM_POWERPLANT_BASE_POLLUTION - distance;
+							buildingPollution = SIM_PARAM(city, powerplantBasePollution) - distance;
 						}
 						else if(otherBuilding->heavyTraffic)
 						{
-							buildingPollution = SIM_TRAFFIC_BASE_POLLUTION - distance;
+							buildingPollution = SIM_PARAM(city, trafficBasePollution) - distance;
 						}
 						
 						if(buildingPollution > 0)
 							pollution += buildingPollution;
 						
-						if(distance <= SIM_LOCAL_BUILDING_DISTANCE && GetNumRoadConnections(otherBuilding) >= 3)
+						if(distance <= SIM_PARAM(city, localBuildingDistance) && GetNumRoadConnections(city, otherBuilding) >= 3)
 						{
 							switch(otherBuilding->type)
 							{
 								case Industrial:
 								if(otherBuilding->populationDensity >= building->populationDensity && building->type == Residential)
 								{
-									localInfluence += SIM_LOCAL_BUILDING_INFLUENCE;
+									localInfluence += SIM_PARAM(city, localBuildingInfluence);
 								}
 								else if (otherBuilding->populationDensity > building->populationDensity && building->type == Commercial)
 								{
-									localInfluence += SIM_LOCAL_BUILDING_INFLUENCE;
+									localInfluence += SIM_PARAM(city, localBuildingInfluence);
 								}
 								break;
 								case Residential:
 								if(otherBuilding->populationDensity > building->populationDensity && (building->type == Commercial || building->type == Industrial))
 								{
-									localInfluence += SIM_LOCAL_BUILDING_INFLUENCE;
+									localInfluence += SIM_PARAM(city, localBuildingInfluence);
 								}
 								break;
 								case Commercial:
 								if(otherBuilding->populationDensity >= building->populationDensity && building->type == Residential)
 								{
-									localInfluence += SIM_LOCAL_BUILDING_INFLUENCE;
+									localInfluence += SIM_PARAM(city, localBuildingInfluence);
 								}
 								break;
 								case Stadium:
 								if(building->type == Residential || building->type == Commercial)
 								{
-									localInfluence += SIM_STADIUM_BOOST;
+									localInfluence += SIM_PARAM(city, stadiumBoost);
 								}
 								break;
 								case Park:
 								if(building->type == Residential)
 								{
-									localInfluence += SIM_PARK_BOOST;
+									localInfluence += SIM_PARAM(city, parkBoost);
 								}
 								break;
 								default:
@@ -394,9 +406,9 @@ void SimulateBuilding(Building* building)
 			// negative effect from pollution
 			if (building->type == Residential)
 			{
-				if (pollution > SIM_MAX_POLLUTION)
-					pollution = SIM_MAX_POLLUTION;
-				score -= pollution * SIM_POLLUTION_INFLUENCE;
+				if (pollution > SIM_PARAM(city, maxPollution))
+					pollution = SIM_PARAM(city, maxPollution);
+				score -= pollution * SIM_PARAM(city, pollutionInfluence);
 #if _WIN32
 //				printf("Pollution: %d\n", pollution * SIM_POLLUTION_INFLUENCE);
 #endif
@@ -404,9 +416,9 @@ void SimulateBuilding(Building* building)
 			
 			// simulate crime based on how far the closest police station is and how populated the area is
 			int crime = (building->populationDensity * (closestPoliceStationDistance - 16));
-			if(crime > SIM_MAX_CRIME)
+			if(crime > SIM_PARAM(city, maxCrime))
 			{
-				crime = SIM_MAX_CRIME;
+				crime = SIM_PARAM(city, maxCrime);
 			}
 			else if (crime < 0)
 			{
@@ -415,19 +427,19 @@ void SimulateBuilding(Building* building)
 
 			score -= crime;
 
-			DebugBuildingScore(building, score, crime, pollution * SIM_POLLUTION_INFLUENCE, localInfluence, populationEffect, randomEffect);
+			DebugBuildingScore(building, score, crime, pollution * SIM_PARAM(city, pollutionInfluence), localInfluence, populationEffect, randomEffect);
 			
 			// increase or decrease population density based on score
-			if (building->populationDensity < MAX_POPULATION_DENSITY && score >= SIM_INCREMENT_POP_THRESHOLD)
+			if (building->populationDensity < MAX_POPULATION_DENSITY && score >= SIM_PARAM(city, incrementPopThreshold))
 			{
 				populationDensityChange = 1;
 			}
-			else if(building->populationDensity > 0 && score <= SIM_DECREMENT_POP_THRESHOLD)
+			else if(building->populationDensity > 0 && score <= SIM_PARAM(city, decrementPopThreshold))
 			{
 				populationDensityChange = -1;
 			}
 			
-			building->heavyTraffic = building->populationDensity > SIM_HEAVY_TRAFFIC_THRESHOLD;
+			building->heavyTraffic = building->populationDensity > SIM_PARAM(city, heavyTrafficThreshold);
 		}
 		else
 		{
@@ -443,35 +455,46 @@ void SimulateBuilding(Building* building)
 	switch (building->type)
 	{
 	case Residential:
-		State.residentialPopulation += populationDensityChange;
+		state.residentialPopulation += populationDensityChange;
 		break;
 	case Industrial:
-		State.industrialPopulation += populationDensityChange;
+		state.industrialPopulation += populationDensityChange;
 		break;
 	case Commercial:
-		State.commercialPopulation += populationDensityChange;
+		state.commercialPopulation += populationDensityChange;
 		break;
 	}
 
-	RefreshBuildingTiles(building);
+	if (populationDensityChange != 0)
+	{
+		PostBuildingEvent(city, WorldEvent_DensityChanged, building);
+	}
+	if (building->heavyTraffic != hadHeavyTraffic)
+	{
+		PostBuildingEvent(city, WorldEvent_TrafficChanged, building);
+	}
+	if (building->onFire != oldFireState)
+	{
+		PostBuildingEvent(city, WorldEvent_FireStateChanged, building);
+	}
 }
 
-void CountPopulation()
+void CountPopulation(GameState& state)
 {
-	State.residentialPopulation = State.industrialPopulation = State.commercialPopulation = 0;
+	state.residentialPopulation = state.industrialPopulation = state.commercialPopulation = 0;
 
 	for (int n = 0; n < MAX_BUILDINGS; n++)
 	{
-		switch (State.buildings[n].type)
+		switch (state.buildings[n].type)
 		{
 		case Residential:
-			State.residentialPopulation += State.buildings[n].populationDensity;
+			state.residentialPopulation += state.buildings[n].populationDensity;
 			break;
 		case Industrial:
-			State.industrialPopulation += State.buildings[n].populationDensity;
+			state.industrialPopulation += state.buildings[n].populationDensity;
 			break;
 		case Commercial:
-			State.commercialPopulation += State.buildings[n].populationDensity;
+			state.commercialPopulation += state.buildings[n].populationDensity;
 			break;
 		default:
 			break;
@@ -479,132 +502,144 @@ void CountPopulation()
 	}
 }
 
-void CheckScenarioWinLose()	// only called once after December of each year (but before year is incremented)
+bool AreScenarioGoalsMet(const GameState& state)
 {
-	uint8_t scenario=(State.data[0] >> 2);
-	if(scenario)
+	const Scenario& scenario=ScenarioData[state.data[0] >> 2];
+	if(scenario.goalfunds>state.money || scenario.goalrespop>state.residentialPopulation ||
+		scenario.goalcompop>state.commercialPopulation || scenario.goalindpop>state.industrialPopulation)
 	{
-		if(ScenarioData[scenario].goalyear>0 && (ScenarioData[scenario].goalyear-1900) == State.year)
+		return false;
+	}
+
+	for(int i=0; i<SCENARIO_GOAL_BUILDING_COUNT; i++)
+	{
+		if(scenario.goalbuilding[i]!=BuildingType_None && scenario.goalbuildingcount[i]>0)
 		{
-			bool won=true;
-			if(ScenarioData[scenario].goalfunds>State.money)
-			{
-				won=false;
-			}
-			if(ScenarioData[scenario].goalrespop>State.residentialPopulation)
-			{
-				won=false;
-			}
-			if(ScenarioData[scenario].goalcompop>State.commercialPopulation)
+			int count=0;
+			for(int n=0; n<MAX_BUILDINGS; n++)
 			{
-				won=false;
+				if(state.buildings[n].type==scenario.goalbuilding[i])
+				{
+					count++;
+				}
 			}
-			if(ScenarioData[scenario].goalindpop>State.industrialPopulation)
+			if(scenario.goalbuildingcount[i]>count)
 			{
-				won=false;
+				return false;
 			}
+		}
+	}
+	return true;
+}
+
+// Returns SimulationEvent_ScenarioWon or SimulationEvent_ScenarioLost in the scenario's goal year, otherwise 0
+uint8_t CheckScenarioWinLose(GameState& state)	// only called once after December of each year (but before year is incremented)
+{
+	uint8_t scenario=(state.data[0] >> 2);
+	if(scenario)
+	{
+		if(ScenarioData[scenario].goalyear>0 && (ScenarioData[scenario].goalyear-1900) == state.year)
+		{
+			const bool won=AreScenarioGoalsMet(state);
 
-			for(int i=0; i<SCENARIO_GOAL_BUILDING_COUNT; i++)
-			{
-				if(ScenarioData[scenario].goalbuilding[i]!=BuildingType_None && ScenarioData[scenario].goalbuildingcount[i]>0)
-				{
-					int count=0;
-					for(int i=0; i<MAX_BUILDINGS; i++)
-					{
-						if(State.buildings[i].type==ScenarioData[scenario].goalbuilding[i])
-						{
-							count++;
-						}
-					}
-					if(ScenarioData[scenario].goalbuildingcount[i]>count)
-					{
-						won=false;
-					}
-				}
-			}
-		
-			UIState.selection=0;
 			if(won==true)
 			{
-				State.data[0]|=1<<1;
-				UIState.state=ScenarioWinScreen;
+				state.data[0]|=1<<1;
+				return SimulationEvent_ScenarioWon;
 			}
 			else
 			{
-				State.data[0]|=1;
-				UIState.state=ScenarioLoseScreen;
+				state.data[0]|=1;
+				return SimulationEvent_ScenarioLost;
 			}
 		}
 	}
+	return 0;
 }
 
-void Simulate()
+SimulationEvents Simulate(CityContext& city)
 {
-	if((State.flags & FLAG_PAUSE) != FLAG_PAUSE)
+	GameState& state = city.state;
+	SimulationEvents events = { 0, 0, 0 };
+
+	if((state.flags & FLAG_PAUSE) != FLAG_PAUSE)
 	{
-		if (State.simulationStep < MAX_BUILDINGS)
+		if (state.simulationStep < MAX_BUILDINGS)
 		{
-			SimulateBuilding(&State.buildings[State.simulationStep]);
+			SimulateBuilding(city, &state.buildings[state.simulationStep]);
 		}
-		else switch (State.simulationStep)
+		else switch (state.simulationStep)
 		{
 		case SimulatePower:
-			CalculatePowerConnectivity();
+			CalculatePowerConnectivity(city);
 			break;
 		case SimulatePopulation:
-			CountPopulation();
+			CountPopulation(state);
 			break;
 		case SimulateFastNextMonth:
 		case SimulateNextMonth:
-			if(State.simulationStep==SimulateNextMonth || ((State.flags & FLAG_FAST) == FLAG_FAST && State.simulationStep==SimulateFastNextMonth))
+			if(state.simulationStep==SimulateNextMonth || ((state.flags & FLAG_FAST) == FLAG_FAST && state.simulationStep==SimulateFastNextMonth))
 			{
-				DoMonthEndBudget();
+				DoMonthEndBudget(state);
 
-				State.simulationStep = 0;
-				State.month++;
-				if (State.month >= 12)
+				state.simulationStep = 0;
+				state.month++;
+				if (state.month >= 12)
 				{
-					DoYearEndBudget();
+					events.flags |= SimulationEvent_YearEnd;
+					if (DoYearEndBudget(city))
+					{
+						events.flags |= SimulationEvent_BudgetShortfall;
+					}
 
-					CheckScenarioWinLose();		// do this after budget so budget screen won't pop up
+					events.flags |= CheckScenarioWinLose(state);
 
-					State.month = 0;
-					State.year++;
+					state.month = 0;
+					state.year++;
 				}
-				return;
+				return events;
 			}
 		}
 
-		State.simulationStep++;
-		State.timeToNextDisaster--;
+		state.simulationStep++;
+		state.timeToNextDisaster--;
 
-		if (State.timeToNextDisaster == 0)
+		if (state.timeToNextDisaster == 0)
 		{
-			StartRandomFire();
-			State.timeToNextDisaster = (GetRand() % (MAX_TIME_BETWEEN_DISASTERS - MIN_TIME_BETWEEN_DISASTERS)) + MIN_TIME_BETWEEN_DISASTERS;
+			Building* building = StartRandomFire(city);
+			if (building)
+			{
+				events.flags |= SimulationEvent_Disaster;
+				events.x = building->x;
+				events.y = building->y;
+			}
+			// the native tools check the parameters, this only keeps bad ones from dividing by zero
+			const int32_t minTime = SIM_PARAM(city, minTimeBetweenDisasters);
+			const int32_t timeRange = SIM_PARAM(city, maxTimeBetweenDisasters) - minTime;
+			state.timeToNextDisaster = (timeRange > 0 ? GetRand(city) % timeRange : 0) + (minTime > 0 ? minTime : 1);
 		}
 	}
+
+	return events;
 }
 
-bool StartRandomFire()
+Building* StartRandomFire(CityContext& city)
 {
+	GameState& state = city.state;
 	int attemptsLeft = MAX_BUILDINGS;
 
 	while (attemptsLeft)
 	{
-		int index = GetRand() & 0xff;
-		if (index < MAX_BUILDINGS && State.buildings[index].type && !State.buildings[index].onFire && !IsRubble(State.buildings[index].type) && State.buildings[index].type != Park)
+		int index = GetRand(city) & 0xff;
+		if (index < MAX_BUILDINGS && state.buildings[index].type && !state.buildings[index].onFire && !IsRubble(state.buildings[index].type) && state.buildings[index].type != Park)
 		{
-			State.buildings[index].onFire = 1;
-			RefreshBuildingTiles(&State.buildings[index]);
-			FocusTile(State.buildings[index].x + 1, State.buildings[index].y + 1);
-
-			UIState.state = InGameDisaster;
-			UIState.selection = DISASTER_MESSAGE_DISPLAY_TIME;
-			return true;
+			SnapshotBeforeWrite(city, &state.buildings[index], sizeof(Building));
+			state.buildings[index].onFire = 1;
+			PostBuildingEvent(city, WorldEvent_FireStateChanged, &state.buildings[index]);
+			return &state.buildings[index];
 		}
 		attemptsLeft--;
 	}
 
-	return false;
+	return nullptr;
 }
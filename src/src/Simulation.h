@@ -1,5 +1,29 @@
 #pragma once
 
-void Simulate(void);
-bool StartRandomFire(void);
-int32_t GetEstimatedYearTaxes();
\ No newline at end of file
+#include <stdint.h>
+#include "Game.h"
+
+// What happened during a simulation step that the player should know about
+enum SimulationEventFlags
+{
+	SimulationEvent_YearEnd = 1,				// the year end budget has been done
+	SimulationEvent_BudgetShortfall = 2,		// with the year end budget, cash flow or funds are not positive
+	SimulationEvent_ScenarioWon = 4,
+	SimulationEvent_ScenarioLost = 8,
+	SimulationEvent_Disaster = 16,				// x, y - a fire has started in the building there
+};
+
+typedef struct
+{
+	uint8_t flags;
+	uint8_t x;
+	uint8_t y;
+} SimulationEvents;
+
+SimulationEvents Simulate(CityContext& city);
+Building* StartRandomFire(CityContext& city);		// nullptr if no building could be set on fire
+int32_t GetEstimatedYearTaxes(const GameState& state);
+// Road tiles around the outside of the building
+uint8_t GetNumRoadConnections(const CityContext& city, Building* building);
+// Whether the funds, population and building goals of the city's scenario are met right now, whatever the year
+bool AreScenarioGoalsMet(const GameState& state);
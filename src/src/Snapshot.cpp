@@ -0,0 +1,149 @@
+#include "Snapshot.h"
+#include "WorldEvents.h"
+#include "wasmmalloc.h"
+#include "wasmmemcpy.h"
+
+// Start and size of each page, connection map pages first then building pages
+static uint8_t* GetPage(CityContext& city, const uint8_t page, size_t& size)
+{
+	uint8_t* base = city.state.connectionMap;
+	size_t regionSize = sizeof(city.state.connectionMap);
+	size_t offset = page * SNAPSHOT_PAGE_SIZE;
+	if (page >= SNAPSHOT_CONNECTION_PAGES)
+	{
+		base = (uint8_t*)city.state.buildings;
+		regionSize = sizeof(city.state.buildings);
+		offset = (page - SNAPSHOT_CONNECTION_PAGES) * SNAPSHOT_PAGE_SIZE;
+	}
+	size = regionSize - offset < SNAPSHOT_PAGE_SIZE ? regionSize - offset : SNAPSHOT_PAGE_SIZE;
+	return base + offset;
+}
+
+static void FreePages(CitySnapshot& snapshot)
+{
+	for (int n = 0; n < (int)SNAPSHOT_PAGE_COUNT; n++)
+	{
+		if (snapshot.pages[n] != nullptr)
+		{
+			free(snapshot.pages[n]);
+			snapshot.pages[n] = nullptr;
+		}
+	}
+}
+
+bool TakeSnapshot(CityContext& city, CitySnapshot& snapshot)
+{
+	if (city.snapshot == &snapshot)
+	{
+		FreePages(snapshot);
+	}
+	else if (city.snapshot != nullptr)
+	{
+		return false;
+	}
+	else
+	{
+		memset(snapshot.pages, 0, sizeof(snapshot.pages));
+	}
+
+	const uint8_t* state = (const uint8_t*)&city.state;
+	memcpy(snapshot.head, state, SNAPSHOT_HEAD_SIZE);
+	memcpy(snapshot.middle, state + offsetof(GameState, terrainType), SNAPSHOT_MIDDLE_SIZE);
+	memcpy(snapshot.powerGrid, city.powerGrid, sizeof(snapshot.powerGrid));
+	snapshot.powerGridDirty = city.powerGridDirty;
+	snapshot.randVal = city.randVal;
+	snapshot.complete = true;
+	snapshot.city = &city;
+	city.snapshot = &snapshot;
+	return true;
+}
+
+void CopySnapshotPages(CitySnapshot& snapshot, const void* data, const size_t size)
+{
+	CityContext& city = *snapshot.city;
+	const uint8_t* start = (const uint8_t*)data;
+	const uint8_t* end = start + size;
+
+	// the part of the write that falls in each region, as a range of pages
+	const uint8_t* regions[2] = { city.state.connectionMap, (const uint8_t*)city.state.buildings };
+	const size_t regionSizes[2] = { sizeof(city.state.connectionMap), sizeof(city.state.buildings) };
+	const uint8_t firstPages[2] = { 0, SNAPSHOT_CONNECTION_PAGES };
+	for (int r = 0; r < 2; r++)
+	{
+		const uint8_t* regionEnd = regions[r] + regionSizes[r];
+		if (end <= regions[r] || start >= regionEnd)
+		{
+			continue;
+		}
+		const size_t from = start > regions[r] ? start - regions[r] : 0;
+		const size_t to = (end < regionEnd ? end : regionEnd) - regions[r];
+		for (size_t page = firstPages[r] + from / SNAPSHOT_PAGE_SIZE; page <= firstPages[r] + (to - 1) / SNAPSHOT_PAGE_SIZE; page++)
+		{
+			if (snapshot.pages[page] != nullptr)
+			{
+				continue;
+			}
+			size_t pageSize;
+			const uint8_t* contents = GetPage(city, page, pageSize);
+			snapshot.pages[page] = (uint8_t*)malloc(pageSize);
+			if (snapshot.pages[page] == nullptr)
+			{
+				// out of heap, the page has gone so the snapshot can't be restored any more
+				snapshot.complete = false;
+				continue;
+			}
+			memcpy(snapshot.pages[page], contents, pageSize);
+		}
+	}
+}
+
+bool RestoreSnapshot(CitySnapshot& snapshot)
+{
+	if (snapshot.city == nullptr || !snapshot.complete)
+	{
+		return false;
+	}
+	CityContext& city = *snapshot.city;
+
+	// the pages stay copied, they still hold what the city has now it's restored
+	for (int n = 0; n < (int)SNAPSHOT_PAGE_COUNT; n++)
+	{
+		if (snapshot.pages[n] != nullptr)
+		{
+			size_t pageSize;
+			uint8_t* contents = GetPage(city, n, pageSize);
+			memcpy(contents, snapshot.pages[n], pageSize);
+		}
+	}
+
+	uint8_t* state = (uint8_t*)&city.state;
+	memcpy(state, snapshot.head, SNAPSHOT_HEAD_SIZE);
+	memcpy(state + offsetof(GameState, terrainType), snapshot.middle, SNAPSHOT_MIDDLE_SIZE);
+	city.randVal = snapshot.randVal;
+
+	// the building owner map and the screen rebuild from the reset, the power grid comes back as it was
+	PostMapReset(city);
+	memcpy(city.powerGrid, snapshot.powerGrid, sizeof(snapshot.powerGrid));
+	city.powerGridDirty = snapshot.powerGridDirty;
+	return true;
+}
+
+void ReleaseSnapshot(CitySnapshot& snapshot)
+{
+	FreePages(snapshot);
+	if (snapshot.city != nullptr && snapshot.city->snapshot == &snapshot)
+	{
+		snapshot.city->snapshot = nullptr;
+	}
+	snapshot.city = nullptr;
+}
+
+uint8_t GetSnapshotPageCount(const CitySnapshot& snapshot)
+{
+	uint8_t count = 0;
+	for (int n = 0; n < (int)SNAPSHOT_PAGE_COUNT; n++)
+	{
+		count += snapshot.pages[n] != nullptr ? 1 : 0;
+	}
+	return count;
+}
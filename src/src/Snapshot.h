@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Game.h"
+
+// Copy-on-write snapshot of a city, for trying something out (a new building, a tax change, a few years of simulation)
+// and putting the city back afterwards. Taking one copies the small parts of the state and the power grid straight
+// away. The connection map and the buildings are split into pages which are only copied the first time something
+// writes to them, so the snapshot grows with what changes - everything that writes to them calls SnapshotBeforeWrite()
+#define SNAPSHOT_PAGE_SIZE 32
+#define SNAPSHOT_CONNECTION_PAGES ((MAP_WIDTH * MAP_HEIGHT / 4 + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE)
+#define SNAPSHOT_BUILDING_PAGES ((MAX_BUILDINGS * sizeof(Building) + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE)
+#define SNAPSHOT_PAGE_COUNT (SNAPSHOT_CONNECTION_PAGES + SNAPSHOT_BUILDING_PAGES)
+
+// The game state before the connection map, and between it and the buildings
+#define SNAPSHOT_HEAD_SIZE offsetof(GameState, connectionMap)
+#define SNAPSHOT_MIDDLE_SIZE (offsetof(GameState, buildings) - offsetof(GameState, terrainType))
+
+// About 500 bytes plus 32 for every page written, which is at most 1KB more
+struct CitySnapshot
+{
+	CityContext* city;							// nullptr when not taken
+	uint8_t* pages[SNAPSHOT_PAGE_COUNT];		// what each page held when the snapshot was taken, nullptr if it hasn't been written since
+	uint8_t head[SNAPSHOT_HEAD_SIZE];
+	uint8_t middle[SNAPSHOT_MIDDLE_SIZE];
+	uint8_t powerGrid[MAP_WIDTH * MAP_HEIGHT / 8];
+	bool powerGridDirty;
+	uint16_t randVal;
+	bool complete;								// false once a page couldn't be copied
+};
+
+// A city has at most one snapshot - taking it again starts it afresh, false if the city already has a different one
+bool TakeSnapshot(CityContext& city, CitySnapshot& snapshot);
+// Puts the city back as it was when the snapshot was taken. The snapshot is kept, so it can be restored again after
+// trying something else. False if the heap ran out while copying pages, the city is left as it is
+bool RestoreSnapshot(CitySnapshot& snapshot);
+// The city keeps its changes and the copied pages are freed. Needed before the snapshot goes out of scope
+void ReleaseSnapshot(CitySnapshot& snapshot);
+// How many pages have been copied since the snapshot was taken
+uint8_t GetSnapshotPageCount(const CitySnapshot& snapshot);
+
+void CopySnapshotPages(CitySnapshot& snapshot, const void* data, const size_t size);
+
+// Call before writing size bytes of the city's connection map or buildings, it does nothing without a snapshot
+inline void SnapshotBeforeWrite(CityContext& city, const void* data, const size_t size)
+{
+	if (city.snapshot != nullptr)
+	{
+		CopySnapshotPages(*city.snapshot, data, size);
+	}
+}
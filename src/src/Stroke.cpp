@@ -0,0 +1,166 @@
+#include "Stroke.h"
+#include "Building.h"
+#include "Connectivity.h"
+#include "Terrain.h"
+#include "Snapshot.h"
+#include "Arena.h"
+#include "WorldEvents.h"
+#include "wasmmemcpy.h"
+
+uint8_t GetStrokeTiles(uint8_t startX, uint8_t startY, uint8_t endX, uint8_t endY, bool verticalFirst, uint16_t* outTiles)
+{
+	uint8_t count = 0;
+	uint8_t x = startX;
+	uint8_t y = startY;
+	outTiles[count++] = y * MAP_WIDTH + x;
+
+	for (int leg = 0; leg < 2; leg++)
+	{
+		if ((leg == 0) == verticalFirst)
+		{
+			while (y != endY)
+			{
+				y += y < endY ? 1 : -1;
+				outTiles[count++] = y * MAP_WIDTH + x;
+			}
+		}
+		else
+		{
+			while (x != endX)
+			{
+				x += x < endX ? 1 : -1;
+				outTiles[count++] = y * MAP_WIDTH + x;
+			}
+		}
+	}
+	return count;
+}
+
+int GetConnectionTileCost(const CityContext& city, const uint8_t x, const uint8_t y, const uint8_t mask)
+{
+	const uint8_t connections = GetConnections(city, x, y);
+	if (connections & mask)
+	{
+		return 0;
+	}
+	const Building* building = GetBuilding(const_cast<CityContext&>(city), x, y);
+	if (building && !IsRubble(building->type))
+	{
+		return -1;
+	}
+	if (connections != 0 && !IsTerrainClear(city.state.terrainType, x, y))
+	{
+		return -1;
+	}
+	return mask == RoadMask ? ROAD_COST : POWERLINE_COST;
+}
+
+int32_t GetConnectionPathCost(const CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask)
+{
+	int32_t cost = 0;
+	bool bridged = false;
+
+	for (int n = 0; n < count; n++)
+	{
+		const uint8_t x = tiles[n] % MAP_WIDTH;
+		const uint8_t y = tiles[n] / MAP_WIDTH;
+		const int tileCost = GetConnectionTileCost(city, x, y, mask);
+		if (tileCost < 0)
+		{
+			return -1;
+		}
+		cost += tileCost;
+		bridged |= !IsTerrainClear(city.state.terrainType, x, y);
+	}
+	if (!bridged)
+	{
+		return cost;
+	}
+
+	// bridges are checked as if the whole path was already there, a bit for each of its tiles
+	const size_t mark = ScratchMark();
+	uint8_t* planned = (uint8_t*)ScratchAlloc(MAP_WIDTH * MAP_HEIGHT / 8);
+	if (planned == nullptr)
+	{
+		return -1;
+	}
+	memset(planned, 0, MAP_WIDTH * MAP_HEIGHT / 8);
+	for (int n = 0; n < count; n++)
+	{
+		planned[tiles[n] >> 3] |= 1 << (tiles[n] & 7);
+	}
+	for (int n = 0; n < count && cost >= 0; n++)
+	{
+		const uint8_t x = tiles[n] % MAP_WIDTH;
+		const uint8_t y = tiles[n] / MAP_WIDTH;
+		if (!IsTerrainClear(city.state.terrainType, x, y) && !IsSuitableForBridgedTile(city, x, y, mask, planned))
+		{
+			cost = -1;
+		}
+	}
+	ScratchRelease(mark);
+	return cost;
+}
+
+void GetConnectionPathChanges(const CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask, uint16_t& outCells, uint16_t& outBuildings)
+{
+	// a bit for each building slot, rubble can be under more than one tile of the path
+	uint8_t removed[(MAX_BUILDINGS + 7) / 8] = {};
+	outCells = 0;
+	outBuildings = 0;
+
+	for (int n = 0; n < count; n++)
+	{
+		const uint8_t x = tiles[n] % MAP_WIDTH;
+		const uint8_t y = tiles[n] / MAP_WIDTH;
+		if (GetConnections(city, x, y) & mask)
+		{
+			continue;
+		}
+		outCells++;
+		const Building* building = GetBuilding(const_cast<CityContext&>(city), x, y);
+		if (building)
+		{
+			const int slot = building - city.state.buildings;
+			outBuildings += (removed[slot >> 3] & (1 << (slot & 7))) ? 0 : 1;
+			removed[slot >> 3] |= 1 << (slot & 7);
+		}
+	}
+}
+
+bool BuildConnectionPath(CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask, uint8_t& outX, uint8_t& outY, uint8_t& outWidth, uint8_t& outHeight)
+{
+	const int32_t cost = GetConnectionPathCost(city, tiles, count, mask);
+	if (cost < 0 || city.state.money < cost || count == 0)
+	{
+		return false;
+	}
+
+	// the cost has checked every tile and bridge, so it can all go down
+	uint8_t minX = MAP_WIDTH, minY = MAP_HEIGHT, maxX = 0, maxY = 0;
+	for (int n = 0; n < count; n++)
+	{
+		const uint8_t x = tiles[n] % MAP_WIDTH;
+		const uint8_t y = tiles[n] / MAP_WIDTH;
+		Building* building = GetBuilding(city, x, y);
+		if (SetConnectionsQuietly(city, x, y, GetConnections(city, x, y) | mask) && building)
+		{
+			// rubble, anything else failed the cost check
+			PostBuildingEvent(city, WorldEvent_BuildingRemoved, building);
+			SnapshotBeforeWrite(city, building, sizeof(Building));
+			building->type = 0;
+		}
+		minX = x < minX ? x : minX;
+		minY = y < minY ? y : minY;
+		maxX = x > maxX ? x : maxX;
+		maxY = y > maxY ? y : maxY;
+	}
+
+	city.state.money -= cost;
+	outX = minX;
+	outY = minY;
+	outWidth = maxX - minX + 1;
+	outHeight = maxY - minY + 1;
+	PostTileAreaChanged(city, outX, outY, outWidth, outHeight);
+	return true;
+}
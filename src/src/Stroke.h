@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include "Game.h"
+
+// Roads and power lines laid as a whole path of tiles at once, rather than a tile at a time
+// Tiles in a path are y * MAP_WIDTH + x, each one next to the one before
+#define MAX_STROKE_TILES (MAP_WIDTH + MAP_HEIGHT - 1)
+
+// The tiles from the start to the end, a straight line or an L turning once. Along x then y, or y then x if
+// verticalFirst. outTiles needs room for MAX_STROKE_TILES, returns how many there are
+uint8_t GetStrokeTiles(uint8_t startX, uint8_t startY, uint8_t endX, uint8_t endY, bool verticalFirst, uint16_t* outTiles);
+
+// What laying mask on one tile would cost - 0 if it has it already, -1 if it can't take it
+int GetConnectionTileCost(const CityContext& city, const uint8_t x, const uint8_t y, const uint8_t mask);
+
+// What laying mask along the path would cost, tiles that already have it are free. -1 if it can't be built - a building
+// other than rubble is in the way, there's something else bridged over the water already, or a bridge on the path would
+// bend or run alongside another once it's laid
+int32_t GetConnectionPathCost(const CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask);
+
+// How many connection cells and buildings laying mask along the path would change - the tiles that haven't got it and
+// the rubble on them. Tiles that can't take it are counted too, the cost says whether it can be built
+void GetConnectionPathChanges(const CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask, uint16_t& outCells, uint16_t& outBuildings);
+
+// Lays mask along the path, removes any rubble and pays for it. The caches hear about it once through a
+// WorldEvent_TileAreaChanged for the bounding box. Nothing changes if it can't all be built - it costs too much, a tile
+// is blocked or a bridge would bend or run alongside another. outX, outY, outWidth, outHeight are the bounding box
+bool BuildConnectionPath(CityContext& city, const uint16_t* tiles, const uint16_t count, const uint8_t mask, uint8_t& outX, uint8_t& outY, uint8_t& outWidth, uint8_t& outHeight);
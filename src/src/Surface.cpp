@@ -0,0 +1,141 @@
+#include "Surface.h"
+#include "wasm4.h"
+#include "palette.h"
+#include "Draw.h"
+#include "wasmmemcpy.h"
+
+// 2bpp value for a palette color, repeated for all 4 pixels of a byte
+inline uint8_t SurfaceColorByte(const uint8_t color)
+{
+	const uint8_t c = (color - 1) & 3;
+	return (c << 6) | (c << 4) | (c << 2) | c;
+}
+
+void SurfaceClear(Surface &surface, const uint8_t color)
+{
+	if(color == PALETTE_TRANSPARENT)
+	{
+		return;
+	}
+
+	memset(surface.data, SurfaceColorByte(color), GetSurfaceSize(surface.width, surface.height));
+}
+
+void SurfacePutPixel(Surface &surface, const int32_t x, const int32_t y, const uint8_t color)
+{
+	if(color == PALETTE_TRANSPARENT || x < 0 || x >= surface.width || y < 0 || y >= surface.height)
+	{
+		return;
+	}
+
+	const int32_t index = (y * surface.width) + x;
+	const uint8_t shift = (3 - (index & 3)) << 1;
+	uint8_t *ptr = &surface.data[index >> 2];
+	*ptr = (*ptr & ~(3 << shift)) | (((color - 1) & 3) << shift);
+}
+
+void SurfaceFillRect(Surface &surface, int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t color)
+{
+	if(color == PALETTE_TRANSPARENT)
+	{
+		return;
+	}
+
+	// clip to surface
+	if(x < 0)
+	{
+		w += x;
+		x = 0;
+	}
+	if(y < 0)
+	{
+		h += y;
+		y = 0;
+	}
+	if(x + w > surface.width)
+	{
+		w = surface.width - x;
+	}
+	if(y + h > surface.height)
+	{
+		h = surface.height - y;
+	}
+	if(w <= 0 || h <= 0)
+	{
+		return;
+	}
+
+	const uint8_t val = SurfaceColorByte(color);
+	for(int32_t j = y; j < y + h; j++)
+	{
+		int32_t i = x;
+		// leading pixels up to a byte boundary, then whole bytes, then trailing pixels
+		for(; i < x + w && (i & 3) != 0; i++)
+		{
+			SurfacePutPixel(surface, i, j, color);
+		}
+		const int32_t bytes = ((x + w) - i) >> 2;
+		memset(&surface.data[((j * surface.width) + i) >> 2], val, bytes);
+		i += bytes << 2;
+		for(; i < x + w; i++)
+		{
+			SurfacePutPixel(surface, i, j, color);
+		}
+	}
+}
+
+void SurfaceDrawTile(Surface &surface, const uint8_t *data, const int32_t x, const int32_t y, const uint16_t drawcolors)
+{
+	const uint8_t colors[2] = { static_cast<uint8_t>(drawcolors & 0x0f), static_cast<uint8_t>((drawcolors >> 4) & 0x0f) };
+	for(int32_t col = 0; col < 8; col++)
+	{
+		uint8_t bits = data[col];
+		for(int32_t row = 0; row < 8; row++)
+		{
+			SurfacePutPixel(surface, x + col, y + row, colors[bits & 1]);
+			bits >>= 1;
+		}
+	}
+}
+
+void SurfaceBlit1BPP(Surface &surface, const uint8_t *data, const int32_t x, const int32_t y, const int32_t w, const int32_t h, const uint16_t drawcolors)
+{
+	const uint8_t colors[2] = { static_cast<uint8_t>(drawcolors & 0x0f), static_cast<uint8_t>((drawcolors >> 4) & 0x0f) };
+	int32_t bit = 0;
+	for(int32_t row = 0; row < h; row++)
+	{
+		for(int32_t col = 0; col < w; col++)
+		{
+			SurfacePutPixel(surface, x + col, y + row, colors[(data[bit >> 3] >> (7 - (bit & 7))) & 1]);
+			bit++;
+		}
+	}
+}
+
+void BlitSurface(const Surface &surface, const int32_t x, const int32_t y)
+{
+	// 2bpp value n is drawn with DRAW_COLORS nibble n, which maps back to palette color n+1
+	SetDrawColors((PALETTE_BLUE << 12) | (PALETTE_GREEN << 8) | (PALETTE_WHITE << 4) | PALETTE_BLACK);
+	blit(surface.data, x, y, surface.width, surface.height, BLIT_2BPP);
+	COUNT_DRAW_CALL(Blits);
+}
+
+void BlitSurfaceTransparent(const Surface &surface, const int32_t x, const int32_t y, const uint8_t transparentcolor)
+{
+	uint16_t colors = (PALETTE_BLUE << 12) | (PALETTE_GREEN << 8) | (PALETTE_WHITE << 4) | PALETTE_BLACK;
+	colors &= ~(0x0f << (((transparentcolor - 1) & 3) << 2));
+	SetDrawColors(colors);
+	blit(surface.data, x, y, surface.width, surface.height, BLIT_2BPP);
+	COUNT_DRAW_CALL(Blits);
+}
+
+Surface *DrawTarget = nullptr;
+int32_t DrawTargetX = 0;
+int32_t DrawTargetY = 0;
+
+void SetDrawTarget(Surface *surface, const int32_t originx, const int32_t originy)
+{
+	DrawTarget = surface;
+	DrawTargetX = originx;
+	DrawTargetY = originy;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// Off screen 2bpp bitmap in the same format as the WASM-4 framebuffer (4 pixels per byte, first pixel in the high bits)
+// Colors are the PALETTE_ values, PALETTE_TRANSPARENT draws nothing
+// Width must be a multiple of 4
+typedef struct
+{
+	uint8_t *data;
+	int32_t width;
+	int32_t height;
+} Surface;
+
+inline int32_t GetSurfaceSize(const int32_t width, const int32_t height)
+{
+	return (width * height) / 4;
+}
+
+void SurfaceClear(Surface &surface, const uint8_t color);
+void SurfacePutPixel(Surface &surface, const int32_t x, const int32_t y, const uint8_t color);
+void SurfaceFillRect(Surface &surface, int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t color);
+// Draws a 1bpp tile stored the same way as TileData (column major, drawn with BLIT_ROTATE), drawcolors works like DRAW_COLORS
+void SurfaceDrawTile(Surface &surface, const uint8_t *data, const int32_t x, const int32_t y, const uint16_t drawcolors);
+// Draws a row major 1bpp bitmap (as drawn by blit with BLIT_1BPP)
+void SurfaceBlit1BPP(Surface &surface, const uint8_t *data, const int32_t x, const int32_t y, const int32_t w, const int32_t h, const uint16_t drawcolors);
+
+// Copy the surface to the screen
+void BlitSurface(const Surface &surface, const int32_t x, const int32_t y);
+// Copy the surface to the screen, leaving pixels of transparentcolor alone
+void BlitSurfaceTransparent(const Surface &surface, const int32_t x, const int32_t y, const uint8_t transparentcolor);
+
+// When set, PutPixel(), DrawChar() and the rect functions draw into this surface instead of the screen
+// Callers keep using screen coordinates, (originx,originy) is where the surface's top left pixel would be on screen
+extern Surface *DrawTarget;
+extern int32_t DrawTargetX, DrawTargetY;
+void SetDrawTarget(Surface *surface, const int32_t originx, const int32_t originy);
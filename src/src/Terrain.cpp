@@ -1,35 +1,18 @@
 #include <stdint.h>
 #include "Terrain.h"
 #include "Game.h"
+#include "WorldEvents.h"
 #include "Defines.h"
 #include "randommt.h"
 #include "global.h"
 #include "perlinnoise.h"
+#include "Assets.h"
+#include "Arena.h"
+#include "wasm4.h"
+#include "wasmmemcpy.h"
 
-// for animated terrain tile - defined in Draw.cpp
-extern uint8_t AnimationFrame;
-
-const uint8_t Terrain1Data[] =
-{
-#include "Terrain1.inc.h"
-};
-const uint8_t Terrain2Data[] =
-{
-#include "Terrain2.inc.h"
-};
-const uint8_t Terrain3Data[] =
-{
-#include "Terrain3.inc.h"
-};
-const uint8_t Terrain4Data[] =
-{
-#include "Terrain4.inc.h"
-};
-const uint8_t Terrain5Data[] =
-{
-#include "Terrain5.inc.h"
-};
-uint8_t Terrain6Data[288] = {0};
+// Terrain 1-5 are packed assets, only the random terrain is kept unpacked because it's generated at runtime
+THREAD_LOCAL uint8_t Terrain6Data[288] = {0};
 
 /*
 const char Terrain1Str[] = "River";
@@ -65,39 +48,39 @@ const uint8_t* GetTerrainData(uint8_t index)
 	switch (index)
 	{
 	default:
-	case 0: return Terrain1Data;
-	case 1: return Terrain2Data;
-	case 2: return Terrain3Data;
-	case 3: return Terrain4Data;
-	case 4: return Terrain5Data;
+	case 0: return UnpackAsset(Asset_Terrain1);
+	case 1: return UnpackAsset(Asset_Terrain2);
+	case 2: return UnpackAsset(Asset_Terrain3);
+	case 3: return UnpackAsset(Asset_Terrain4);
+	case 4: return UnpackAsset(Asset_Terrain5);
 	case 5: return Terrain6Data;
 	}
 
 }
 
-bool IsTerrainClear(int x, int y)
+// Resolved terrain tile (edge/corner or variant) for every map tile, so a lookup is a single array read
+// Costs MAP_WIDTH*MAP_HEIGHT bytes (2304) of RAM, and is rebuilt whenever the terrain type changes or a random map is generated
+static THREAD_LOCAL uint8_t TerrainTileCache[MAP_WIDTH * MAP_HEIGHT];
+static THREAD_LOCAL uint8_t TerrainTileCacheType = 0xff;		// terrain type the cache was built for, 0xff when invalid
+
+// Reads the terrain bitmap directly - used to build the cache
+static bool IsTerrainDataClear(const uint8_t *terrain, int x, int y)
 {
 	int32_t bitpos=(y*MAP_WIDTH)+x;
 	int32_t byte=bitpos/8;
 	int32_t bit=7-bitpos%8;
-	
-	const uint8_t *terrain=GetTerrainData(State.terrainType);
+
 	return ((terrain[byte] & (1 << bit)) != 0);
 }
 
-uint8_t GetTerrainTile(int x, int y)
+static uint8_t CalculateTerrainTile(const uint8_t *terrain, int x, int y)
 {
-	if(x<0 || x>=MAP_WIDTH || y<0 || y>=MAP_HEIGHT)
-	{
-		return 0;
-	}
+	bool northClear = y == 0 || IsTerrainDataClear(terrain, x, y - 1);
+	bool eastClear = x >= MAP_WIDTH - 1 || IsTerrainDataClear(terrain, x + 1, y);
+	bool southClear = y >= MAP_HEIGHT - 1 || IsTerrainDataClear(terrain, x, y + 1);
+	bool westClear = x == 0 || IsTerrainDataClear(terrain, x - 1, y);
 
-	bool northClear = y == 0 || IsTerrainClear(x, y - 1);
-	bool eastClear = x >= MAP_WIDTH - 1 || IsTerrainClear(x + 1, y);
-	bool southClear = y >= MAP_HEIGHT - 1 || IsTerrainClear(x, y + 1);
-	bool westClear = x == 0 || IsTerrainClear(x - 1, y);
-
-	if (IsTerrainClear(x, y))
+	if (IsTerrainDataClear(terrain, x, y))
 	{
 		if (!northClear && !westClear)
 			return NORTH_WEST_EDGE_TILE;
@@ -116,69 +99,180 @@ uint8_t GetTerrainTile(int x, int y)
 	}
 }
 
-uint8_t GetAnimatedTerrainTile(int x, int y)
+static void BuildTerrainTileCache(const uint8_t terrainType)
+{
+	const size_t mark=ScratchMark();
+	const uint8_t *terrain=GetTerrainData(terrainType);
+	uint8_t *tile=TerrainTileCache;
+	if(terrain==nullptr)
+	{
+		// the packed terrain couldn't be unpacked, the scratch arena is full. The map reads as plain land for now, the
+		// cache stays invalid so the next lookup tries again
+#ifndef NATIVE_BUILD
+		trace("terrain: no scratch space to unpack the terrain");
+#endif
+		memset(TerrainTileCache, FIRST_TERRAIN_TILE, sizeof(TerrainTileCache));
+		TerrainTileCacheType=0xff;
+		ScratchRelease(mark);
+		return;
+	}
+	for(int y=0; y<MAP_HEIGHT; y++)
+	{
+		for(int x=0; x<MAP_WIDTH; x++)
+		{
+			*tile++=CalculateTerrainTile(terrain, x, y);
+		}
+	}
+	TerrainTileCacheType=terrainType;
+	ScratchRelease(mark);
+}
+
+void InvalidateTerrainTileCache()
 {
-	uint8_t tile = GetTerrainTile(x,y);
+	TerrainTileCacheType=0xff;
+}
 
-	// animation logic from GetCachedTile(int x, int y) in Draw.cpp
+static uint8_t GetTerrainTile(const uint8_t terrainType, int x, int y)
+{
+	if(x<0 || x>=MAP_WIDTH || y<0 || y>=MAP_HEIGHT)
+	{
+		return 0;
+	}
 
-	// Animate water tiles
-	if (tile >= FIRST_WATER_TILE && tile <= LAST_WATER_TILE)
+	if(TerrainTileCacheType!=terrainType)
 	{
-		tile = FIRST_WATER_TILE + ((tile - FIRST_WATER_TILE + (AnimationFrame >> 3)) & 3);
+		BuildTerrainTileCache(terrainType);
 	}
 
-	return tile;
+	return TerrainTileCache[(y*MAP_WIDTH)+x];
 }
 
-void GenerateRandomTerrain(const uint8_t terrainType, const uint64_t seed)
+bool IsTerrainClear(const uint8_t terrainType, int x, int y)
+{
+	// off the map counts as land, the same as the edges of the terrain tiles
+	if(x<0 || x>=MAP_WIDTH || y<0 || y>=MAP_HEIGHT)
+	{
+		return true;
+	}
+
+	const uint8_t tile=GetTerrainTile(terrainType, x, y);
+	return (tile < FIRST_WATER_TILE || tile > LAST_WATER_TILE);
+}
+
+bool IsTerrainClear(int x, int y)
+{
+	return IsTerrainClear(State.terrainType, x, y);
+}
+
+uint8_t GetTerrainTile(int x, int y)
+{
+	return GetTerrainTile(State.terrainType, x, y);
+}
+
+// State of the progressive random terrain generator, so generation can be spread over several frames
+// Noise permutation is kept in PerlinNoise::Instance()
+static THREAD_LOCAL int32_t GeneratorOffsetX = 0;
+static THREAD_LOCAL int32_t GeneratorOffsetY = 0;
+static THREAD_LOCAL uint8_t GeneratorRow = MAP_HEIGHT;		// next row to generate, MAP_HEIGHT when idle
+
+// Generate one row of the random terrain map
+void GenerateRandomTerrainRow(const PerlinNoise &perlin, const int32_t offsetx, const int32_t offsety, const int32_t y)
+{
+	// Use perlin noise to generate terrain
+	// noise coordinates are (offset+pos)/32.0, so pass them in 1/32 grid units
+	static_assert(PERLIN_GRID_SUBDIVISIONS == 32, "terrain scale assumes noise grid is 32 tiles");
+	constexpr int32_t waterThreshold = (-3 * 65536) / 10;		// -0.3 in Q16
+
+	for(int32_t x=0; x<MAP_WIDTH; x++)
+	{
+		const int32_t ph=perlin.Get(static_cast<int64_t>(offsetx)+x,static_cast<int64_t>(offsety)+y,128,10);
+
+		int32_t bitpos=(y*MAP_WIDTH)+x;
+		int32_t byte=bitpos/8;
+		int32_t bit=(7-(bitpos%8));
+
+		if(ph<waterThreshold)
+		{
+
+			Terrain6Data[byte]=Terrain6Data[byte] & ~(0xff & (1 << bit));
+		}
+		else
+		{
+			Terrain6Data[byte]=Terrain6Data[byte] | (0xff & (1 << bit));
+		}
+
+	}
+}
+
+void StartRandomTerrainGeneration(const uint8_t terrainType, const uint64_t seed)
 {
 	if(terrainType!=5)
 	{
+		CancelRandomTerrainGeneration();
 		return;
 	}
 
 	RandomMT rand;
 	rand.Seed(seed);
 
-	PerlinNoise perlin;
-	perlin.Setup(rand.Next());
+	PerlinNoise::Instance().Setup(rand.Next());
 
-	int32_t offsetx=rand.Next();
-	int32_t offsety=rand.Next();
+	GeneratorOffsetX=rand.Next();
+	GeneratorOffsetY=rand.Next();
 
-	if(offsetx<0)
+	if(GeneratorOffsetX<0)
 	{
-		offsetx=-offsetx;
+		GeneratorOffsetX=-GeneratorOffsetX;
 	}
-	if(offsety<0)
+	if(GeneratorOffsetY<0)
 	{
-		offsety=-offsety;
+		GeneratorOffsetY=-GeneratorOffsetY;
 	}
 
-	// Use perlin noise to generate terrain
-	for(int32_t y=0; y<MAP_HEIGHT; y++)
+	GeneratorRow=0;
+}
+
+bool StepRandomTerrainGeneration(const int32_t rows)
+{
+	if(GeneratorRow<MAP_HEIGHT)
 	{
-		for(int32_t x=0; x<MAP_WIDTH; x++)
+		const PerlinNoise &perlin=PerlinNoise::Instance();
+		for(int32_t i=0; i<rows && GeneratorRow<MAP_HEIGHT; i++)
 		{
-			double px=static_cast<double>(offsetx+x)/32.0;
-			double py=static_cast<double>(offsety+y)/32.0;
-			double ph=perlin.Get(px,py,128,10);
+			GenerateRandomTerrainRow(perlin,GeneratorOffsetX,GeneratorOffsetY,GeneratorRow);
+			GeneratorRow++;
+		}
+		InvalidateTerrainTileCache();
+#ifndef NATIVE_BUILD
+		// on the native build the terrain belongs to the thread, not to MainCity
+		PostMapReset(MainCity);
+#endif
+	}
+	return GeneratorRow>=MAP_HEIGHT;
+}
 
-			int32_t bitpos=(y*MAP_WIDTH)+x;
-			int32_t byte=bitpos/8;
-			int32_t bit=(7-(bitpos%8));
+void CancelRandomTerrainGeneration()
+{
+	GeneratorRow=MAP_HEIGHT;
+}
 
-			if(ph<-0.3)
-			{
+bool IsGeneratingRandomTerrain()
+{
+	return GeneratorRow<MAP_HEIGHT;
+}
 
-				Terrain6Data[byte]=Terrain6Data[byte] & ~(0xff & (1 << bit));
-			}
-			else
-			{
-				Terrain6Data[byte]=Terrain6Data[byte] | (0xff & (1 << bit));
-			}
+uint8_t GetRandomTerrainProgress()
+{
+	return GeneratorRow;
+}
 
-		}
+void GenerateRandomTerrain(const uint8_t terrainType, const uint64_t seed)
+{
+	if(terrainType!=5)
+	{
+		return;
 	}
+
+	StartRandomTerrainGeneration(terrainType,seed);
+	StepRandomTerrainGeneration(MAP_HEIGHT);
 }
@@ -1,18 +1,23 @@
 #pragma once
 
 uint8_t GetTerrainTile(int x, int y);
-uint8_t GetAnimatedTerrainTile(int x, int y);
-bool IsTerrainClear(int x, int y);
+uint8_t GetAnimatedTerrainTile(int x, int y);		// in Draw.cpp, water follows the animation frame
+bool IsTerrainClear(const uint8_t terrainType, int x, int y);
+bool IsTerrainClear(int x, int y);		// terrain of MainCity
+void InvalidateTerrainTileCache(void);		// call if the terrain data of the current terrain type changes
 
 //const char* GetTerrainDescription(uint8_t index);
+// Terrain bitmap (1 bit per tile, set for land), packed terrains are expanded into the scratch arena - see UnpackAsset()
 const uint8_t* GetTerrainData(uint8_t index);
 void GenerateRandomTerrain(const uint8_t terrainType, const uint64_t seed);
 
+// Progressive version of GenerateRandomTerrain - starting a new generation cancels any in progress
+void StartRandomTerrainGeneration(const uint8_t terrainType, const uint64_t seed);
+bool StepRandomTerrainGeneration(const int32_t rows);		// returns true once the whole map is generated
+void CancelRandomTerrainGeneration(void);
+bool IsGeneratingRandomTerrain(void);
+uint8_t GetRandomTerrainProgress(void);						// number of rows generated so far
+
 /*
-extern const uint8_t Terrain1Data[];
-extern const uint8_t Terrain2Data[];
-extern const uint8_t Terrain3Data[];
-extern const uint8_t Terrain4Data[];
-extern const uint8_t Terrain5Data[];
 extern uint8_t Terrain6Data[];
 */
\ No newline at end of file
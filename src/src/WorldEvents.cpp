@@ -0,0 +1,57 @@
+#include "WorldEvents.h"
+
+WorldEventListener WorldEventListeners[Num_WorldEventTypes][MAX_WORLD_EVENT_LISTENERS];
+uint8_t NumWorldEventListeners[Num_WorldEventTypes];
+
+bool AddWorldEventListener(uint8_t type, WorldEventListener listener)
+{
+	if (type >= Num_WorldEventTypes || NumWorldEventListeners[type] >= MAX_WORLD_EVENT_LISTENERS)
+	{
+		return false;
+	}
+
+	WorldEventListeners[type][NumWorldEventListeners[type]++] = listener;
+	return true;
+}
+
+bool AddWorldEventListenerToAll(WorldEventListener listener)
+{
+	bool added = true;
+	for (int type = 0; type < Num_WorldEventTypes; type++)
+	{
+		added &= AddWorldEventListener(type, listener);
+	}
+	return added;
+}
+
+void PostWorldEvent(const WorldEvent& event)
+{
+	for (int n = 0; n < NumWorldEventListeners[event.type]; n++)
+	{
+		WorldEventListeners[event.type][n](event);
+	}
+}
+
+void PostTileConnectionChanged(CityContext& city, uint8_t x, uint8_t y)
+{
+	const WorldEvent event = { &city, WorldEvent_TileConnectionChanged, x, y, nullptr, 0, 0 };
+	PostWorldEvent(event);
+}
+
+void PostTileAreaChanged(CityContext& city, uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+	const WorldEvent event = { &city, WorldEvent_TileAreaChanged, x, y, nullptr, width, height };
+	PostWorldEvent(event);
+}
+
+void PostBuildingEvent(CityContext& city, uint8_t type, Building* building)
+{
+	const WorldEvent event = { &city, type, building->x, building->y, building, 0, 0 };
+	PostWorldEvent(event);
+}
+
+void PostMapReset(CityContext& city)
+{
+	const WorldEvent event = { &city, WorldEvent_MapReset, 0, 0, nullptr, 0, 0 };
+	PostWorldEvent(event);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Building.h"
+
+struct CityContext;
+
+// Changes to the city that cached or derived data needs to know about
+// Listeners are called straight away from inside whatever made the change
+enum WorldEventType
+{
+	WorldEvent_TileConnectionChanged = 0,	// x, y - roads or power lines (including building footprints) changed
+	WorldEvent_TileAreaChanged,				// x, y, width, height - roads or power lines changed on any of these tiles
+	WorldEvent_BuildingPlaced,				// building
+	WorldEvent_BuildingDestroyed,			// building - has just turned into rubble
+	WorldEvent_BuildingRemoved,				// building - is about to be removed, it still has its type and position
+	WorldEvent_DensityChanged,				// building
+	WorldEvent_FireStateChanged,			// building
+	WorldEvent_TrafficChanged,				// building
+	WorldEvent_PowerChanged,				// building - hasPower changed
+	WorldEvent_MapReset,					// the whole map may have changed (new city, loaded city, terrain)
+	Num_WorldEventTypes
+};
+
+typedef struct
+{
+	CityContext* city;		// the city that changed, listeners for the screen only care about MainCity
+	uint8_t type;
+	uint8_t x;
+	uint8_t y;
+	Building* building;		// nullptr for tile and map events
+	uint8_t width;			// area events only
+	uint8_t height;
+} WorldEvent;
+
+typedef void (*WorldEventListener)(const WorldEvent& event);
+
+// Listener tables are fixed size, this is the most listeners for each event type
+#define MAX_WORLD_EVENT_LISTENERS 6
+
+// Returns false if there's no room left for that event type
+bool AddWorldEventListener(uint8_t type, WorldEventListener listener);
+// Adds the listener to every event type
+bool AddWorldEventListenerToAll(WorldEventListener listener);
+
+void PostWorldEvent(const WorldEvent& event);
+void PostTileConnectionChanged(CityContext& city, uint8_t x, uint8_t y);
+// One event for many connection changes, so the caches are only invalidated once
+void PostTileAreaChanged(CityContext& city, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void PostBuildingEvent(CityContext& city, uint8_t type, Building* building);
+void PostMapReset(CityContext& city);
@@ -1,9 +0,0 @@
-#pragma once
-
-#include <stdint.h>
-
-extern const uint8_t democity[];
-extern const uint8_t coastalscenario[];
-extern const uint8_t ruralscenario[];
-extern const uint8_t revitalizescenario[];
-extern const uint8_t islandscenario[];
\ No newline at end of file
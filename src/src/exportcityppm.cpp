@@ -3,12 +3,12 @@
 #include <stdint.h>
 
 #include "printf.h"
-#include "wasmnew.h"
+#include "Arena.h"
 #include "wasm4.h"
 #include "Defines.h"
 #include "Terrain.h"
 
-uint8_t CalculateTile(int x, int y);
+uint8_t GetResolvedTile(int x, int y);
 const uint8_t GetTileColor(const uint8_t tile);
 const uint8_t* GetTileData(uint8_t tile);
 
@@ -28,15 +28,20 @@ void ExportCityPPM()
     {
       terrain[x]=GetAnimatedTerrainTile(x,y);
       terraincolors[x]=GetTileColor(terrain[x]);
-      tiles[x]=CalculateTile(x,y);
+      tiles[x]=GetResolvedTile(x,y);
       colors[x]=GetTileColor(tiles[x]);
     }
     for(int py=0; py<8; py++)
     {
       int lp=0;
       //char line[384*4*3+1];
-      char *line=new char[384*4*3+1];
-      for(int i=0; i<385*4*3; i++)
+      const size_t mark=ScratchMark();
+      char *line=(char *)ScratchAlloc(384*4*3+1);
+      if(line==nullptr)
+      {
+        return;
+      }
+      for(int i=0; i<384*4*3; i++)
       {
         line[i]=' ';
       }
@@ -103,7 +108,7 @@ void ExportCityPPM()
         }
       }
       trace(line);
-      delete [] line;
+      ScratchRelease(mark);
     }
   }
 }
@@ -2,6 +2,14 @@
 
 #include <stdint.h>
 
+// Scratch arena, terrain caches and the noise generator are per thread on the native build, where
+// the batch simulator runs a city on every core. The cart only has the one thread
+#ifdef NATIVE_BUILD
+#define THREAD_LOCAL thread_local
+#else
+#define THREAD_LOCAL
+#endif
+
 namespace global
 {
     extern int64_t ticks;
@@ -1,14 +1,50 @@
 #include "perlinnoise.h"
 #include "randommt.h"
-#include "wasmmath.h"
+#include "global.h"
+
+// cos(a*2*pi/256) for a=0..64 in Q14, the rest of the circle is mirrored from this
+const int16_t QuarterCosTable[65] =
+{
+	16384, 16379, 16364, 16340, 16305, 16261, 16207, 16143, 16069, 15986, 15893, 15791, 15679, 15557, 15426, 15286,
+	15137, 14978, 14811, 14635, 14449, 14256, 14053, 13842, 13623, 13395, 13160, 12916, 12665, 12406, 12140, 11866,
+	11585, 11297, 11003, 10702, 10394, 10080, 9760, 9434, 9102, 8765, 8423, 8076, 7723, 7366, 7005, 6639,
+	6270, 5897, 5520, 5139, 4756, 4370, 3981, 3590, 3196, 2801, 2404, 2006, 1606, 1205, 804, 402,
+	0
+};
+
+inline int32_t CosQ14(const uint8_t angle)
+{
+	const uint8_t q = angle & 63;
+	switch (angle >> 6)
+	{
+	default:
+	case 0: return QuarterCosTable[q];
+	case 1: return -QuarterCosTable[64 - q];
+	case 2: return -QuarterCosTable[q];
+	case 3: return QuarterCosTable[64 - q];
+	}
+}
+
+inline int32_t SinQ14(const uint8_t angle)
+{
+	return CosQ14(angle - 64);
+}
+
+// 1 - 6d^5 + 15d^4 - 10d^3 for d=dist/PERLIN_GRID_SUBDIVISIONS, returned in Q15
+// Evaluated as S^5 + d^3(d(15S - 6d) - 10S^2) with S=PERLIN_GRID_SUBDIVISIONS so it is exact before the final rounding
+inline int32_t Fade(const int32_t dist)
+{
+	constexpr int32_t s = PERLIN_GRID_SUBDIVISIONS;
+	constexpr int32_t shift = (PERLIN_GRID_SHIFT * 5) - 15;
+	const int32_t poly = (s * s * s * s * s) + (dist * dist * dist) * ((dist * ((15 * s) - (6 * dist))) - (10 * s * s));
+	return (poly + (1 << (shift - 1))) >> shift;
+}
 
 PerlinNoise::PerlinNoise()
 {
 	for(int i=0; i<256; i++)
 	{
 		m_perm[i]=i;
-		m_dx[i]=0;
-		m_dy[i]=0;
 	}
 }
 
@@ -19,7 +55,7 @@ PerlinNoise::~PerlinNoise()
 
 PerlinNoise &PerlinNoise::Instance()
 {
-	static PerlinNoise p;
+	static THREAD_LOCAL PerlinNoise p;
 	return p;
 }
 
@@ -36,100 +72,60 @@ void PerlinNoise::Setup(const uint64_t seed)
 	for(int i=256-1; i>0; i--)
 	{
 		int j=rand.Next()%(i+1);
-		int16_t temp=m_perm[j];
+		uint8_t temp=m_perm[j];
 		m_perm[j]=m_perm[i];
 		m_perm[i]=temp;
 	}
 
-	// calculate dirs
-	for(int i=0; i<256; i++)
-	{		 
-		m_dx[i]=_cos(static_cast<double>(m_perm[i])*2.0*M_PI/256.0);
-		m_dy[i]=_sin(static_cast<double>(m_perm[i])*2.0*M_PI/256.0);
-	}
+	// direction for hashed value h is the angle m_perm[h] (see Surflet)
 }
 
-double PerlinNoise::Surflet(const double x, const double y, const int64_t per, int64_t gridx, int64_t gridy) const
+// distx and disty are x-gridx and y-gridy in 1/PERLIN_GRID_SUBDIVISIONS units, so in the range [-PERLIN_GRID_SUBDIVISIONS,PERLIN_GRID_SUBDIVISIONS]
+int32_t PerlinNoise::Surflet(const int32_t distx, const int32_t disty, const uint8_t hashed) const
 {
-	const double dgridx=static_cast<double>(gridx);
-	const double dgridy=static_cast<double>(gridy);
-	//double distx=_dabs(x-static_cast<double>(gridx));
-	//double disty=_dabs(y-static_cast<double>(gridy));
-	const double distx=_dabs(x-dgridx);
-	const double disty=_dabs(y-dgridy);
-	const double polyx=1.0-(6.0*_pow(distx,5))+(15.0*_pow(distx,4))-(10.0*_pow(distx,3));
-	const double polyy=1.0-(6.0*_pow(disty,5))+(15.0*_pow(disty,4))-(10.0*_pow(disty,3));
-	const int16_t hashed=m_perm[(m_perm[(gridx%per)%256ULL]+(gridy%per))%256ULL];
-	const double grad=(x-dgridx)*m_dx[hashed]+(y-dgridy)*m_dy[hashed];
-	return polyx*polyy*grad;
+	const int32_t polyx=Fade(distx < 0 ? -distx : distx);
+	const int32_t polyy=Fade(disty < 0 ? -disty : disty);
+	const uint8_t angle=m_perm[hashed];
+	const int32_t grad=distx*CosQ14(angle)+disty*SinQ14(angle);		// Q14 + PERLIN_GRID_SHIFT
+	const int32_t poly=(polyx*polyy) >> 15;								// Q15
+	return static_cast<int32_t>((static_cast<int64_t>(poly)*grad) >> (14 + PERLIN_GRID_SHIFT + 15 - 16));
 }
 
-double PerlinNoise::Noise(double x, double y, const int64_t per) const
+int32_t PerlinNoise::Noise(const int64_t x, const int64_t y, const int64_t per) const
 {
-/*
-	    def surflet(gridX, gridY):
-        distX, distY = abs(x-gridX), abs(y-gridY)
-        polyX = 1 - 6*distX**5 + 15*distX**4 - 10*distX**3
-        polyY = 1 - 6*distY**5 + 15*distY**4 - 10*distY**3
-        hashed = perm[perm[int(gridX)%per] + int(gridY)%per]
-        grad = (x-gridX)*dirs[hashed][0] + (y-gridY)*dirs[hashed][1]
-        return polyX * polyY * grad
-    intX, intY = int(x), int(y)
-    return (surflet(intX+0, intY+0) + surflet(intX+1, intY+0) +
-            surflet(intX+0, intY+1) + surflet(intX+1, intY+1))
-			*/
-	//trace("PerlinNoise::Noise start");
-	/*
-	auto surflet=[&x,&y,&per,*this,&debug](int64_t gridx, int64_t gridy) -> double 
-	{ 
-		const double dgridx=static_cast<double>(gridx);
-		const double dgridy=static_cast<double>(gridy);
-		//double distx=_dabs(x-static_cast<double>(gridx));
-		//double disty=_dabs(y-static_cast<double>(gridy));
-		const double distx=_dabs(x-dgridx);
-		const double disty=_dabs(y-dgridy);
-		const double polyx=1.0-(6.0*_pow(distx,5))+(15.0*_pow(distx,4))-(10.0*_pow(distx,3));
-		const double polyy=1.0-(6.0*_pow(disty,5))+(15.0*_pow(disty,4))-(10.0*_pow(disty,3));
-		if(debug)
-		{
-			//tracef("before hashed per=%d gx=%d gy=%d",per,gridx,gridy);
-			//trace("debug");
-			snprintf(global::buff,global::buffsize-1,"dx=%f dy=%f px=%f py=%f",distx,disty,polyx,polyy);
-			global::buff[global::buffsize-1]='\0';
-			trace(global::buff);
-		}
-		const int16_t hashed=m_perm[(m_perm[(gridx%per)%256ULL]+(gridy%per))%256ULL];
-		if(debug)
-		{
-			//tracef("after hashed %d",hashed);
-		}
-		const double grad=(x-dgridx)*m_dx[hashed]+(y-dgridy)*m_dy[hashed];
-		return polyx*polyy*grad;
-	};
-	*/
-	
-	const int64_t intx=static_cast<int64_t>(x);
-	const int64_t inty=static_cast<int64_t>(y);
-	//trace("PerlinNoise::Noise returning");
-	//return surflet(intx+0,inty+0)+surflet(intx+1,inty+0)+surflet(intx+0,inty+1)+surflet(intx+1,inty+1);
-	return Surflet(x,y,per,intx+0,inty+0)+Surflet(x,y,per,intx+1,inty+0)+Surflet(x,y,per,intx+0,inty+1)+Surflet(x,y,per,intx+1,inty+1);
+	const int64_t intx=x >> PERLIN_GRID_SHIFT;
+	const int64_t inty=y >> PERLIN_GRID_SHIFT;
+	const int32_t fracx=static_cast<int32_t>(x & (PERLIN_GRID_SUBDIVISIONS - 1));
+	const int32_t fracy=static_cast<int32_t>(y & (PERLIN_GRID_SUBDIVISIONS - 1));
+
+	// (grid % per) % 256 for a power of 2 period
+	const uint8_t mask=static_cast<uint8_t>((per - 1) & 0xff);
+	const uint8_t gx0=static_cast<uint8_t>(intx) & mask;
+	const uint8_t gx1=static_cast<uint8_t>(intx + 1) & mask;
+	const uint8_t gy0=static_cast<uint8_t>(inty) & mask;
+	const uint8_t gy1=static_cast<uint8_t>(inty + 1) & mask;
+
+	return Surflet(fracx,fracy,m_perm[static_cast<uint8_t>(m_perm[gx0]+gy0)])
+		+Surflet(fracx-PERLIN_GRID_SUBDIVISIONS,fracy,m_perm[static_cast<uint8_t>(m_perm[gx1]+gy0)])
+		+Surflet(fracx,fracy-PERLIN_GRID_SUBDIVISIONS,m_perm[static_cast<uint8_t>(m_perm[gx0]+gy1)])
+		+Surflet(fracx-PERLIN_GRID_SUBDIVISIONS,fracy-PERLIN_GRID_SUBDIVISIONS,m_perm[static_cast<uint8_t>(m_perm[gx1]+gy1)]);
 }
 
-double PerlinNoise::Get(const double x, const double y, const int64_t per, const int32_t oct) const
+int32_t PerlinNoise::Get(const int64_t x, const int64_t y, const int64_t per, const int32_t oct) const
 {
-/*
-	    val = 0
-    for o in range(octs):
-        val += 0.5**o * noise(x*2**o, y*2**o, per*2**o)
-    return val
-	*/
-
-	double val=0;
+	int32_t val=0;
 	for(int i=0; i<oct; i++)
 	{
-		//trace("PerlinNoise::Get before");
-		val+=_pow(0.5,i)*Noise(static_cast<double>(x)*_pow(2.0,i),static_cast<double>(y)*_pow(2.0,i),per*_pow(2.0,i));
-		//trace("PerlinNoise::Get after");
+		const int64_t ox=x << i;
+		const int64_t oy=y << i;
+
+		// once the coordinates land on grid points every surflet is 0, and so is every higher octave
+		if(((ox | oy) & (PERLIN_GRID_SUBDIVISIONS - 1)) == 0)
+		{
+			break;
+		}
+
+		val+=Noise(ox,oy,per << i) >> i;
 	}
 	return val;
 }
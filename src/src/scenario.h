@@ -17,7 +17,7 @@ typedef struct
     const char *description;
     uint8_t flags;
     uint8_t mapidx;
-    const uint8_t *stateptr;                        // pointer to initial saved game state
+    uint8_t stateasset;                             // packed asset with the initial saved game state, Asset_None for none
     uint16_t startyear;
     uint16_t goalyear;                              // year goal
     int32_t startfunds;
@@ -31,3 +31,8 @@ typedef struct
 
 extern const Scenario ScenarioData[];
 
+struct CityContext;
+
+// Sets the city up as the start of a scenario - its saved city, start year and funds. False for a sandbox
+bool StartScenario(CityContext &city, const uint8_t scenario);
+
@@ -3,6 +3,22 @@
 #include <stdint.h>
 
 static uint8_t init=0;
+static size_t heaptop=0;    // bytes from __heap_base to the end of the highest allocation
+
+static void* trackheaptop( void *ptr, size_t size )
+{
+    extern void* __heap_base;
+    if(ptr!=NULL && (size_t)ptr+size-(size_t)&__heap_base>heaptop)
+    {
+        heaptop=(size_t)ptr+size-(size_t)&__heap_base;
+    }
+    return ptr;
+}
+
+size_t GetHeapHighWaterMark( void )
+{
+    return heaptop;
+}
 
 void* malloc( size_t size )
 {
@@ -12,7 +28,7 @@ void* malloc( size_t size )
         ta_init(&__heap_base,(void *)0xffff,256,16,8);
         init=1;
     }
-    return ta_alloc(size);
+    return trackheaptop(ta_alloc(size),size);
 }
 
 void* calloc( size_t num, size_t size )
@@ -23,7 +39,7 @@ void* calloc( size_t num, size_t size )
         ta_init(&__heap_base,(void *)0xffff,256,16,8);
         init=1;
     }
-    return ta_calloc(num,size);
+    return trackheaptop(ta_calloc(num,size),num*size);
 }
 
 void free( void *ptr )
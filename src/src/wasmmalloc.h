@@ -9,6 +9,8 @@ extern "C" {
 void* malloc( size_t size );
 void free( void *ptr );
 void* calloc( size_t num, size_t size );
+// Highest address used by the heap so far, as an offset from __heap_base
+size_t GetHeapHighWaterMark( void );
 
 #ifdef __cplusplus
 }
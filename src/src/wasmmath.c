@@ -45,16 +45,238 @@ float normalized_atan2( float y, float x )
 }
 
 
-/*
-	quick and dirty sin / cos 
-	https://stackoverflow.com/questions/2284860/how-does-c-compute-sin-and-other-math-functions
-*/
+// bits of a double, for splitting off and building exponents
+typedef union
+{
+    double d;
+    uint64_t u;
+} DoubleBits;
+
+// 2^n for n in the normal exponent range [-1022,1023]
+static double pow2i(int32_t n)
+{
+    DoubleBits b;
+    b.u=(uint64_t)(n+1023)<<52;
+    return b.d;
+}
+
+// x*2^n for n in [-1075,1024]
+static double scale2(double x, int32_t n)
+{
+    if(n>1023)
+    {
+        x*=pow2i(1023);
+        n-=1023;
+    }
+    else if(n<-1022)
+    {
+        x*=pow2i(-1022);
+        n+=1022;
+    }
+    return x*pow2i(n);
+}
+
+// x^n by repeated squaring, log2(n) multiplies instead of n
+double _ipow(double x, int32_t n)
+{
+    uint32_t e=(n<0 ? 0u-(uint32_t)n : (uint32_t)n);
+    double r=1.0;
+    while(e)
+    {
+        if(e & 1)
+        {
+            r*=x;
+        }
+        x*=x;
+        e>>=1;
+    }
+    return (n<0 ? 1.0/r : r);
+}
+
+// ln(2) split so k*LN2_HI is exact for any exponent k
+#define LN2_HI  6.93147180369123816490e-01
+#define LN2_LO  1.90821492927058770002e-10
+
+// 2^27+1, splits a double into two halves whose products are exact
+#define SPLITTER    134217729.0
+
+// a*b = *hi + *lo exactly (Dekker), wasm has no fused multiply add to do it
+static void mulexact(double a, double b, double *hi, double *lo)
+{
+    double t=SPLITTER*a;
+    const double ahi=t-(t-a);
+    const double alo=a-ahi;
+    t=SPLITTER*b;
+    const double bhi=t-(t-b);
+    const double blo=b-bhi;
+    *hi=a*b;
+    *lo=((ahi*bhi-*hi)+ahi*blo+alo*bhi)+alo*blo;
+}
+
+// e^(hi+lo), lo carries the bits of the exponent that don't fit in hi
+static double expsplit(double hi, double lo)
+{
+    if(hi!=hi)
+    {
+        return hi;
+    }
+    if(hi>709.782712893384)
+    {
+        return __builtin_inf();
+    }
+    if(hi<-745.1332191019412)
+    {
+        return 0.0;
+    }
+
+    const int32_t k=(int32_t)_floor(hi*M_LOG2E+0.5);
+    const double r=(hi-k*LN2_HI)+(lo-k*LN2_LO);
+    double p=1.0/6227020800.0;
+    p=p*r+1.0/479001600.0;
+    p=p*r+1.0/39916800.0;
+    p=p*r+1.0/3628800.0;
+    p=p*r+1.0/362880.0;
+    p=p*r+1.0/40320.0;
+    p=p*r+1.0/5040.0;
+    p=p*r+1.0/720.0;
+    p=p*r+1.0/120.0;
+    p=p*r+1.0/24.0;
+    p=p*r+1.0/6.0;
+    p=p*r+0.5;
+    p=p*r+1.0;
+    p=p*r+1.0;
+    return scale2(p,k);
+}
+
+// e^x = 2^k * e^r with |r| <= ln(2)/2, e^r from the first 14 terms of its series (relative error < 2e-16)
+double _exp(double x)
+{
+    return expsplit(x,0.0);
+}
 
-double _pow(double a, double b) {
-    double c = 1;
-    for (int i=0; i<b; i++)
-        c *= a;
-    return c;
+// ln(x) = *hi + *lo for finite x > 0, about 2^-60 relative
+// x = m * 2^e with m in [sqrt(1/2),sqrt(2)), ln(m) = 2*atanh(s) with s=f/(2+f), f=m-1 so |s| < 0.172. f is exact and
+// s is carried in two parts, so only the series tail past 2*s rounds
+static void logsplit(double x, double *hi, double *lo)
+{
+    int32_t e=0;
+    if(x<2.2250738585072014e-308)       // subnormal, make it normal first
+    {
+        x*=18014398509481984.0;         // 2^54
+        e-=54;
+    }
+
+    DoubleBits b;
+    b.d=x;
+    e+=(int32_t)((b.u>>52) & 0x7ff)-1023;
+    b.u=(b.u & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+    double m=b.d;
+    if(m>M_SQRT2)
+    {
+        m*=0.5;
+        e++;
+    }
+
+    // 2+f = d+dlo and s*d = ph+pl exactly, the remainder f-s*(d+dlo) gives the low part of s
+    const double f=m-1.0;
+    const double d=2.0+f;
+    const double dlo=f-(d-2.0);
+    const double s=f/d;
+    double ph, pl;
+    mulexact(s,d,&ph,&pl);
+    const double slo=(((f-ph)-pl)-s*dlo)/d;
+
+    const double z=s*s;
+    double p=2.0/21.0;
+    p=p*z+2.0/19.0;
+    p=p*z+2.0/17.0;
+    p=p*z+2.0/15.0;
+    p=p*z+2.0/13.0;
+    p=p*z+2.0/11.0;
+    p=p*z+2.0/9.0;
+    p=p*z+2.0/7.0;
+    p=p*z+2.0/5.0;
+    p=p*z+2.0/3.0;
+
+    // e*LN2_HI + 2*s with its rounding error kept
+    const double ehi=e*LN2_HI;
+    const double sum=ehi+2.0*s;
+    const double part=sum-ehi;
+    *hi=sum;
+    *lo=((ehi-(sum-part))+(2.0*s-part))+(2.0*slo+s*z*p+e*LN2_LO);
+}
+
+double _log(double x)
+{
+    if(x!=x || x<0)
+    {
+        return __builtin_nan("");
+    }
+    if(x==0)
+    {
+        return -__builtin_inf();
+    }
+    if(x==__builtin_inf())
+    {
+        return x;
+    }
+
+    double hi, lo;
+    logsplit(x,&hi,&lo);
+    return hi+lo;
+}
+
+// a^b for a > 0. ln(a) and b*ln(a) are kept in two parts, a single rounding of b*ln(a) would be an absolute error of
+// up to 2^-53*|b*ln(a)| that exp turns into a relative one, hundreds of ulps for large results
+static double powpositive(double a, double b)
+{
+    if(a!=a || a==__builtin_inf())
+    {
+        return _exp(b*_log(a));
+    }
+    if(a==1.0)
+    {
+        return 1.0;
+    }
+
+    double lhi, llo;
+    logsplit(a,&lhi,&llo);
+    const double y=b*lhi;
+    if(!(y>-746.0 && y<746.0))
+    {
+        // overflows, underflows or is nan whatever the low bits, and b could be too large to split
+        return _exp(y);
+    }
+    double yhi, ylo;
+    mulexact(b,lhi,&yhi,&ylo);
+    return expsplit(yhi,ylo+b*llo);
+}
+
+// Integer exponents go through _ipow, so they stay exact for small powers, anything else is exp(b*ln(a)) to within a
+// few ulps
+double _pow(double a, double b)
+{
+    if(b==_trunc(b))
+    {
+        if(b>=-2147483647.0 && b<=2147483647.0)
+        {
+            return _ipow(a,(int32_t)b);
+        }
+        if(a<0)
+        {
+            const double r=powpositive(-a,b);
+            return (_fmod(b,2.0)!=0 ? -r : r);
+        }
+    }
+    if(a<0)
+    {
+        return __builtin_nan("");
+    }
+    if(a==0)
+    {
+        return (b>0 ? 0.0 : __builtin_inf());
+    }
+    return powpositive(a,b);
 }
 
 double _fact(double x) {
@@ -64,36 +286,89 @@ double _fact(double x) {
     return ret;
 }
 
+// pi/2 split so k*PIO2_HI is exact for |k| < 2^20
+#define PIO2_HI 1.57079632673412561417e+00
+#define PIO2_LO 6.07710050650619224932e-11
+
+// minimax polynomials for sin and cos on [-pi/4,pi/4] (coefficients from fdlibm)
+static double sin_kernel(const double x)
+{
+    const double z=x*x;
+    double p=1.58969099521155010221e-10;
+    p=p*z-2.50507602534068634195e-08;
+    p=p*z+2.75573137070700676789e-06;
+    p=p*z-1.98412698298579493134e-04;
+    p=p*z+8.33333333332248946124e-03;
+    p=p*z-1.66666666666666324348e-01;
+    return x+x*z*p;
+}
+
+static double cos_kernel(const double x)
+{
+    const double z=x*x;
+    double p=-1.13596475577881948265e-11;
+    p=p*z+2.08757232129817482790e-09;
+    p=p*z-2.75573143513906633035e-07;
+    p=p*z+2.48015872894767294178e-05;
+    p=p*z-1.38888888888741095749e-03;
+    p=p*z+4.16666666666666019037e-02;
+    return 1.0-0.5*z+z*z*p;
+}
+
+// Reduces x to r in [-pi/4,pi/4] and returns the quadrant, x = quadrant*pi/2 + r
+// Accurate up to |x| ~ 1e6, larger angles are first reduced with _fmod and lose precision
+static int32_t reduce_quadrant(double x, double *r)
+{
+    if(!(_dabs(x)<1.0e6))
+    {
+        x=_fmod(x,2.0*M_PI);
+    }
+    const int32_t k=(int32_t)_floor(x*M_2_PI+0.5);
+    *r=(x-k*PIO2_HI)-k*PIO2_LO;
+    return k & 3;
+}
+
 double _sin(double x) {
     #ifdef USE_BUILTIN_SIN
         return __builtin_sin(x);
     #else
-    double y = x;
-    double s = -1;
-    for (int i=3; i<=100; i+=2) {
-        y+=s*(_pow(x,i)/_fact(i));
-        s *= -1;
-    }  
-    return y;
+    if(x-x!=0)      // nan or infinity
+    {
+        return __builtin_nan("");
+    }
+    double r;
+    switch(reduce_quadrant(x,&r))
+    {
+    default:
+    case 0: return sin_kernel(r);
+    case 1: return cos_kernel(r);
+    case 2: return -sin_kernel(r);
+    case 3: return -cos_kernel(r);
+    }
     #endif
 }
 double _cos(double x) {
     #ifdef USE_BUILTIN_COS
         return __builtin_cos(x);
     #else
-    double y = 1;
-    double s = -1;
-    for (int i=2; i<=100; i+=2) {
-        y+=s*(_pow(x,i)/_fact(i));
-        s *= -1;
-    }  
-    return y;
+    if(x-x!=0)
+    {
+        return __builtin_nan("");
+    }
+    double r;
+    switch(reduce_quadrant(x,&r))
+    {
+    default:
+    case 0: return cos_kernel(r);
+    case 1: return -sin_kernel(r);
+    case 2: return -cos_kernel(r);
+    case 3: return sin_kernel(r);
+    }
     #endif
 }
 double _tan(double x) {
      return (_sin(x)/_cos(x));
 }
-/* end QAD sin / cos */
 
 double deg2rad(const double deg)
 {
@@ -21,6 +21,9 @@ extern "C" {
 #endif
 
 double _pow(double a, double b);
+double _ipow(double x, int32_t n);
+double _exp(double x);
+double _log(double x);
 double _fact(double x);
 double _sin(double x);
 double _cos(double x);
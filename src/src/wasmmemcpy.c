@@ -1,13 +1,129 @@
 #include "wasmmemcpy.h"
 
+// Built with BULK_MEMORY=1 the compiler has memory.copy / memory.fill, so the builtins below become a single instruction
+// Otherwise copies and fills go a word at a time when both pointers share the same alignment
+
+// word access that's allowed to alias whatever type the memory really holds
+typedef uint32_t __attribute__((__may_alias__)) memword_t;
+
+#define WORD_SIZE sizeof(memword_t)
+#define WORD_MASK (WORD_SIZE-1)
+
+static void copy_forward(uint8_t *d, const uint8_t *s, size_t n)
+{
+	if((((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK)==0)
+	{
+		for(; n>0 && ((uintptr_t)d & WORD_MASK)!=0; n--)
+		{
+			*d++=*s++;
+		}
+		memword_t *wd=(memword_t *)d;
+		const memword_t *ws=(const memword_t *)s;
+		for(; n>=WORD_SIZE*4; n-=WORD_SIZE*4)
+		{
+			wd[0]=ws[0];
+			wd[1]=ws[1];
+			wd[2]=ws[2];
+			wd[3]=ws[3];
+			wd+=4;
+			ws+=4;
+		}
+		for(; n>=WORD_SIZE; n-=WORD_SIZE)
+		{
+			*wd++=*ws++;
+		}
+		d=(uint8_t *)wd;
+		s=(const uint8_t *)ws;
+	}
+	for(; n>0; n--)
+	{
+		*d++=*s++;
+	}
+}
+
+static void copy_backward(uint8_t *d, const uint8_t *s, size_t n)
+{
+	d+=n;
+	s+=n;
+	if((((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK)==0)
+	{
+		for(; n>0 && ((uintptr_t)d & WORD_MASK)!=0; n--)
+		{
+			*--d=*--s;
+		}
+		memword_t *wd=(memword_t *)d;
+		const memword_t *ws=(const memword_t *)s;
+		for(; n>=WORD_SIZE; n-=WORD_SIZE)
+		{
+			*--wd=*--ws;
+		}
+		d=(uint8_t *)wd;
+		s=(const uint8_t *)ws;
+	}
+	for(; n>0; n--)
+	{
+		*--d=*--s;
+	}
+}
+
 void *memcpy(void *dest, const void *src, size_t n)
 {
-	char *csrc=(char *)src;
-	char *cdest=(char *)dest;
+#if defined(__wasm_bulk_memory__)
+	return __builtin_memcpy(dest,src,n);
+#else
+	copy_forward((uint8_t *)dest,(const uint8_t *)src,n);
+	return dest;
+#endif
+}
 	
-	for(size_t i=0; i<n; i++)
+void *memmove(void *dest, const void *src, size_t n)
+{
+#if defined(__wasm_bulk_memory__)
+	return __builtin_memmove(dest,src,n);
+#else
+	// a forward copy is safe whenever dest is below src, even if they overlap
+	if((uintptr_t)dest<=(uintptr_t)src || (uintptr_t)dest>=(uintptr_t)src+n)
+	{
+		copy_forward((uint8_t *)dest,(const uint8_t *)src,n);
+	}
+	else
+	{
+		copy_backward((uint8_t *)dest,(const uint8_t *)src,n);
+	}
+	return dest;
+#endif
+}
+
+void *memset(void *dest, int c, size_t n)
+{
+#if defined(__wasm_bulk_memory__)
+	return __builtin_memset(dest,c,n);
+#else
+	uint8_t *d=(uint8_t *)dest;
+	const uint8_t val=(uint8_t)c;
+	for(; n>0 && ((uintptr_t)d & WORD_MASK)!=0; n--)
+	{
+		*d++=val;
+	}
+	const memword_t wval=val*0x01010101u;
+	memword_t *wd=(memword_t *)d;
+	for(; n>=WORD_SIZE*4; n-=WORD_SIZE*4)
+	{
+		wd[0]=wval;
+		wd[1]=wval;
+		wd[2]=wval;
+		wd[3]=wval;
+		wd+=4;
+	}
+	for(; n>=WORD_SIZE; n-=WORD_SIZE)
+	{
+		*wd++=wval;
+	}
+	d=(uint8_t *)wd;
+	for(; n>0; n--)
 	{
-		cdest[i]=csrc[i];
+		*d++=val;
 	}
 	return dest;
+#endif
 }
\ No newline at end of file
@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 void *memcpy(void *dest, const void *src, size_t n);
+void *memmove(void *dest, const void *src, size_t n);
+void *memset(void *dest, int c, size_t n);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+Linear memory budget for the cart
+
+WASM-4 gives the cart a single 64KB memory, so static data, the stack and the heap all compete for it.
+This reads the linked cart.wasm (and the wasm-ld map file, if there is one) and prints where the memory
+goes, then fails if less than --min-heap bytes are left for the heap.
+
+usage: membudget.py build/cart.wasm [--map build/cart.map] [--min-heap BYTES] [--stack-size BYTES] [--top N]
+
+Layout, as linked by the Makefile (--global-base=6560 -zstack-size=3072, stack placed after the data):
+  0 .. global base            reserved by the WASM-4 runtime (registers, palette, framebuffer)
+  global base .. data end     static data, initialized then zero filled
+  data end .. stack pointer   stack (grows down from the initial stack pointer)
+  stack pointer .. 65536      heap (tinyalloc, see wasmmalloc.c)
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MEMORY_SIZE = 65536
+RUNTIME_RESERVED = 6560
+
+
+def read_uleb(data, pos):
+	result = 0
+	shift = 0
+	while True:
+		byte = data[pos]
+		pos += 1
+		result |= (byte & 0x7f) << shift
+		shift += 7
+		if byte & 0x80 == 0:
+			return result, pos
+
+
+def read_sleb(data, pos):
+	result = 0
+	shift = 0
+	while True:
+		byte = data[pos]
+		pos += 1
+		result |= (byte & 0x7f) << shift
+		shift += 7
+		if byte & 0x80 == 0:
+			if byte & 0x40:
+				result -= 1 << shift
+			return result, pos
+
+
+def read_const_expr(data, pos):
+	"""Returns the value of an i32.const init expression (None for anything else) and the position after it"""
+	value = None
+	opcode = data[pos]
+	pos += 1
+	if opcode == 0x41:  # i32.const
+		value, pos = read_sleb(data, pos)
+	elif opcode == 0x23:  # global.get
+		_, pos = read_uleb(data, pos)
+	else:
+		raise ValueError("unsupported init expression opcode 0x%02x" % opcode)
+	if data[pos] != 0x0b:
+		raise ValueError("init expression is not terminated")
+	return value, pos + 1
+
+
+def parse_wasm(path):
+	"""Returns (data segments as [(address, size)], initial stack pointer or None, imported global count)"""
+	with open(path, "rb") as f:
+		data = f.read()
+	if data[:4] != b"\0asm":
+		raise ValueError("%s is not a wasm module" % path)
+
+	segments = []
+	stack_pointer = None
+	imported_globals = 0
+	pos = 8
+	while pos < len(data):
+		section_id = data[pos]
+		size, pos = read_uleb(data, pos + 1)
+		end = pos + size
+
+		if section_id == 2:  # imports
+			count, p = read_uleb(data, pos)
+			for _ in range(count):
+				for _ in range(2):  # module and field names
+					length, p = read_uleb(data, p)
+					p += length
+				kind = data[p]
+				p += 1
+				if kind == 0:  # function
+					_, p = read_uleb(data, p)
+				elif kind == 1:  # table
+					p += 1
+					flags, p = read_uleb(data, p)
+					_, p = read_uleb(data, p)
+					if flags & 1:
+						_, p = read_uleb(data, p)
+				elif kind == 2:  # memory
+					flags, p = read_uleb(data, p)
+					_, p = read_uleb(data, p)
+					if flags & 1:
+						_, p = read_uleb(data, p)
+				elif kind == 3:  # global
+					p += 2
+					imported_globals += 1
+
+		elif section_id == 6:  # globals - the first mutable i32 is the stack pointer
+			count, p = read_uleb(data, pos)
+			for _ in range(count):
+				valtype = data[p]
+				mutable = data[p + 1]
+				value, p = read_const_expr(data, p + 2)
+				if stack_pointer is None and valtype == 0x7f and mutable:
+					stack_pointer = value
+
+		elif section_id == 11:  # data
+			count, p = read_uleb(data, pos)
+			for _ in range(count):
+				flags, p = read_uleb(data, p)
+				address = None
+				if flags == 2:
+					_, p = read_uleb(data, p)
+				if flags in (0, 2):
+					address, p = read_const_expr(data, p)
+				length, p = read_uleb(data, p)
+				p += length
+				if address is not None:
+					segments.append((address, length))
+
+		pos = end
+
+	return segments, stack_pointer, imported_globals
+
+
+# e.g. "    1a40     3e2      900         build/Draw.o:(.rodata.TileImageData)"
+MAP_INPUT_RE = re.compile(r"^\s*[0-9a-fA-F-]+\s+[0-9a-fA-F-]+\s+([0-9a-fA-F]+)\s+(\S+?\.o):\((\.(?:rodata|data|bss)[^)]*)\)")
+
+
+def parse_map(path):
+	"""Returns {module: {"rodata": n, "data": n, "bss": n}} and [(size, module, symbol)] from a wasm-ld map file"""
+	modules = {}
+	symbols = []
+	with open(path, "r") as f:
+		for line in f:
+			match = MAP_INPUT_RE.match(line)
+			if not match:
+				continue
+			size = int(match.group(1), 16)
+			module = os.path.splitext(os.path.basename(match.group(2)))[0]
+			section = match.group(3)
+			kind = section[1:].split(".")[0]
+			name = section[len(kind) + 2:] or section
+
+			totals = modules.setdefault(module, {"rodata": 0, "data": 0, "bss": 0})
+			totals[kind] += size
+			symbols.append((size, module, name))
+	return modules, symbols
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Linear memory budget for the cart")
+	parser.add_argument("wasm")
+	parser.add_argument("--map", help="wasm-ld map file (-Map=...) for the per module table")
+	parser.add_argument("--min-heap", type=int, default=0, help="fail if fewer bytes than this are left for the heap")
+	parser.add_argument("--stack-size", type=int, default=3072, help="-zstack-size passed to wasm-ld")
+	parser.add_argument("--top", type=int, default=10, help="number of largest symbols to list")
+	args = parser.parse_args()
+
+	segments, stack_pointer, _ = parse_wasm(args.wasm)
+
+	global_base = min([address for address, _ in segments] + [RUNTIME_RESERVED])
+	initialized_end = max([address + size for address, size in segments] + [global_base])
+	initialized = sum(size for _, size in segments)
+	if stack_pointer is None:
+		print("warning: no stack pointer global found, assuming the stack ends at the initialized data", file=sys.stderr)
+		stack_pointer = initialized_end + args.stack_size
+	data_end = stack_pointer - args.stack_size
+	heap = MEMORY_SIZE - stack_pointer
+
+	rows = [
+		("runtime reserved", 0, global_base),
+		("static data (initialized)", global_base, initialized_end),
+		("static data (zero filled)", initialized_end, data_end),
+		("stack", data_end, stack_pointer),
+		("heap", stack_pointer, MEMORY_SIZE),
+	]
+
+	print("Linear memory budget for %s" % args.wasm)
+	print()
+	print("%-28s %7s %7s %7s %6s" % ("region", "start", "end", "size", "%"))
+	for name, start, end in rows:
+		print("%-28s %7d %7d %7d %5.1f%%" % (name, start, end, end - start, 100.0 * (end - start) / MEMORY_SIZE))
+	print("%-28s %7s %7s %7d" % ("data segments", "", "", initialized))
+
+	if args.map:
+		if os.path.exists(args.map):
+			modules, symbols = parse_map(args.map)
+			print()
+			print("%-20s %7s %7s %7s %7s" % ("module", "rodata", "data", "bss", "total"))
+			for module, totals in sorted(modules.items(), key=lambda item: -sum(item[1].values())):
+				print("%-20s %7d %7d %7d %7d" % (module, totals["rodata"], totals["data"], totals["bss"], sum(totals.values())))
+			if args.top > 0:
+				print()
+				print("largest symbols")
+				for size, module, name in sorted(symbols, reverse=True)[:args.top]:
+					print("%7d  %s (%s)" % (size, name, module))
+		else:
+			print()
+			print("no map file at %s, per module sizes not available" % args.map)
+
+	print()
+	if heap < args.min_heap:
+		print("FAIL: %d bytes left for the heap, at least %d are needed" % (heap, args.min_heap))
+		return 1
+	print("OK: %d bytes left for the heap (minimum %d)" % (heap, args.min_heap))
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+Packs the static assets in assets/ with PackBits and writes them as a C array the cart can include
+
+The terrain maps, logo and scenario saves are only needed now and then (map selection, start screen, loading a
+scenario), so the cart keeps them packed and Assets.cpp expands one into the scratch arena when it's asked for.
+
+TileData.h stays raw. Tiles are drawn every frame so an unpacked copy would have to stay in memory all the time, and
+the cart's data lives in the same 64KB as everything else - 2048 bytes packs to 1610, plus the 2048 byte copy.
+
+usage: packassets.py OUTPUT
+
+PackBits: a header byte n followed by
+  n = 0..127      n+1 literal bytes
+  n = 129..255    one byte, repeated 257-n times
+  n = 128         no-op (never written)
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+# (Asset id in Assets.h, source file, array name or None when the file is just the array contents)
+# Keep in the same order as the AssetId enum
+ASSETS = [
+	("Asset_Terrain1", "assets/Terrain1.inc.h", None),
+	("Asset_Terrain2", "assets/Terrain2.inc.h", None),
+	("Asset_Terrain3", "assets/Terrain3.inc.h", None),
+	("Asset_Terrain4", "assets/Terrain4.inc.h", None),
+	("Asset_Terrain5", "assets/Terrain5.inc.h", None),
+	("Asset_Logo", "assets/LogoBitmap.h", "LogoBitmap"),
+	("Asset_DemoCity", "assets/democity.cpp", "democity"),
+	("Asset_CoastalScenario", "assets/democity.cpp", "coastalscenario"),
+	("Asset_RuralScenario", "assets/democity.cpp", "ruralscenario"),
+	("Asset_RevitalizeScenario", "assets/democity.cpp", "revitalizescenario"),
+	("Asset_IslandScenario", "assets/democity.cpp", "islandscenario"),
+]
+
+COMMENT_RE = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+NUMBER_RE = re.compile(r"0[xX][0-9a-fA-F]+|\d+")
+
+
+def read_array(path, name):
+	with open(os.path.join(ROOT, path), "r") as f:
+		text = COMMENT_RE.sub("", f.read())
+	if name is not None:
+		match = re.search(r"\b" + name + r"\s*\[\s*\]\s*=\s*\{(.*?)\}", text, re.S)
+		if not match:
+			raise ValueError("%s not found in %s" % (name, path))
+		text = match.group(1)
+	return bytes(int(value, 0) for value in NUMBER_RE.findall(text))
+
+
+def pack(data):
+	out = bytearray()
+	i = 0
+	while i < len(data):
+		# length of the run starting here
+		run = 1
+		while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+			run += 1
+		if run >= 2:
+			out.append(257 - run)
+			out.append(data[i])
+			i += run
+			continue
+
+		# literals up to the next run of 3 or more (a run of 2 costs the same as 2 literals)
+		start = i
+		while i < len(data) and i - start < 128:
+			if i + 2 < len(data) and data[i] == data[i + 1] == data[i + 2]:
+				break
+			i += 1
+		out.append(i - start - 1)
+		out += data[start:i]
+	return bytes(out)
+
+
+def unpack(data):
+	out = bytearray()
+	i = 0
+	while i < len(data):
+		n = data[i]
+		i += 1
+		if n < 128:
+			out += data[i:i + n + 1]
+			i += n + 1
+		elif n > 128:
+			out += bytes([data[i]]) * (257 - n)
+			i += 1
+	return bytes(out)
+
+
+def main():
+	if len(sys.argv) != 2:
+		print(__doc__.strip())
+		return 1
+
+	lines = []
+	table = []
+	offset = 0
+	total_unpacked = 0
+	for asset, path, name in ASSETS:
+		data = read_array(path, name)
+		packed = pack(data)
+		if unpack(packed) != data:
+			raise ValueError("%s does not round trip" % asset)
+		if len(data) > 0xffff:
+			raise ValueError("%s is too large" % asset)
+
+		lines.append("\t// %s - %s, %d bytes packed to %d" % (asset, name or os.path.basename(path), len(data), len(packed)))
+		for i in range(0, len(packed), 16):
+			lines.append("\t" + ",".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+		table.append("\t{ %d, %d },\t\t// %s" % (offset, len(data), asset))
+		offset += len(packed)
+		total_unpacked += len(data)
+
+	with open(sys.argv[1], "w", newline="\n") as f:
+		f.write("// Generated by tools/packassets.py from the files in assets/ - do not edit\n")
+		f.write("// %d bytes of assets packed to %d\n\n" % (total_unpacked, offset))
+		f.write("static const uint8_t PackedAssetData[] =\n{\n")
+		f.write("\n".join(lines))
+		f.write("\n};\n\n")
+		f.write("static const PackedAsset PackedAssets[] =\n{\n")
+		f.write("\n".join(table))
+		f.write("\n};\n")
+
+	print("packed %d bytes of assets to %d" % (total_unpacked, offset))
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())